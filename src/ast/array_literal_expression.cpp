@@ -0,0 +1,29 @@
+module;
+
+#include <memory>
+#include <vector>
+
+export module scc.ast:ast_array_literal_expression;
+import :ast_expression;
+import :ast_visitor;
+import :source_range;
+
+namespace scc::ast {
+
+// `[a, b, c]`, initializes arrays and vectors.
+export struct ArrayLiteralExpression final : Expression {
+    std::vector<std::unique_ptr<Expression>> elementsExpression;
+
+    ArrayLiteralExpression(SourceRange sourceRange, std::vector<std::unique_ptr<Expression>> elementsExpression)
+        : Expression { std::move(sourceRange) }
+        , elementsExpression { std::move(elementsExpression) }
+    {
+    }
+
+    void Visit(Visitor& visitor) override
+    {
+        visitor.VisitAstArrayLiteralExpression(*this);
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+module;
+
+#include <cassert>
+#include <memory>
+
+export module scc.ast:ast_await_expression;
+import :ast_expression;
+import :ast_visitor;
+import :source_range;
+
+namespace scc::ast {
+
+// `await t`, which waits for the task `t` and evaluates to its result.
+export struct AwaitExpression final : Expression {
+    std::unique_ptr<Expression> oprand {};
+
+    AwaitExpression(SourceRange sourceRange, std::unique_ptr<Expression> oprand)
+        : Expression { std::move(sourceRange) }
+        , oprand { std::move(oprand) }
+    {
+        assert(this->oprand);
+    }
+
+    void Visit(Visitor& visitor) override
+    {
+        visitor.VisitAstAwaitExpression(*this);
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+module;
+
+#include <utility>
+
+export module scc.ast:ast_continue_statement;
+import :ast_statement;
+import :ast_visitor;
+import :source_range;
+
+namespace scc::ast {
+
+export struct ContinueStatement : Statement {
+    ContinueStatement(SourceRange sourceRange)
+        : Statement { std::move(sourceRange) }
+    {
+    }
+
+    void Visit(Visitor& visitor) override
+    {
+        visitor.VisitAstContinueStatement(*this);
+    }
+};
+
+}
\ No newline at end of file
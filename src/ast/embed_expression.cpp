@@ -0,0 +1,46 @@
+module;
+
+#include <cstdint>
+#include <string>
+
+export module scc.ast:ast_embed_expression;
+import :ast_expression;
+import :ast_visitor;
+import :source_range;
+
+namespace scc::ast {
+
+// `embed("file")` and the byte string `x"0a 0b 0c"`, a `u8[N]` array stored as one blob of
+// read-only data instead of an element expression per byte. The compiler only reads the size of an
+// embedded file, the assembler copies its contents into the program.
+export struct EmbedExpression final : Expression {
+    std::string file {};
+    std::string bytes {};
+    uint64_t size {};
+
+    EmbedExpression(SourceRange sourceRange, std::string file, uint64_t size)
+        : Expression { std::move(sourceRange) }
+        , file { std::move(file) }
+        , size { size }
+    {
+    }
+
+    EmbedExpression(SourceRange sourceRange, std::string bytes)
+        : Expression { std::move(sourceRange) }
+        , bytes { std::move(bytes) }
+        , size { this->bytes.size() }
+    {
+    }
+
+    bool IsFile() const
+    {
+        return !file.empty();
+    }
+
+    void Visit(Visitor& visitor) override
+    {
+        visitor.VisitAstEmbedExpression(*this);
+    }
+};
+
+}
\ No newline at end of file
@@ -4,11 +4,15 @@ module;
 
 export module scc.ast:ast_expression;
 import :ast_node;
+import :ast_type_info;
 import :source_range;
 
 namespace scc::ast {
 
 export struct Expression : Node {
+    // Type of the value, annotated by the `TypeChecker`.
+    TypeInfo* typeInfo {};
+
     Expression(SourceRange sourceRange)
         : Node { std::move(sourceRange) }
     {
@@ -0,0 +1,31 @@
+module;
+
+#include <utility>
+
+export module scc.ast:ast_float_literal_expression;
+import :ast_expression;
+import :ast_visitor;
+import :source_range;
+
+namespace scc::ast {
+
+export struct FloatLiteralExpression final : Expression {
+    double value {};
+
+    // Written with the 'f' suffix, e.g. `1.5f`.
+    bool isSinglePrecision {};
+
+    FloatLiteralExpression(SourceRange sourceRange, double value, bool isSinglePrecision)
+        : Expression { std::move(sourceRange) }
+        , value { value }
+        , isSinglePrecision { isSinglePrecision }
+    {
+    }
+
+    void Visit(Visitor& visitor) override
+    {
+        visitor.VisitAstFloatLiteralExpression(*this);
+    }
+};
+
+}
\ No newline at end of file
@@ -1,22 +1,45 @@
 module;
 
 #include <memory>
+#include <string>
+#include <vector>
 
 export module scc.ast:ast_for_loop_statement;
 import :ast_expression;
 import :ast_scope;
 import :ast_statement;
+import :ast_variable_declaration;
 import :ast_visitor;
 import :source_range;
 
 namespace scc::ast {
 
+export enum class ReductionOp {
+    Sum,
+    Min,
+    Max,
+};
+
+// A `sum(x)`, `min(x)` or `max(x)` clause of a parallel for loop. Every chunk of the loop reduces
+// into a copy of `x` of its own, which starts at the identity of the operation, and the copies are
+// combined into `x` once the loop is done.
+export struct Reduction final {
+    SourceRange sourceRange {};
+    ReductionOp op {};
+    std::string variableName {};
+    const VariableDeclaration* variableDeclaration {};
+};
+
 export struct ForLoopStatement final : Statement {
     Scope initScope {};
     std::unique_ptr<Expression> conditionalExpression {};
     std::unique_ptr<Expression> iterationExpression {};
     Scope bodyScope {};
 
+    // The iterations of a `parallel for` loop run in chunks on the worker threads.
+    bool isParallel {};
+    std::vector<Reduction> reductions {};
+
     ForLoopStatement(SourceRange sourceRange, Scope initScope, std::unique_ptr<Expression> conditionalExpression, std::unique_ptr<Expression> iterationExpression, Scope bodyScope)
         : Statement { std::move(sourceRange) }
         , initScope { std::move(initScope) }
@@ -14,6 +14,9 @@ export struct FunctionCallExpression final : Expression {
     std::unique_ptr<Expression> funcExpression;
     std::vector<std::unique_ptr<Expression>> argsExpression;
 
+    // The called function, set by the `TypeChecker`. Functions of `scc.std` have no definition.
+    const FunctionDefinitionStatement* function {};
+
     FunctionCallExpression(SourceRange sourceRange, std::unique_ptr<Expression> funcExpression, std::vector<std::unique_ptr<Expression>> argsExpression)
         : Expression { std::move(sourceRange) }
         , funcExpression { std::move(funcExpression) }
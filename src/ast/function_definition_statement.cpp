@@ -1,11 +1,15 @@
 module;
 
+#include <algorithm>
 #include <string>
+#include <string_view>
+#include <vector>
 
 export module scc.ast:function_definition_statement;
 import :ast_statement;
 import :ast_scope;
 import :ast_type_info;
+import :ast_variable_declaration;
 import :ast_visitor;
 import :source_range;
 
@@ -17,6 +21,12 @@ export struct FunctionDefinitionStatement final : Statement {
     Scope headerScope {};
     Scope bodyScope {};
 
+    // Names of the attributes written before the definition, e.g. 'memo' for `@memo`.
+    std::vector<std::string> attributes {};
+
+    // `constexpr` or `consteval`.
+    Constness constness {};
+
     FunctionDefinitionStatement(SourceRange sourceRange, TypeInfo& typeInfo, std::string name, Scope headerScope, Scope bodyScope)
         : Statement { std::move(sourceRange) }
         , typeInfo { typeInfo }
@@ -26,6 +36,11 @@ export struct FunctionDefinitionStatement final : Statement {
     {
     }
 
+    bool HasAttribute(std::string_view attribute) const
+    {
+        return std::ranges::find(attributes, attribute) != attributes.end();
+    }
+
     void Visit(Visitor& visitor) override {
         visitor.VisitFunctionDefinitionStatement(*this);
     }
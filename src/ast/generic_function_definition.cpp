@@ -0,0 +1,26 @@
+module;
+
+#include <string>
+#include <vector>
+
+export module scc.ast:ast_generic_function_definition;
+
+namespace scc::ast {
+
+// A function with type parameters, e.g. `<T> T max(T a, T b) { ... }`. The definition is kept as
+// source text, since it can only be parsed once the type parameters name types. Each instance is
+// an ordinary function named with its type arguments, e.g. `max<f64>`.
+export struct GenericFunctionDefinition final {
+    std::string name {};
+    std::vector<std::string> typeParameters {};
+
+    // Type names of the parameters, which may refer to the type parameters, e.g. `T[:]`.
+    std::vector<std::string> parameterTypes {};
+
+    // The definition after the type parameter list, which starts at `sourceLine` and `sourceColumn`.
+    std::string source {};
+    int sourceLine {};
+    int sourceColumn {};
+};
+
+}
\ No newline at end of file
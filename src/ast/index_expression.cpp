@@ -0,0 +1,34 @@
+module;
+
+#include <memory>
+
+export module scc.ast:ast_index_expression;
+import :ast_expression;
+import :ast_visitor;
+import :source_range;
+
+namespace scc::ast {
+
+// `array[index]`, element access of arrays, vectors and slices.
+export struct IndexExpression final : Expression {
+    std::unique_ptr<Expression> arrayExpression;
+    std::unique_ptr<Expression> indexExpression;
+
+    // The index is checked against the length at run time, unless the `BoundsCheckEliminator`
+    // proves it is in bounds.
+    bool checked { true };
+
+    IndexExpression(SourceRange sourceRange, std::unique_ptr<Expression> arrayExpression, std::unique_ptr<Expression> indexExpression)
+        : Expression { std::move(sourceRange) }
+        , arrayExpression { std::move(arrayExpression) }
+        , indexExpression { std::move(indexExpression) }
+    {
+    }
+
+    void Visit(Visitor& visitor) override
+    {
+        visitor.VisitAstIndexExpression(*this);
+    }
+};
+
+}
\ No newline at end of file
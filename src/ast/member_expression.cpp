@@ -0,0 +1,31 @@
+module;
+
+#include <memory>
+#include <string>
+
+export module scc.ast:ast_member_expression;
+import :ast_expression;
+import :ast_visitor;
+import :source_range;
+
+namespace scc::ast {
+
+// `object.member`, field access of structs.
+export struct MemberExpression final : Expression {
+    std::unique_ptr<Expression> objectExpression;
+    std::string memberName {};
+
+    MemberExpression(SourceRange sourceRange, std::unique_ptr<Expression> objectExpression, std::string memberName)
+        : Expression { std::move(sourceRange) }
+        , objectExpression { std::move(objectExpression) }
+        , memberName { std::move(memberName) }
+    {
+    }
+
+    void Visit(Visitor& visitor) override
+    {
+        visitor.VisitAstMemberExpression(*this);
+    }
+};
+
+}
\ No newline at end of file
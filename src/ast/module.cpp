@@ -1,19 +1,31 @@
 module;
 
 export module scc.ast;
+export import :ast_array_literal_expression;
+export import :ast_await_expression;
 export import :ast_binary_expression;
 export import :ast_break_statement;
 export import :ast_conditional_statement;
+export import :ast_continue_statement;
+export import :ast_embed_expression;
 export import :ast_expression_statement;
 export import :ast_expression;
+export import :ast_float_literal_expression;
 export import :ast_for_loop_statement;
 export import :ast_function_call_expression;
 export import :function_definition_statement;
+export import :ast_generic_function_definition;
 export import :ast_identifier_expression;
+export import :ast_index_expression;
 export import :ast_integer_literal_expression;
+export import :ast_member_expression;
 export import :return_statement;
+export import :ast_recursive_visitor;
 export import :ast_scope;
+export import :ast_slice_expression;
+export import :ast_spawn_expression;
 export import :ast_string_literal_expression;
+export import :ast_switch_statement;
 export import :ast_unary_expression;
 export import :ast_variable_declaration;
 export import :ast_variable_definition_statement;
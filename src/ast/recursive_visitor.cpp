@@ -0,0 +1,193 @@
+module;
+
+#include <cassert>
+
+export module scc.ast:ast_recursive_visitor;
+import :ast_array_literal_expression;
+import :ast_await_expression;
+import :ast_binary_expression;
+import :ast_break_statement;
+import :ast_conditional_statement;
+import :ast_continue_statement;
+import :ast_embed_expression;
+import :ast_expression_statement;
+import :ast_float_literal_expression;
+import :ast_for_loop_statement;
+import :ast_function_call_expression;
+import :function_definition_statement;
+import :ast_identifier_expression;
+import :ast_index_expression;
+import :ast_integer_literal_expression;
+import :ast_member_expression;
+import :return_statement;
+import :ast_scope;
+import :ast_slice_expression;
+import :ast_spawn_expression;
+import :ast_string_literal_expression;
+import :ast_switch_statement;
+import :ast_unary_expression;
+import :ast_variable_declaration;
+import :ast_variable_definition_statement;
+import :ast_visitor;
+
+namespace scc::ast {
+
+// Visitor which visits all children of a node by default. Analyses derive from it and override
+// only the nodes they are interested in, calling the base implementation to keep walking.
+//
+// Note that visiting a scope only visits its statements, functions defined in the scope are not
+// visited.
+export struct RecursiveVisitor : Visitor {
+    void VisitAstArrayLiteralExpression(const ArrayLiteralExpression& arrayLiteralExpression) override
+    {
+        for (const auto& elementExpression : arrayLiteralExpression.elementsExpression) {
+            elementExpression->Visit(*this);
+        }
+    }
+
+    void VisitAstAwaitExpression(const AwaitExpression& awaitExpression) override
+    {
+        awaitExpression.oprand->Visit(*this);
+    }
+
+    void VisitAstBinaryExpression(const BinaryExpression& binaryExpression) override
+    {
+        binaryExpression.leftOprand->Visit(*this);
+        binaryExpression.rightOprand->Visit(*this);
+    }
+
+    void VisitAstBreakStatement(const BreakStatement& breakStatement) override
+    {
+    }
+
+    void VisitAstConditionalStatement(const ConditionalStatement& conditionalStatement) override
+    {
+        conditionalStatement.conditionalExpression->Visit(*this);
+        VisitAstScope(conditionalStatement.trueScope);
+        VisitAstScope(conditionalStatement.falseScope);
+    }
+
+    void VisitAstContinueStatement(const ContinueStatement& continueStatement) override
+    {
+    }
+
+    void VisitAstEmbedExpression(const EmbedExpression& embedExpression) override
+    {
+    }
+
+    void VisitAstExpressionStatement(const ExpressionStatement& expressionStatement) override
+    {
+        assert(expressionStatement.expression);
+        expressionStatement.expression->Visit(*this);
+    }
+
+    void VisitAstFloatLiteralExpression(const FloatLiteralExpression& floatLiteralExpression) override
+    {
+    }
+
+    void VisitAstForLoopStatement(const ForLoopStatement& forLoopStatement) override
+    {
+        VisitAstScope(forLoopStatement.initScope);
+        if (forLoopStatement.conditionalExpression) {
+            forLoopStatement.conditionalExpression->Visit(*this);
+        }
+        if (forLoopStatement.iterationExpression) {
+            forLoopStatement.iterationExpression->Visit(*this);
+        }
+        VisitAstScope(forLoopStatement.bodyScope);
+    }
+
+    void VisitAstFunctionCallExpression(const FunctionCallExpression& functionCallExpression) override
+    {
+        functionCallExpression.funcExpression->Visit(*this);
+        for (const auto& argExpression : functionCallExpression.argsExpression) {
+            argExpression->Visit(*this);
+        }
+    }
+
+    void VisitFunctionDefinitionStatement(const FunctionDefinitionStatement& functionDefinitionStatement) override
+    {
+        VisitAstScope(functionDefinitionStatement.headerScope);
+        VisitAstScope(functionDefinitionStatement.bodyScope);
+    }
+
+    void VisitAstIdentifierExpression(const IdentifierExpression& identifierExpression) override
+    {
+    }
+
+    void VisitAstIndexExpression(const IndexExpression& indexExpression) override
+    {
+        indexExpression.arrayExpression->Visit(*this);
+        indexExpression.indexExpression->Visit(*this);
+    }
+
+    void VisitAstIntegerLiteralExpression(const IntegerLiteralExpression& integerLiteralExpression) override
+    {
+    }
+
+    void VisitAstMemberExpression(const MemberExpression& memberExpression) override
+    {
+        memberExpression.objectExpression->Visit(*this);
+    }
+
+    void VisitReturnStatement(const ReturnStatement& returnStatement) override
+    {
+        if (returnStatement.expression) {
+            returnStatement.expression->Visit(*this);
+        }
+    }
+
+    void VisitAstScope(const Scope& scope) override
+    {
+        for (const auto& statement : scope.statements) {
+            statement->Visit(*this);
+        }
+    }
+
+    void VisitAstSliceExpression(const SliceExpression& sliceExpression) override
+    {
+        sliceExpression.arrayExpression->Visit(*this);
+        if (sliceExpression.beginExpression) {
+            sliceExpression.beginExpression->Visit(*this);
+        }
+        if (sliceExpression.endExpression) {
+            sliceExpression.endExpression->Visit(*this);
+        }
+    }
+
+    void VisitAstSpawnExpression(const SpawnExpression& spawnExpression) override
+    {
+        spawnExpression.callExpression->Visit(*this);
+    }
+
+    void VisitAstStringLiteralExpression(const StringLiteralExpression& stringLiteralExpression) override
+    {
+    }
+
+    void VisitAstSwitchStatement(const SwitchStatement& switchStatement) override
+    {
+        switchStatement.conditionalExpression->Visit(*this);
+        for (const auto& switchCase : switchStatement.cases) {
+            VisitAstScope(switchCase.scope);
+        }
+    }
+
+    void VisitAstUnaryExpression(const UnaryExpression& unaryExpression) override
+    {
+        unaryExpression.oprand->Visit(*this);
+    }
+
+    void VisitAstVariableDeclaration(const VariableDeclaration& variableDeclaration) override
+    {
+        if (variableDeclaration.initExpression) {
+            variableDeclaration.initExpression->Visit(*this);
+        }
+    }
+
+    void VisitAstVariableDefinitionStatement(const VariableDefinitionStatement& variableDefinitionStatemet) override
+    {
+        VisitAstVariableDeclaration(variableDefinitionStatemet.variableDeclaration);
+    }
+};
+
+}
@@ -13,6 +13,9 @@ namespace scc::ast {
 export struct ReturnStatement final : Statement {
     std::unique_ptr<Expression> expression {};
 
+    // The returned call must be compiled as a jump, see `TailCallEliminator`.
+    bool mustTail {};
+
     ReturnStatement(SourceRange sourceRange, std::unique_ptr<Expression> expression)
         : Statement { std::move(sourceRange) }
         , expression { std::move(expression) }
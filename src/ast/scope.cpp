@@ -1,10 +1,14 @@
 module;
 
+#include <cctype>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 export module scc.ast:ast_scope;
+import :ast_generic_function_definition;
 import :ast_type_info;
 import :ast_statement;
 import :ast_variable_declaration;
@@ -22,9 +26,34 @@ export struct Scope final {
     {
         if (!parentScope) {
             // For global scope, add builtin type.
-            // TODO
-            m_types.emplace("int", TypeInfo { "int" });
             m_types.emplace("void", TypeInfo { "void" });
+            m_types.emplace("bool", TypeInfo { "bool", TypeKind::Bool, 8 });
+            m_types.emplace("int", TypeInfo { "int", TypeKind::Integer, 32, true });
+            for (auto bits : { 8, 16, 32, 64 }) {
+                m_types.emplace("i" + std::to_string(bits), TypeInfo { "i" + std::to_string(bits), TypeKind::Integer, bits, true });
+                m_types.emplace("u" + std::to_string(bits), TypeInfo { "u" + std::to_string(bits), TypeKind::Integer, bits, false });
+            }
+            m_types.emplace("f32", TypeInfo { "f32", TypeKind::Float, 32 });
+            m_types.emplace("f64", TypeInfo { "f64", TypeKind::Float, 64 });
+            m_types.emplace("string", TypeInfo { "string", TypeKind::String });
+
+            // SIMD types are 128, 256 or 512 bits wide, e.g. `f32x4`, `f32x8` and `f32x16`, and so
+            // are the masks their comparisons result in, e.g. `mask32x8` for both `f32x8` and `i32x8`.
+            for (auto width : { 128, 256, 512 }) {
+                for (auto bits : { 8, 16, 32, 64 }) {
+                    auto lanes = "x" + std::to_string(width / bits);
+                    auto& mask = m_types.emplace("mask" + std::to_string(bits) + lanes, TypeInfo { "mask" + std::to_string(bits) + lanes, TypeKind::Mask, bits }).first->second;
+                    mask.length = width / bits;
+
+                    auto laneTypes = std::vector<std::string> { "i" + std::to_string(bits), "u" + std::to_string(bits) };
+                    if (bits >= 32) {
+                        laneTypes.push_back("f" + std::to_string(bits));
+                    }
+                    for (const auto& laneType : laneTypes) {
+                        m_types.emplace(laneType + lanes, TypeInfo { laneType + lanes, TypeKind::Simd, m_types.at(laneType), (uint64_t)(width / bits) });
+                    }
+                }
+            }
         }
     }
 
@@ -32,15 +61,54 @@ export struct Scope final {
     {
         auto it = m_types.find(symbol);
         if (it == m_types.end()) {
-            return parentScope ? parentScope->QueryTypeInfo(symbol) : nullptr;
+            return parentScope ? parentScope->QueryTypeInfo(symbol) : CreateSequenceTypeInfo(symbol);
         } else {
             return &it->second;
         }
     }
 
+    // Looks the type up without creating the array, vector and slice types used for the first time.
+    const TypeInfo* QueryTypeInfo(const std::string& symbol) const
+    {
+        auto it = m_types.find(symbol);
+        if (it == m_types.end()) {
+            return parentScope ? static_cast<const Scope*>(parentScope)->QueryTypeInfo(symbol) : nullptr;
+        }
+        return &it->second;
+    }
+
+    // Structs are printed before the functions using them, in declaration order, since a struct may
+    // have fields of the structs declared before it.
+    TypeInfo& AddStructType(TypeInfo typeInfo)
+    {
+        auto name = typeInfo.fullName;
+        auto& structType = m_types.emplace(std::move(name), std::move(typeInfo)).first->second;
+        m_structTypes.push_back(&structType);
+        return structType;
+    }
+
+    const std::vector<TypeInfo*>& GetStructTypes() const
+    {
+        return m_structTypes;
+    }
+
+    // Functions are kept in the order they are added, which is the source order, so the passes and
+    // the translation see them in the same order on every run and with every standard library.
     void AddFunction(std::string name, std::unique_ptr<Statement> func)
     {
-        m_functions.emplace(std::move(name), std::move(func));
+        auto statement = func.get();
+        if (m_functions.emplace(std::move(name), std::move(func)).second) {
+            m_functionOrder.push_back(statement);
+        }
+    }
+
+    void RemoveFunction(const std::string& funcName)
+    {
+        auto it = m_functions.find(funcName);
+        if (it != m_functions.end()) {
+            std::erase(m_functionOrder, it->second.get());
+            m_functions.erase(it);
+        }
     }
 
     Statement* QueryFunction(const std::string& funcName) const
@@ -53,18 +121,83 @@ export struct Scope final {
         }
     }
 
-    std::vector<Statement*> GetFunctions() const
+    void AddGenericFunction(std::unique_ptr<GenericFunctionDefinition> genericFunction)
     {
-        std::vector<Statement*> functions {};
-        for (auto it = m_functions.begin(); it != m_functions.end(); ++it) {
-            functions.push_back(it->second.get());
+        auto name = genericFunction->name;
+        m_genericFunctions.emplace(std::move(name), std::move(genericFunction));
+    }
+
+    const GenericFunctionDefinition* QueryGenericFunction(const std::string& funcName) const
+    {
+        auto it = m_genericFunctions.find(funcName);
+        if (it == m_genericFunctions.end()) {
+            return parentScope ? parentScope->QueryGenericFunction(funcName) : nullptr;
+        } else {
+            return it->second.get();
         }
-        return std::move(functions);
+    }
+
+    std::vector<Statement*> GetFunctions() const
+    {
+        return m_functionOrder;
     }
 
 private:
+    // Arrays, vectors and slices of known types are added to the global scope when they are first
+    // used, e.g. `i32[4][]` is a vector of arrays of 4 `i32`. `@soa S[]` is a vector of the struct
+    // `S` laid out as struct of arrays. Tasks are added the same way, e.g. `task<i32[]>`.
+    TypeInfo* CreateSequenceTypeInfo(const std::string& symbol)
+    {
+        if (symbol.starts_with("task<") && symbol.ends_with('>')) {
+            auto resultType = QueryTypeInfo(symbol.substr(5, symbol.size() - 6));
+            if (!resultType) {
+                return nullptr;
+            }
+            return &m_types.emplace(symbol, TypeInfo { symbol, TypeKind::Task, *resultType }).first->second;
+        }
+
+        if (symbol.starts_with("@soa ")) {
+            auto typeInfo = QueryTypeInfo(symbol.substr(5));
+            if (!typeInfo || (typeInfo->kind != TypeKind::Array && typeInfo->kind != TypeKind::Vector) || typeInfo->elementType->kind != TypeKind::Struct) {
+                return nullptr;
+            }
+            auto soaTypeInfo = *typeInfo;
+            soaTypeInfo.fullName = symbol;
+            soaTypeInfo.isSoa = true;
+            return &m_types.emplace(symbol, std::move(soaTypeInfo)).first->second;
+        }
+
+        if (!symbol.ends_with(']')) {
+            return nullptr;
+        }
+        auto pos = symbol.rfind('[');
+        auto elementType = pos == std::string::npos ? nullptr : QueryTypeInfo(symbol.substr(0, pos));
+        if (!elementType || elementType->kind == TypeKind::Void) {
+            return nullptr;
+        }
+
+        auto size = symbol.substr(pos + 1, symbol.size() - pos - 2);
+        if (size.empty()) {
+            return &m_types.emplace(symbol, TypeInfo { symbol, TypeKind::Vector, *elementType }).first->second;
+        } else if (size == ":") {
+            return &m_types.emplace(symbol, TypeInfo { symbol, TypeKind::Slice, *elementType }).first->second;
+        }
+
+        uint64_t length {};
+        for (auto ch : size) {
+            if (!std::isdigit((unsigned char)ch)) {
+                return nullptr;
+            }
+            length = length * 10 + (ch - '0');
+        }
+        return &m_types.emplace(symbol, TypeInfo { symbol, TypeKind::Array, *elementType, length }).first->second;
+    }
+
     std::unordered_map<std::string, TypeInfo> m_types {};
     std::unordered_map<std::string, std::unique_ptr<Statement>> m_functions {};
+    std::unordered_map<std::string, std::unique_ptr<GenericFunctionDefinition>> m_genericFunctions {};
+    std::vector<TypeInfo*> m_structTypes {};
+    std::vector<Statement*> m_functionOrder {};
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,33 @@
+module;
+
+#include <memory>
+
+export module scc.ast:ast_slice_expression;
+import :ast_expression;
+import :ast_visitor;
+import :source_range;
+
+namespace scc::ast {
+
+// `array[begin:end]`, a view of the elements from `begin` up to, but not including, `end`. Both
+// bounds are optional, and default to the start and the end of the array.
+export struct SliceExpression final : Expression {
+    std::unique_ptr<Expression> arrayExpression;
+    std::unique_ptr<Expression> beginExpression;
+    std::unique_ptr<Expression> endExpression;
+
+    SliceExpression(SourceRange sourceRange, std::unique_ptr<Expression> arrayExpression, std::unique_ptr<Expression> beginExpression, std::unique_ptr<Expression> endExpression)
+        : Expression { std::move(sourceRange) }
+        , arrayExpression { std::move(arrayExpression) }
+        , beginExpression { std::move(beginExpression) }
+        , endExpression { std::move(endExpression) }
+    {
+    }
+
+    void Visit(Visitor& visitor) override
+    {
+        visitor.VisitAstSliceExpression(*this);
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+module;
+
+#include <cassert>
+#include <memory>
+
+export module scc.ast:ast_spawn_expression;
+import :ast_expression;
+import :ast_visitor;
+import :source_range;
+
+namespace scc::ast {
+
+// `spawn f(args)`, which starts the call as a task and evaluates to a `task<T>` of its result. The
+// call is always a FunctionCallExpression.
+export struct SpawnExpression final : Expression {
+    std::unique_ptr<Expression> callExpression {};
+
+    SpawnExpression(SourceRange sourceRange, std::unique_ptr<Expression> callExpression)
+        : Expression { std::move(sourceRange) }
+        , callExpression { std::move(callExpression) }
+    {
+        assert(this->callExpression);
+    }
+
+    void Visit(Visitor& visitor) override
+    {
+        visitor.VisitAstSpawnExpression(*this);
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+module;
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+export module scc.ast:ast_switch_statement;
+import :ast_expression;
+import :ast_scope;
+import :ast_statement;
+import :ast_visitor;
+import :source_range;
+
+namespace scc::ast {
+
+export struct CaseValue final {
+    SourceRange sourceRange {};
+    int64_t value {};
+};
+
+// A `case` of a switch statement, or the `default` case if it has no values.
+export struct SwitchCase final {
+    SourceRange sourceRange {};
+    std::vector<CaseValue> values {};
+    Scope scope {};
+};
+
+// `switch (x) { case 1, 2 { ... } default { ... } }` runs the statements of the case with the value
+// of the integer `x`, or of the `default` case, if any, when no case has it. The cases don't fall
+// through.
+export struct SwitchStatement final : Statement {
+    std::unique_ptr<Expression> conditionalExpression {};
+    std::vector<SwitchCase> cases {};
+
+    SwitchStatement(SourceRange sourceRange, std::unique_ptr<Expression> conditionalExpression, std::vector<SwitchCase> cases)
+        : Statement { std::move(sourceRange) }
+        , conditionalExpression { std::move(conditionalExpression) }
+        , cases { std::move(cases) }
+    {
+    }
+
+    void Visit(Visitor& visitor) override
+    {
+        visitor.VisitAstSwitchStatement(*this);
+    }
+};
+
+}
\ No newline at end of file
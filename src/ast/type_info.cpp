@@ -1,17 +1,109 @@
 module;
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 export module scc.ast:ast_type_info;
 
 namespace scc::ast {
 
+export enum class TypeKind {
+    Void,
+    Bool,
+    Integer,
+    Float,
+    String,
+
+    // `T[N]`, N elements stored inline.
+    Array,
+
+    // `T[]`, a growable array.
+    Vector,
+
+    // `T[:]`, a view of consecutive elements of an array or a vector.
+    Slice,
+
+    // `struct S { ... }`, a record of named fields.
+    Struct,
+
+    // `task<T>`, a spawned call with a result of type T.
+    Task,
+
+    // `f32x8`, a fixed number of lanes of a sized type, which the operators apply to at once.
+    Simd,
+
+    // `mask32x8`, which lanes of a comparison of SIMD values are true.
+    Mask,
+};
+
+export struct TypeInfo;
+
+export struct FieldInfo final {
+    std::string name {};
+    TypeInfo* typeInfo {};
+};
+
 export struct TypeInfo final {
     std::string fullName {};
+    TypeKind kind {};
+
+    // Width of arithmetic types in bits, and of the lanes of masks.
+    int bits {};
+    bool isSigned {};
+
+    // Element type of arrays, vectors and slices, and the number of elements of arrays. The result
+    // type of tasks. The lane type and the number of lanes of SIMD types, and the number of lanes of
+    // masks.
+    TypeInfo* elementType {};
+    uint64_t length {};
+
+    // Arrays and vectors of structs declared `@soa` store every field in an array of its own.
+    bool isSoa {};
+
+    // Fields of structs, in declaration order.
+    std::vector<FieldInfo> fields {};
 
-    explicit TypeInfo(std::string fullName)
+    explicit TypeInfo(std::string fullName, TypeKind kind = TypeKind::Void, int bits = 0, bool isSigned = false)
         : fullName { std::move(fullName) }
+        , kind { kind }
+        , bits { bits }
+        , isSigned { isSigned }
+    {
+    }
+
+    TypeInfo(std::string fullName, TypeKind kind, TypeInfo& elementType, uint64_t length = 0)
+        : fullName { std::move(fullName) }
+        , kind { kind }
+        , elementType { &elementType }
+        , length { length }
+    {
+    }
+
+    bool IsArithmetic() const
+    {
+        return kind == TypeKind::Bool || kind == TypeKind::Integer || kind == TypeKind::Float;
+    }
+
+    bool IsIntegral() const
+    {
+        return kind == TypeKind::Bool || kind == TypeKind::Integer;
+    }
+
+    // Arrays, vectors and slices, which can be indexed and sliced.
+    bool IsSequence() const
+    {
+        return kind == TypeKind::Array || kind == TypeKind::Vector || kind == TypeKind::Slice;
+    }
+
+    const FieldInfo* QueryField(const std::string& name) const
     {
+        for (const auto& field : fields) {
+            if (field.name == name) {
+                return &field;
+            }
+        }
+        return nullptr;
     }
 };
 
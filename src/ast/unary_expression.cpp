@@ -12,6 +12,7 @@ namespace scc::ast {
 
 export enum class UnaryOp {
     Bracket,
+    Minus,
 };
 
 export struct UnaryExpression final : Expression {
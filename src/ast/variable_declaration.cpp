@@ -1,6 +1,7 @@
 module;
 
 #include <memory>
+#include <string_view>
 
 export module scc.ast:ast_variable_declaration;
 import :ast_expression;
@@ -12,10 +13,60 @@ namespace scc::ast {
 
 export struct TypeInfo;
 
+// The qualifier of a declaration. `const` variables can't be assigned, `constexpr` variables are
+// initialized at compile time. `constexpr` functions can run at compile time, `consteval` functions
+// only run at compile time.
+export enum class Constness {
+    None,
+    Const,
+    Constexpr,
+    Consteval,
+};
+
+export constexpr std::string_view GetConstnessName(Constness constness)
+{
+    switch (constness) {
+    case Constness::Const:
+        return "const";
+    case Constness::Constexpr:
+        return "constexpr";
+    case Constness::Consteval:
+        return "consteval";
+    default:
+        return "";
+    }
+}
+
+// How a parameter is passed. `in` parameters refer to the argument and can't be written, which the
+// parser marks as `const`. `ref` parameters refer to the argument, which must be a variable, and
+// write through to it. `move` parameters take over the value of the argument.
+export enum class ParameterMode {
+    Value,
+    In,
+    Ref,
+    Move,
+};
+
+export constexpr std::string_view GetParameterModeName(ParameterMode parameterMode)
+{
+    switch (parameterMode) {
+    case ParameterMode::In:
+        return "in";
+    case ParameterMode::Ref:
+        return "ref";
+    case ParameterMode::Move:
+        return "move";
+    default:
+        return "";
+    }
+}
+
 export struct VariableDeclaration : Node {
     TypeInfo& typeInfo;
     std::string name {};
     std::unique_ptr<Expression> initExpression {};
+    Constness constness {};
+    ParameterMode parameterMode {};
 
     VariableDeclaration(SourceRange sourceRange, TypeInfo& typeinfo, std::string name, std::unique_ptr<Expression> initExpression = nullptr)
         : Node { std::move(sourceRange) }
@@ -4,18 +4,28 @@ export module scc.ast:ast_visitor;
 
 namespace scc::ast {
 
+export struct ArrayLiteralExpression;
+export struct AwaitExpression;
 export struct BinaryExpression;
 export struct BreakStatement;
 export struct ConditionalStatement;
+export struct ContinueStatement;
+export struct EmbedExpression;
 export struct ExpressionStatement;
+export struct FloatLiteralExpression;
 export struct ForLoopStatement;
 export struct FunctionCallExpression;
 export struct FunctionDefinitionStatement;
 export struct IdentifierExpression;
+export struct IndexExpression;
 export struct IntegerLiteralExpression;
+export struct MemberExpression;
 export struct ReturnStatement;
 export struct Scope;
+export struct SliceExpression;
+export struct SpawnExpression;
 export struct StringLiteralExpression;
+export struct SwitchStatement;
 export struct UnaryExpression;
 export struct VariableDeclaration;
 export struct VariableDefinitionStatement;
@@ -23,18 +33,28 @@ export struct VariableDefinitionStatement;
 export struct Visitor {
     virtual ~Visitor() = default;
 
+    virtual void VisitAstArrayLiteralExpression(const ArrayLiteralExpression& arrayLiteralExpression) = 0;
+    virtual void VisitAstAwaitExpression(const AwaitExpression& awaitExpression) = 0;
     virtual void VisitAstBinaryExpression(const BinaryExpression& binaryExpression) = 0;
     virtual void VisitAstBreakStatement(const BreakStatement& breakStatement) = 0;
     virtual void VisitAstConditionalStatement(const ConditionalStatement& conditionalStatement) = 0;
+    virtual void VisitAstContinueStatement(const ContinueStatement& continueStatement) = 0;
+    virtual void VisitAstEmbedExpression(const EmbedExpression& embedExpression) = 0;
     virtual void VisitAstExpressionStatement(const ExpressionStatement& expressionStatement) = 0;
+    virtual void VisitAstFloatLiteralExpression(const FloatLiteralExpression& floatLiteralExpression) = 0;
     virtual void VisitAstForLoopStatement(const ForLoopStatement& forLoopStatement) = 0;
     virtual void VisitAstFunctionCallExpression(const FunctionCallExpression& functionCallExpression) = 0;
     virtual void VisitFunctionDefinitionStatement(const FunctionDefinitionStatement& functionDefinitionStatement) = 0;
     virtual void VisitAstIdentifierExpression(const IdentifierExpression& identifierExpression) = 0;
+    virtual void VisitAstIndexExpression(const IndexExpression& indexExpression) = 0;
     virtual void VisitAstIntegerLiteralExpression(const IntegerLiteralExpression& integerLiteralExpression) = 0;
+    virtual void VisitAstMemberExpression(const MemberExpression& memberExpression) = 0;
     virtual void VisitReturnStatement(const ReturnStatement& returnStatement) = 0;
     virtual void VisitAstScope(const Scope& scope) = 0;
+    virtual void VisitAstSliceExpression(const SliceExpression& sliceExpression) = 0;
+    virtual void VisitAstSpawnExpression(const SpawnExpression& spawnExpression) = 0;
     virtual void VisitAstStringLiteralExpression(const StringLiteralExpression& stringLiteralExpression) = 0;
+    virtual void VisitAstSwitchStatement(const SwitchStatement& switchStatement) = 0;
     virtual void VisitAstUnaryExpression(const UnaryExpression& unaryExpression) = 0;
     virtual void VisitAstVariableDeclaration(const VariableDeclaration& variableDeclaration) = 0;
     virtual void VisitAstVariableDefinitionStatement(const VariableDefinitionStatement& variableDefinitionStatemet) = 0;
@@ -0,0 +1,127 @@
+module;
+
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <sys/wait.h>
+#include <system_error>
+#include <unistd.h>
+
+export module scc.cli:child_process;
+
+namespace scc::cli {
+
+// Writes to a file descriptor directly. It doesn't buffer, since the printers write a whole
+// top-level declaration at once.
+struct FileDescriptorBuffer final : std::streambuf {
+    FileDescriptorBuffer(int fd)
+        : m_fd { fd }
+    {
+    }
+
+protected:
+    std::streamsize xsputn(const char* str, std::streamsize count) override
+    {
+        auto written = std::streamsize {};
+        while (written < count) {
+            auto result = write(m_fd, str + written, count - written);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            written += result;
+        }
+        return written;
+    }
+
+    int_type overflow(int_type ch) override
+    {
+        if (traits_type::eq_int_type(ch, traits_type::eof())) {
+            return traits_type::not_eof(ch);
+        }
+        auto c = traits_type::to_char_type(ch);
+        return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+    }
+
+private:
+    int m_fd {};
+};
+
+// Runs a shell command reading its standard input from a pipe. The pipe is closed when the command
+// is waited for, and a command which isn't waited for is killed.
+export struct ChildProcess final {
+    ChildProcess(const std::string& command)
+    {
+        // The pipe isn't inherited by other commands started while this one runs, which would keep
+        // its input open after it's waited for.
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) < 0) {
+            throw std::system_error { errno, std::generic_category(), "can't create a pipe" };
+        }
+
+        // A command exiting before reading all of its input fails the writes, instead of killing
+        // the process writing.
+        std::signal(SIGPIPE, SIG_IGN);
+        m_pid = fork();
+        if (m_pid < 0) {
+            auto error = errno;
+            close(fds[0]);
+            close(fds[1]);
+            throw std::system_error { error, std::generic_category(), "can't start a process" };
+        }
+        if (m_pid == 0) {
+            std::signal(SIGPIPE, SIG_DFL);
+            dup2(fds[0], STDIN_FILENO);
+            close(fds[0]);
+            close(fds[1]);
+            execl("/bin/sh", "sh", "-c", command.c_str(), nullptr);
+            _exit(127);
+        }
+
+        close(fds[0]);
+        m_fd = fds[1];
+        m_buffer = std::make_unique<FileDescriptorBuffer>(m_fd);
+        m_input = std::make_shared<std::ostream>(m_buffer.get());
+    }
+
+    ChildProcess(const ChildProcess&) = delete;
+    ChildProcess& operator=(const ChildProcess&) = delete;
+
+    ~ChildProcess()
+    {
+        if (m_pid > 0) {
+            kill(m_pid, SIGTERM);
+            Wait();
+        }
+    }
+
+    std::shared_ptr<std::ostream> GetInput() const
+    {
+        return m_input;
+    }
+
+    // Closes the input, and returns the status of the command the way `std::system` does.
+    int Wait()
+    {
+        close(m_fd);
+        int status {};
+        while (waitpid(m_pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        m_pid = 0;
+        return status;
+    }
+
+private:
+    pid_t m_pid {};
+    int m_fd {};
+    std::unique_ptr<FileDescriptorBuffer> m_buffer {};
+    std::shared_ptr<std::ostream> m_input {};
+};
+
+}
\ No newline at end of file
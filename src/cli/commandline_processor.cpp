@@ -3,6 +3,8 @@ module;
 #include <format>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <string_view>
 #include <unordered_map>
 
 export module scc.cli:commandline_processor;
@@ -14,6 +16,10 @@ struct Option {
     std::string longSwitch {};
     std::string description {};
     std::function<void()> action {};
+
+    // Options taking a value have a name for it in the help, and an action taking it instead.
+    std::string valueName {};
+    std::function<void(const std::string&)> valueAction {};
 };
 
 export struct CommandlineProcessor {
@@ -42,6 +48,24 @@ export struct CommandlineProcessor {
         RegisterOption('\0', std::move(longSwitch), std::move(description), std::move(action));
     }
 
+    // The value follows the switch in the same argument or in the next one, e.g. `-j4`, `-j 4`,
+    // `--jobs=4` or `--jobs 4`.
+    void RegisterOption(char shortSwitch, std::string longSwitch, std::string valueName, std::string description, std::function<void(const std::string&)> action)
+    {
+        auto option = std::make_shared<Option>(Option {
+            .shortSwitch = shortSwitch,
+            .longSwitch = longSwitch,
+            .description = std::move(description),
+            .valueName = std::move(valueName),
+            .valueAction = std::move(action),
+        });
+        m_shortOptions.emplace(shortSwitch, option);
+        if (!longSwitch.empty()) {
+            m_longOptions.emplace(std::move(longSwitch), option);
+        }
+        m_options.push_back(std::move(option));
+    }
+
     void SetCommandLine(int argc, const char* const argv[])
     {
         m_args.clear();
@@ -50,17 +74,31 @@ export struct CommandlineProcessor {
             const auto arg = argv[i];
             if (arg[0] == '-') {
                 if (arg[1] == '-') {
-                    if (auto it = m_longOptions.find(arg + 2); it == m_longOptions.end()) {
-                        throw std::runtime_error { std::format("unknown option: {}", arg) };
-                    } else {
+                    auto longSwitch = std::string_view { arg + 2 };
+                    auto value = std::optional<std::string_view> {};
+                    if (auto pos = longSwitch.find('='); pos != std::string_view::npos) {
+                        value = longSwitch.substr(pos + 1);
+                        longSwitch = longSwitch.substr(0, pos);
+                    }
+                    if (auto it = m_longOptions.find(std::string { longSwitch }); it == m_longOptions.end()) {
+                        throw std::runtime_error { std::format("unknown option: --{}", longSwitch) };
+                    } else if (!it->second->valueAction) {
+                        if (value) {
+                            throw std::runtime_error { std::format("unexpected value for option: --{}", longSwitch) };
+                        }
                         it->second->action();
+                    } else {
+                        it->second->valueAction(value ? std::string { *value } : GetNextArg(argc, argv, i, std::format("--{}", longSwitch)));
                     }
                 } else {
                     for (const auto* p = &arg[1]; *p; ++p) {
                         if (auto it = m_shortOptions.find(*p); it == m_shortOptions.end()) {
                             throw std::runtime_error { std::format("unknown option: -{}", *p) };
-                        } else {
+                        } else if (!it->second->valueAction) {
                             it->second->action();
+                        } else {
+                            it->second->valueAction(p[1] ? std::string { p + 1 } : GetNextArg(argc, argv, i, std::format("-{}", *p)));
+                            break;
                         }
                     }
                 }
@@ -79,16 +117,27 @@ export struct CommandlineProcessor {
     {
         std::string str { "Options:\n\n" };
         for (const auto& opt : m_options) {
+            auto value = opt->valueName.empty() ? "" : std::format(" <{}>", opt->valueName);
             if (opt->longSwitch.empty()) {
-                str += std::format("\t-{}\t\t\t{}\n", opt->shortSwitch, opt->description);
+                str += std::format("\t-{}{}\t\t\t{}\n", opt->shortSwitch, value, opt->description);
+            } else if (!opt->shortSwitch) {
+                str += std::format("\t--{}{}\t\t{}\n", opt->longSwitch, value, opt->description);
             } else {
-                str += std::format("\t-{}, --{}\t\t{}\n", opt->shortSwitch, opt->longSwitch, opt->description);
+                str += std::format("\t-{}, --{}{}\t\t{}\n", opt->shortSwitch, opt->longSwitch, value, opt->description);
             }
         }
         return str;
     }
 
 private:
+    static std::string GetNextArg(int argc, const char* const argv[], int& i, std::string_view switchName)
+    {
+        if (i + 1 == argc) {
+            throw std::runtime_error { std::format("missing value for option: {}", switchName) };
+        }
+        return argv[++i];
+    }
+
     std::vector<std::shared_ptr<Option>> m_options;
     std::unordered_map<char, std::shared_ptr<Option>> m_shortOptions;
     std::unordered_map<std::string, std::shared_ptr<Option>> m_longOptions;
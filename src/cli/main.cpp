@@ -1,25 +1,46 @@
 #include <cassert>
+#include <charconv>
+#include <chrono>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <unistd.h>
+#include <vector>
 
 import scc.ast;
 import scc.cli;
 import scc.compiler;
+import scc.ir;
 
 struct Options {
     std::string inputFile {};
     bool needHelp {};
     bool compileOnly {};
+    bool keepUnusedFunctions {};
+    bool autoMemoize {};
+    bool forkJoin {};
+    bool optimize {};
+    bool emitIr {};
+    bool timePasses {};
+    bool precompute {};
+    bool saveTemps {};
+    size_t jobs { 1 };
 };
 
 void PrintHelp(const std::string_view& optionsHelp);
 void CompileAndRun(const Options& options);
 scc::ast::Scope Parse(const std::string& file);
+std::unique_ptr<scc::ir::Program> Optimize(const Options& options, const scc::ast::Scope& scope);
+std::optional<scc::compiler::ProgramOutput> Precompute(const Options& options, const scc::ast::Scope& scope, const scc::ir::Program* program);
+void TranslateUnits(const Options& options, const scc::ast::Scope& scope, const std::filesystem::path& basePath, const std::filesystem::path& exePath);
+std::filesystem::path GetStdModulePath();
+std::string GetCompileCommand(const std::string& input, const std::filesystem::path& exePath);
+std::string GetCompileObjectCommand(const std::string& input, const std::filesystem::path& objectPath);
+std::string GetLinkCommand(const std::string& objects, const std::filesystem::path& exePath);
 std::string GetFileLine(const std::string& file, int line);
 bool IsErrorColorSupported();
 
@@ -30,6 +51,20 @@ int main(int argc, const char* const argv[])
         scc::cli::CommandlineProcessor cmdProcessor {};
         cmdProcessor.RegisterOption('h', "help", "Print help", [&options] { options.needHelp = true; });
         cmdProcessor.RegisterOption('c', "Compile only", [&options] { options.compileOnly = true; });
+        cmdProcessor.RegisterOption("keep-unused", "Keep functions which are never called", [&options] { options.keepUnusedFunctions = true; });
+        cmdProcessor.RegisterOption("memo", "Memoize recursive functions without side effects", [&options] { options.autoMemoize = true; });
+        cmdProcessor.RegisterOption("fork-join", "Evaluate independent recursive calls in parallel", [&options] { options.forkJoin = true; });
+        cmdProcessor.RegisterOption('O', "Optimize through the SSA IR", [&options] { options.optimize = true; });
+        cmdProcessor.RegisterOption("emit-ir", "Print the optimized IR and exit", [&options] { options.emitIr = true; });
+        cmdProcessor.RegisterOption("time-passes", "Print the time spent in each IR pass", [&options] { options.timePasses = true; });
+        cmdProcessor.RegisterOption("precompute", "Evaluate programs without input at compile time", [&options] { options.precompute = true; });
+        cmdProcessor.RegisterOption("save-temps", "Keep the translated C++ file in the .scc folder", [&options] { options.saveTemps = true; });
+        cmdProcessor.RegisterOption('j', "jobs", "N", "Split the translation into N units compiled in parallel", [&options](const std::string& value) {
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), options.jobs);
+            if (error != std::errc {} || end != value.data() + value.size() || !options.jobs) {
+                throw std::runtime_error { std::format("invalid number of jobs: {}", value) };
+            }
+        });
         cmdProcessor.SetCommandLine(argc - 1, argv + 1);
 
         if (options.needHelp) {
@@ -92,26 +127,73 @@ void CompileAndRun(const Options& options)
 {
     assert(!options.inputFile.empty());
 
-    // Parse.
-    auto scope = Parse(options.inputFile);
-
-    // Translate.
     auto filePath = std::filesystem::path { options.inputFile };
     auto workingFolder = filePath.parent_path() / ".scc";
-    std::filesystem::create_directories(workingFolder);
+    auto exePath = workingFolder / "a.out";
+
+    // Unless the translation is kept, clang++ starts right away and reads it from a pipe, so its
+    // startup overlaps with the passes below, and it loads the imported modules and parses the
+    // declarations while the functions are translated. Split into units, it starts as each unit is
+    // written.
+    auto compiler = std::unique_ptr<scc::cli::ChildProcess> {};
+    if (!options.compileOnly && !options.saveTemps && !options.emitIr && options.jobs == 1) {
+        std::filesystem::create_directories(workingFolder);
+        compiler = std::make_unique<scc::cli::ChildProcess>(GetCompileCommand("-x c++ - -x none", exePath));
+    }
 
+    // Parse, and instantiate the generic functions called, which the passes below treat like the
+    // other functions.
+    auto scope = Parse(options.inputFile);
+    scc::compiler::TypeChecker {}.CheckCompileUnit(scope);
+
+    // Optimize.
+    scc::compiler::ConstantFolder {}.FoldCompileUnit(scope);
+    scc::compiler::SwitchConverter {}.ConvertCompileUnit(scope);
+    if (!options.keepUnusedFunctions) {
+        scc::compiler::DeadFunctionEliminator {}.EliminateCompileUnit(scope);
+    }
+    scc::compiler::Memoizer { options.autoMemoize }.MemoizeCompileUnit(scope);
+    if (options.forkJoin) {
+        scc::compiler::ForkJoinParallelizer {}.ParallelizeCompileUnit(scope);
+    }
+    scc::compiler::TailCallEliminator {}.EliminateCompileUnit(scope);
+
+    // Check last, so the expressions created by the passes are annotated too.
+    scc::compiler::TypeChecker {}.CheckCompileUnit(scope);
+    scc::compiler::BoundsCheckEliminator {}.EliminateCompileUnit(scope);
+
+    auto program = options.optimize || options.emitIr ? Optimize(options, scope) : nullptr;
+    if (options.emitIr) {
+        scc::compiler::IrPrinter { std::shared_ptr<std::ostream> { &std::cout, [](auto) {} } }.PrintProgram(*program);
+        return;
+    }
+
+    auto output = options.precompute ? Precompute(options, scope, program.get()) : std::nullopt;
+
+    // Translate. The translators write their output a top-level declaration at a time, and the
+    // rest when they are destroyed, which closes the file.
     auto outFile = workingFolder / (filePath.filename().string() + ".cpp");
-    scc::compiler::Translator { std::make_shared<std::ofstream>(outFile) }.VisitAstScope(scope);
+    auto openOutput = [&]() -> std::shared_ptr<std::ostream> {
+        if (compiler) {
+            return compiler->GetInput();
+        }
+        std::filesystem::create_directories(workingFolder);
+        return std::make_shared<std::ofstream>(outFile);
+    };
+    if (output) {
+        scc::compiler::OutputTranslator { openOutput() }.TranslateOutput(*output);
+    } else if (program) {
+        scc::compiler::IrTranslator { openOutput() }.TranslateProgram(*program);
+    } else if (options.jobs > 1) {
+        TranslateUnits(options, scope, workingFolder / filePath.filename(), exePath);
+        return;
+    } else {
+        scc::compiler::Translator { openOutput() }.VisitAstScope(scope);
+    }
 
     if (!options.compileOnly) {
-        // Invoke clang++ to compile.
-        char result[PATH_MAX];
-        result[readlink("/proc/self/exe", result, PATH_MAX)] = '\0';
-        auto appPath = std::filesystem::path { result }.parent_path();
-        auto stdModulePath = appPath / "std";
-        auto stdLibPath = stdModulePath / "libscc.std.a";
-        auto exePath = workingFolder / "a.out";
-        auto res = std::system(std::format("clang++-18 -std=c++20 -fprebuilt-module-path={} -w {} {} -o {}", stdModulePath.string(), outFile.string(), stdLibPath.string(), exePath.string()).c_str());
+        // Wait for clang++ reading the pipe, or invoke it on the file kept.
+        auto res = compiler ? compiler->Wait() : std::system(GetCompileCommand(outFile.string(), exePath).c_str());
 
         // Run.
         if (!res) {
@@ -120,14 +202,130 @@ void CompileAndRun(const Options& options)
     }
 }
 
+// The header and units are named after `basePath`, e.g. `name.scc.h` and `name.scc.0.cpp`. Each
+// unit is compiled by its own clang++, reading it from a pipe unless it's kept, and the objects are
+// linked with the standard library.
+void TranslateUnits(const Options& options, const scc::ast::Scope& scope, const std::filesystem::path& basePath, const std::filesystem::path& exePath)
+{
+    std::filesystem::create_directories(basePath.parent_path());
+    auto headerFile = basePath.string() + ".h";
+    auto unitFiles = std::vector<std::string> {};
+    auto objects = std::string {};
+    auto compilers = std::vector<std::unique_ptr<scc::cli::ChildProcess>> {};
+    auto units = std::vector<std::shared_ptr<std::ostream>> {};
+    for (size_t i = 0; i < options.jobs; ++i) {
+        auto objectFile = std::format("{}.{}.o", basePath.string(), i);
+        objects += ' ' + objectFile;
+        unitFiles.push_back(std::format("{}.{}.cpp", basePath.string(), i));
+        if (options.compileOnly || options.saveTemps) {
+            units.push_back(std::make_shared<std::ofstream>(unitFiles.back()));
+        } else {
+            compilers.push_back(std::make_unique<scc::cli::ChildProcess>(GetCompileObjectCommand("-x c++ -", objectFile)));
+            units.push_back(compilers.back()->GetInput());
+        }
+    }
+
+    // The units include the header from the folder they are compiled in.
+    scc::compiler::Translator { std::make_shared<std::ofstream>(headerFile) }.TranslateCompileUnit(scope, basePath.filename().string() + ".h", units);
+    units.clear();
+    if (options.compileOnly) {
+        return;
+    }
+
+    if (options.saveTemps) {
+        for (size_t i = 0; i < options.jobs; ++i) {
+            compilers.push_back(std::make_unique<scc::cli::ChildProcess>(GetCompileObjectCommand(unitFiles[i], std::format("{}.{}.o", basePath.string(), i))));
+        }
+    }
+    auto failed = false;
+    for (const auto& compiler : compilers) {
+        failed |= compiler->Wait() != 0;
+    }
+
+    // Link, and run.
+    if (!failed && !std::system(GetLinkCommand(objects, exePath).c_str())) {
+        std::system(exePath.string().c_str());
+    }
+}
+
 scc::ast::Scope Parse(const std::string& file)
 {
     scc::ast::Scope scope {};
     scc::compiler::Lexer lexer { std::make_shared<std::ifstream>(file) };
-    scc::compiler::Parser {}.ParseCompileUnit(scope, lexer);
+    scc::compiler::Parser { std::filesystem::path { file }.parent_path() }.ParseCompileUnit(scope, lexer);
     return std::move(scope);
 }
 
+std::unique_ptr<scc::ir::Program> Optimize(const Options& options, const scc::ast::Scope& scope)
+{
+    std::unique_ptr<scc::ir::Program> program {};
+    try {
+        program = scc::compiler::IrLowering {}.LowerCompileUnit(scope);
+    } catch (const scc::compiler::Exception&) {
+        if (options.emitIr) {
+            throw;
+        }
+
+        // The IR doesn't support everything yet, translate from the AST instead.
+        return nullptr;
+    }
+
+    scc::ir::PassManager passManager {};
+    passManager.AddPass(std::make_unique<scc::ir::CommonSubexpressionElimination>());
+    passManager.AddPass(std::make_unique<scc::ir::LoopInvariantCodeMotion>());
+    passManager.AddPass(std::make_unique<scc::ir::StrengthReduction>());
+    passManager.AddPass(std::make_unique<scc::ir::DeadCodeElimination>());
+    passManager.Run(*program);
+
+    if (options.timePasses) {
+        for (const auto& timing : passManager.GetTimings()) {
+            std::cerr << std::format("{:<32}{:>12.3f} ms", timing.name, std::chrono::duration<double, std::milli> { timing.duration }.count()) << std::endl;
+        }
+    }
+    return program;
+}
+
+std::optional<scc::compiler::ProgramOutput> Precompute(const Options& options, const scc::ast::Scope& scope, const scc::ir::Program* program)
+{
+    auto warning = IsErrorColorSupported() ? "\e[95mwarning:\e[0m" : "warning:";
+    try {
+        auto loweredProgram = program ? nullptr : scc::compiler::IrLowering {}.LowerCompileUnit(scope);
+        return scc::compiler::Evaluator {}.EvaluateProgram(program ? *program : *loweredProgram);
+    } catch (const scc::compiler::Exception& ex) {
+        std::cerr << std::format("{}:{}:{}: {} can't precompute the output: {}", options.inputFile, ex.startLine, ex.startColumn, warning, ex.what()) << std::endl;
+    } catch (const std::runtime_error& ex) {
+        std::cerr << std::format("{}: {} can't precompute the output: {}", options.inputFile, warning, ex.what()) << std::endl;
+    }
+    return std::nullopt;
+}
+
+// The input is either a file, or the options reading standard input. Those end with `-x none`, so
+// the library after them isn't read as C++.
+std::string GetCompileCommand(const std::string& input, const std::filesystem::path& exePath)
+{
+    auto stdModulePath = GetStdModulePath();
+    auto stdLibPath = stdModulePath / "libscc.std.a";
+    return std::format("clang++-18 -std=c++20 -pthread -fprebuilt-module-path={} -w {} {} -o {}", stdModulePath.string(), input, stdLibPath.string(), exePath.string());
+}
+
+// The header of the units is looked up next to the object.
+std::string GetCompileObjectCommand(const std::string& input, const std::filesystem::path& objectPath)
+{
+    return std::format("clang++-18 -std=c++20 -pthread -fprebuilt-module-path={} -iquote {} -w -c {} -o {}", GetStdModulePath().string(), objectPath.parent_path().string(), input, objectPath.string());
+}
+
+std::string GetLinkCommand(const std::string& objects, const std::filesystem::path& exePath)
+{
+    return std::format("clang++-18 -pthread{} {} -o {}", objects, (GetStdModulePath() / "libscc.std.a").string(), exePath.string());
+}
+
+std::filesystem::path GetStdModulePath()
+{
+    char result[PATH_MAX];
+    result[readlink("/proc/self/exe", result, PATH_MAX)] = '\0';
+    return std::filesystem::path { result }.parent_path() / "std";
+}
+
 std::string GetFileLine(const std::string& file, int line)
 {
     std::ifstream in { file };
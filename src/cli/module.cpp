@@ -1,4 +1,5 @@
 module;
 
 export module scc.cli;
+export import :child_process;
 export import :commandline_processor;
\ No newline at end of file
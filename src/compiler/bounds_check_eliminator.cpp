@@ -0,0 +1,214 @@
+module;
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+import scc.ast;
+
+export module scc.compiler:bounds_check_eliminator;
+
+namespace scc::compiler {
+
+using namespace ast;
+
+// Removes the bounds checks of the elements indexed by the variable of a canonical loop:
+//
+//     for (int i = 0; i < std::len(a); i += 1) {
+//         sum += a[i];
+//     }
+//
+// The index starts at a constant and only grows by one while it is less than the length, so `a[i]`
+// is in bounds as long as the body doesn't assign `i` or `a`, doesn't push to `a`, doesn't pass
+// either to a `ref` parameter, and doesn't define other variables with these names. A constant
+// bound, e.g. `i < 4`, covers the arrays with at least as many elements.
+//
+// The types of the arrays are annotated by the `TypeChecker`, which must run first.
+export struct BoundsCheckEliminator final {
+    void EliminateCompileUnit(Scope& scope)
+    {
+        for (auto func : scope.GetFunctions()) {
+            EliminateScope(static_cast<FunctionDefinitionStatement*>(func)->bodyScope);
+        }
+        EliminateScope(scope);
+    }
+
+private:
+    struct CanonicalLoop {
+        std::string index {};
+
+        // The array whose length bounds the index, empty if the bound is a constant.
+        std::string array {};
+        uint64_t bound {};
+    };
+
+    // Finds the statements which may invalidate the index for the elements of the array.
+    struct ModificationFinder final : RecursiveVisitor {
+        const CanonicalLoop& loop;
+        bool found {};
+
+        explicit ModificationFinder(const CanonicalLoop& loop)
+            : loop { loop }
+        {
+        }
+
+        void VisitAstBinaryExpression(const BinaryExpression& binaryExpression) override
+        {
+            // Assignment operators come first in `BinaryOp`.
+            found = found || (binaryExpression.op <= BinaryOp::BitOrAssignment && IsLoopVariable(*binaryExpression.leftOprand));
+            RecursiveVisitor::VisitAstBinaryExpression(binaryExpression);
+        }
+
+        void VisitAstFunctionCallExpression(const FunctionCallExpression& functionCallExpression) override
+        {
+            const auto& args = functionCallExpression.argsExpression;
+            found = found || (IsVariable(*functionCallExpression.funcExpression, "std::push") && !args.empty() && IsLoopVariable(*args[0]));
+
+            // A `ref` parameter may assign the variable passed to it.
+            for (size_t i = 0; i < args.size() && functionCallExpression.function; ++i) {
+                const auto& parameter = *functionCallExpression.function->headerScope.variableDeclarations[i];
+                found = found || (parameter.parameterMode == ParameterMode::Ref && IsLoopVariable(*args[i]));
+            }
+            RecursiveVisitor::VisitAstFunctionCallExpression(functionCallExpression);
+        }
+
+        void VisitAstVariableDeclaration(const VariableDeclaration& variableDeclaration) override
+        {
+            found = found || variableDeclaration.name == loop.index || variableDeclaration.name == loop.array;
+            RecursiveVisitor::VisitAstVariableDeclaration(variableDeclaration);
+        }
+
+        bool IsLoopVariable(const Expression& expression) const
+        {
+            return IsVariable(expression, loop.index) || (!loop.array.empty() && IsVariable(expression, loop.array));
+        }
+    };
+
+    struct IndexExpressionCollector final : RecursiveVisitor {
+        const CanonicalLoop& loop;
+        std::vector<const IndexExpression*> indexExpressions {};
+
+        explicit IndexExpressionCollector(const CanonicalLoop& loop)
+            : loop { loop }
+        {
+        }
+
+        void VisitAstIndexExpression(const IndexExpression& indexExpression) override
+        {
+            if (IsVariable(*indexExpression.indexExpression, loop.index) && IsBounded(*indexExpression.arrayExpression)) {
+                indexExpressions.push_back(&indexExpression);
+            }
+            RecursiveVisitor::VisitAstIndexExpression(indexExpression);
+        }
+
+        bool IsBounded(const Expression& arrayExpression) const
+        {
+            if (!loop.array.empty()) {
+                return IsVariable(arrayExpression, loop.array);
+            }
+            const auto typeInfo = arrayExpression.typeInfo;
+            return typeInfo && typeInfo->kind == TypeKind::Array && typeInfo->length >= loop.bound;
+        }
+    };
+
+    void EliminateScope(Scope& scope)
+    {
+        for (const auto& statement : scope.statements) {
+            if (auto conditionalStatement = dynamic_cast<ConditionalStatement*>(statement.get())) {
+                EliminateScope(conditionalStatement->trueScope);
+                EliminateScope(conditionalStatement->falseScope);
+            } else if (auto switchStatement = dynamic_cast<SwitchStatement*>(statement.get())) {
+                for (auto& switchCase : switchStatement->cases) {
+                    EliminateScope(switchCase.scope);
+                }
+            } else if (auto forLoopStatement = dynamic_cast<ForLoopStatement*>(statement.get())) {
+                if (auto loop = MatchCanonicalLoop(*forLoopStatement)) {
+                    auto finder = ModificationFinder { *loop };
+                    finder.VisitAstScope(forLoopStatement->bodyScope);
+                    if (!finder.found) {
+                        auto collector = IndexExpressionCollector { *loop };
+                        collector.VisitAstScope(forLoopStatement->bodyScope);
+
+                        // The visitors only see const nodes, but the loop body is not const.
+                        for (auto indexExpression : collector.indexExpressions) {
+                            const_cast<IndexExpression*>(indexExpression)->checked = false;
+                        }
+                    }
+                }
+                EliminateScope(forLoopStatement->bodyScope);
+            }
+        }
+    }
+
+    // Matches `for (T i = C; i < std::len(a); i += 1)` and `for (T i = C; i < N; i += 1)`, where the
+    // index has at least 32 bits, so it can't wrap around before reaching the bound.
+    static std::optional<CanonicalLoop> MatchCanonicalLoop(const ForLoopStatement& forLoopStatement)
+    {
+        const auto& initStatements = forLoopStatement.initScope.statements;
+        auto variableDefinitionStatement = initStatements.size() == 1 ? dynamic_cast<const VariableDefinitionStatement*>(initStatements.front().get()) : nullptr;
+        if (!variableDefinitionStatement) {
+            return std::nullopt;
+        }
+        const auto& variableDeclaration = variableDefinitionStatement->variableDeclaration;
+        const auto& initExpression = variableDeclaration.initExpression;
+        if (variableDeclaration.typeInfo.kind != TypeKind::Integer || variableDeclaration.typeInfo.bits < 32 || (initExpression && !dynamic_cast<const IntegerLiteralExpression*>(initExpression.get()))) {
+            return std::nullopt;
+        }
+
+        auto loop = CanonicalLoop { variableDeclaration.name };
+        auto condition = dynamic_cast<const BinaryExpression*>(forLoopStatement.conditionalExpression.get());
+        if (!condition || condition->op != BinaryOp::Less || !IsVariable(*condition->leftOprand, loop.index)) {
+            return std::nullopt;
+        }
+        if (auto functionCallExpression = dynamic_cast<const FunctionCallExpression*>(condition->rightOprand.get())) {
+            const auto& args = functionCallExpression->argsExpression;
+            auto array = args.size() == 1 ? dynamic_cast<const IdentifierExpression*>(args[0].get()) : nullptr;
+            if (!IsVariable(*functionCallExpression->funcExpression, "std::len") || !array || array->fullName == loop.index) {
+                return std::nullopt;
+            }
+            loop.array = array->fullName;
+        } else if (auto integerLiteralExpression = dynamic_cast<const IntegerLiteralExpression*>(condition->rightOprand.get())) {
+            loop.bound = integerLiteralExpression->value;
+        } else {
+            return std::nullopt;
+        }
+
+        if (!IsIncrement(forLoopStatement.iterationExpression.get(), loop.index)) {
+            return std::nullopt;
+        }
+        return loop;
+    }
+
+    // Matches `i += 1` and `i = i + 1`.
+    static bool IsIncrement(const Expression* expression, const std::string& name)
+    {
+        auto binaryExpression = dynamic_cast<const BinaryExpression*>(expression);
+        if (!binaryExpression || !IsVariable(*binaryExpression->leftOprand, name)) {
+            return false;
+        }
+        if (binaryExpression->op == BinaryOp::AddAssignment) {
+            return IsOne(*binaryExpression->rightOprand);
+        }
+        auto addExpression = dynamic_cast<const BinaryExpression*>(binaryExpression->rightOprand.get());
+        return binaryExpression->op == BinaryOp::Assignment && addExpression && addExpression->op == BinaryOp::Add
+            && ((IsVariable(*addExpression->leftOprand, name) && IsOne(*addExpression->rightOprand)) || (IsOne(*addExpression->leftOprand) && IsVariable(*addExpression->rightOprand, name)));
+    }
+
+    static bool IsOne(const Expression& expression)
+    {
+        auto integerLiteralExpression = dynamic_cast<const IntegerLiteralExpression*>(&expression);
+        return integerLiteralExpression && integerLiteralExpression->value == 1;
+    }
+
+    static bool IsVariable(const Expression& expression, const std::string& name)
+    {
+        if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(&expression); unaryExpression && unaryExpression->op == UnaryOp::Bracket) {
+            return IsVariable(*unaryExpression->oprand, name);
+        }
+        auto identifierExpression = dynamic_cast<const IdentifierExpression*>(&expression);
+        return identifierExpression && identifierExpression->fullName == name;
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+module;
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+import scc.ast;
+
+export module scc.compiler:call_graph;
+
+namespace scc::compiler {
+
+using namespace ast;
+
+// Call graph of the functions defined in a compile unit, built from the function call expressions
+// in every function body and in the global statements.
+export struct CallGraph final {
+    explicit CallGraph(const Scope& scope)
+    {
+        for (auto func : scope.GetFunctions()) {
+            const auto& functionDefinitionStatement = *static_cast<const FunctionDefinitionStatement*>(func);
+            m_callees[functionDefinitionStatement.name] = CollectCallees(functionDefinitionStatement.bodyScope);
+        }
+        m_globalCallees = CollectCallees(scope);
+        m_hasMainFunction = m_callees.contains("main");
+    }
+
+    // Returns the functions defined in the compile unit which are called by the function.
+    std::unordered_set<std::string> GetCallees(const std::string& funcName) const
+    {
+        auto callees = std::unordered_set<std::string> {};
+        if (auto it = m_callees.find(funcName); it != m_callees.end()) {
+            for (const auto& callee : it->second) {
+                if (m_callees.contains(callee)) {
+                    callees.insert(callee);
+                }
+            }
+        }
+        return callees;
+    }
+
+    // Returns the functions called by the function which are not defined in the compile unit, e.g.
+    // from `scc.std`.
+    std::unordered_set<std::string> GetExternalCallees(const std::string& funcName) const
+    {
+        auto callees = std::unordered_set<std::string> {};
+        if (auto it = m_callees.find(funcName); it != m_callees.end()) {
+            for (const auto& callee : it->second) {
+                if (!m_callees.contains(callee)) {
+                    callees.insert(callee);
+                }
+            }
+        }
+        return callees;
+    }
+
+    bool HasExternalCallees(const std::string& funcName) const
+    {
+        return !GetExternalCallees(funcName).empty();
+    }
+
+    // Returns true if the function can call itself, directly or through other functions.
+    bool IsRecursive(const std::string& funcName) const
+    {
+        auto visited = std::unordered_set<std::string> {};
+        auto pending = std::vector<std::string> { funcName };
+        while (!pending.empty()) {
+            auto callees = GetCallees(pending.back());
+            pending.pop_back();
+            for (const auto& callee : callees) {
+                if (callee == funcName) {
+                    return true;
+                }
+                if (visited.insert(callee).second) {
+                    pending.push_back(callee);
+                }
+            }
+        }
+        return false;
+    }
+
+    // Returns the functions reachable from the entry points, which are the 'main' function if it is
+    // defined and the global statements, including the initializers of global variables.
+    std::unordered_set<std::string> GetReachableFunctions() const
+    {
+        auto reachable = std::unordered_set<std::string> {};
+        auto pending = std::vector<std::string> { m_globalCallees.begin(), m_globalCallees.end() };
+        if (m_hasMainFunction) {
+            pending.push_back("main");
+        }
+
+        while (!pending.empty()) {
+            auto funcName = std::move(pending.back());
+            pending.pop_back();
+
+            auto it = m_callees.find(funcName);
+            if (it == m_callees.end() || !reachable.insert(funcName).second) {
+                continue;
+            }
+            pending.insert(pending.end(), it->second.begin(), it->second.end());
+        }
+        return reachable;
+    }
+
+private:
+    struct CalleeCollector final : RecursiveVisitor {
+        std::unordered_set<std::string> callees {};
+
+        void VisitAstFunctionCallExpression(const FunctionCallExpression& functionCallExpression) override
+        {
+            if (auto identifierExpression = dynamic_cast<const IdentifierExpression*>(functionCallExpression.funcExpression.get())) {
+                callees.insert(identifierExpression->fullName);
+            }
+            RecursiveVisitor::VisitAstFunctionCallExpression(functionCallExpression);
+        }
+    };
+
+    static std::unordered_set<std::string> CollectCallees(const Scope& scope)
+    {
+        auto collector = CalleeCollector {};
+        collector.VisitAstScope(scope);
+        return std::move(collector.callees);
+    }
+
+    std::unordered_map<std::string, std::unordered_set<std::string>> m_callees {};
+    std::unordered_set<std::string> m_globalCallees {};
+    bool m_hasMainFunction {};
+};
+
+}
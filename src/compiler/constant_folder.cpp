@@ -0,0 +1,449 @@
+module;
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+import scc.ast;
+
+export module scc.compiler:constant_folder;
+
+namespace scc::compiler {
+
+using namespace ast;
+
+// Folds constant integer expressions, propagates local `int` variables which are initialized with
+// a constant and never reassigned, and removes the dead branch of conditional statements whose
+// condition is known at compile time.
+//
+// Folding follows the semantics of the generated C++: an integer literal has type `int` if it fits,
+// otherwise `long`, and arithmetic is done in the wider type of both operands. Expressions which
+// overflow (undefined behavior in C++) or divide by zero are left untouched.
+export struct ConstantFolder final {
+    void FoldCompileUnit(Scope& scope)
+    {
+        // Collect all assigned variables first, so propagation never has to look ahead.
+        m_collectAssignments = true;
+        FoldFunctions(scope);
+        FoldScope(scope);
+
+        m_collectAssignments = false;
+        FoldFunctions(scope);
+        FoldScope(scope);
+    }
+
+private:
+    enum class ConstantType {
+        Bool,
+        Int,
+        Long,
+    };
+
+    struct Constant {
+        int64_t value {};
+        ConstantType type {};
+    };
+
+    void FoldFunctions(Scope& scope)
+    {
+        for (auto func : scope.GetFunctions()) {
+            auto& functionDefinitionStatement = *static_cast<FunctionDefinitionStatement*>(func);
+
+            // Parameters are bound in the header scope, but never treated as constant.
+            m_variables.emplace_back();
+            for (const auto& variableDeclaration : functionDefinitionStatement.headerScope.variableDeclarations) {
+                m_variables.back()[variableDeclaration->name] = variableDeclaration.get();
+            }
+            FoldScope(functionDefinitionStatement.bodyScope);
+            m_variables.pop_back();
+        }
+    }
+
+    void FoldScope(Scope& scope)
+    {
+        m_variables.emplace_back();
+
+        auto statements = std::vector<std::unique_ptr<Statement>> {};
+        statements.reserve(scope.statements.size());
+        for (auto& statement : scope.statements) {
+            FoldStatement(statement, statements);
+        }
+        if (!m_collectAssignments) {
+            scope.statements = std::move(statements);
+        }
+
+        m_variables.pop_back();
+    }
+
+    // Folds the statement and appends the result (zero or more statements) to `statements`.
+    void FoldStatement(std::unique_ptr<Statement>& statement, std::vector<std::unique_ptr<Statement>>& statements)
+    {
+        if (auto variableDefinitionStatement = dynamic_cast<VariableDefinitionStatement*>(statement.get())) {
+            if (!FoldVariableDefinitionStatement(*variableDefinitionStatement)) {
+                return;
+            }
+        } else if (auto expressionStatement = dynamic_cast<ExpressionStatement*>(statement.get())) {
+            FoldExpression(expressionStatement->expression);
+        } else if (auto returnStatement = dynamic_cast<ReturnStatement*>(statement.get())) {
+            if (returnStatement->expression) {
+                FoldExpression(returnStatement->expression);
+            }
+        } else if (auto forLoopStatement = dynamic_cast<ForLoopStatement*>(statement.get())) {
+            FoldForLoopStatement(*forLoopStatement);
+        } else if (auto conditionalStatement = dynamic_cast<ConditionalStatement*>(statement.get())) {
+            if (FoldConditionalStatement(*conditionalStatement, statements)) {
+                return;
+            }
+        } else if (auto switchStatement = dynamic_cast<SwitchStatement*>(statement.get())) {
+            FoldExpression(switchStatement->conditionalExpression);
+            for (auto& switchCase : switchStatement->cases) {
+                FoldScope(switchCase.scope);
+            }
+        }
+        if (!m_collectAssignments) {
+            statements.push_back(std::move(statement));
+        }
+    }
+
+    // Returns false if the definition is propagated and should be removed.
+    bool FoldVariableDefinitionStatement(VariableDefinitionStatement& variableDefinitionStatement)
+    {
+        auto& variableDeclaration = variableDefinitionStatement.variableDeclaration;
+
+        auto value = std::optional<Constant> { Constant { 0, ConstantType::Int } };
+        if (variableDeclaration.initExpression) {
+            value = FoldExpression(variableDeclaration.initExpression);
+        }
+        m_variables.back()[variableDeclaration.name] = &variableDeclaration;
+
+        if (m_collectAssignments || m_assignedVariables.contains(&variableDeclaration) || variableDeclaration.typeInfo.fullName != "int") {
+            return true;
+        }
+        if (!value || value->type == ConstantType::Bool || !IsInRange(*value, ConstantType::Int)) {
+            return true;
+        }
+
+        // Global `constexpr` variables stay defined for the functions using them.
+        m_constants[&variableDeclaration] = value->value;
+        return variableDeclaration.constness == Constness::Constexpr;
+    }
+
+    void FoldForLoopStatement(ForLoopStatement& forLoopStatement)
+    {
+        // A reduction assigns its variable once the parallel loop is done, even if the body doesn't.
+        for (const auto& reduction : forLoopStatement.reductions) {
+            if (auto variableDeclaration = QueryVariable(reduction.variableName); m_collectAssignments && variableDeclaration) {
+                m_assignedVariables.insert(variableDeclaration);
+            }
+        }
+
+        // The init scope is still in effect for condition, iteration and body.
+        m_variables.emplace_back();
+        auto statements = std::vector<std::unique_ptr<Statement>> {};
+        for (auto& statement : forLoopStatement.initScope.statements) {
+            FoldStatement(statement, statements);
+        }
+        if (!m_collectAssignments) {
+            forLoopStatement.initScope.statements = std::move(statements);
+        }
+
+        if (forLoopStatement.conditionalExpression) {
+            FoldExpression(forLoopStatement.conditionalExpression);
+        }
+        if (forLoopStatement.iterationExpression) {
+            FoldExpression(forLoopStatement.iterationExpression);
+        }
+        FoldScope(forLoopStatement.bodyScope);
+        m_variables.pop_back();
+    }
+
+    // Returns true if the statement is decided at compile time and replaced in `statements`.
+    bool FoldConditionalStatement(ConditionalStatement& conditionalStatement, std::vector<std::unique_ptr<Statement>>& statements)
+    {
+        auto condition = FoldExpression(conditionalStatement.conditionalExpression);
+        FoldScope(conditionalStatement.trueScope);
+        FoldScope(conditionalStatement.falseScope);
+        if (!condition || m_collectAssignments) {
+            return false;
+        }
+
+        if (!condition->value) {
+            std::swap(conditionalStatement.trueScope, conditionalStatement.falseScope);
+        }
+        conditionalStatement.falseScope = Scope { conditionalStatement.falseScope.parentScope };
+
+        // Variables defined in the taken branch must stay in their own C++ block.
+        const auto& trueStatements = conditionalStatement.trueScope.statements;
+        if (std::ranges::any_of(trueStatements, [](const auto& statement) { return dynamic_cast<VariableDefinitionStatement*>(statement.get()) != nullptr; })) {
+            conditionalStatement.conditionalExpression = std::make_unique<IntegerLiteralExpression>(conditionalStatement.conditionalExpression->sourceRange, 1);
+            return false;
+        }
+
+        for (auto& statement : conditionalStatement.trueScope.statements) {
+            statements.push_back(std::move(statement));
+        }
+        return true;
+    }
+
+    std::optional<Constant> FoldExpression(std::unique_ptr<Expression>& expression)
+    {
+        assert(expression);
+
+        if (auto integerLiteralExpression = dynamic_cast<IntegerLiteralExpression*>(expression.get())) {
+            if (integerLiteralExpression->value <= std::numeric_limits<int32_t>::max()) {
+                return Constant { (int64_t)integerLiteralExpression->value, ConstantType::Int };
+            } else if (integerLiteralExpression->value <= std::numeric_limits<int64_t>::max()) {
+                return Constant { (int64_t)integerLiteralExpression->value, ConstantType::Long };
+            } else {
+                return std::nullopt;
+            }
+        } else if (auto identifierExpression = dynamic_cast<IdentifierExpression*>(expression.get())) {
+            auto variableDeclaration = QueryVariable(identifierExpression->fullName);
+            if (auto it = m_constants.find(variableDeclaration); variableDeclaration && it != m_constants.end()) {
+                auto constant = Constant { it->second, ConstantType::Int };
+                expression = MakeLiteralExpression(expression->sourceRange, constant);
+                return constant;
+            }
+            return std::nullopt;
+        } else if (auto unaryExpression = dynamic_cast<UnaryExpression*>(expression.get())) {
+            return FoldUnaryExpression(expression, *unaryExpression);
+        } else if (auto binaryExpression = dynamic_cast<BinaryExpression*>(expression.get())) {
+            return FoldBinaryExpression(expression, *binaryExpression);
+        } else if (auto functionCallExpression = dynamic_cast<FunctionCallExpression*>(expression.get())) {
+            // The function expression names a function, never a variable. A variable passed to a
+            // `ref` parameter is assigned by the call.
+            for (size_t i = 0; i < functionCallExpression->argsExpression.size(); ++i) {
+                auto& argExpression = functionCallExpression->argsExpression[i];
+                auto function = functionCallExpression->function;
+                if (function && function->headerScope.variableDeclarations[i]->parameterMode == ParameterMode::Ref) {
+                    if (auto variableDeclaration = QueryAssignedVariable(*argExpression)) {
+                        if (m_collectAssignments) {
+                            m_assignedVariables.insert(variableDeclaration);
+                        }
+                        continue;
+                    }
+                }
+                FoldExpression(argExpression);
+            }
+            return std::nullopt;
+        } else if (auto indexExpression = dynamic_cast<IndexExpression*>(expression.get())) {
+            FoldExpression(indexExpression->arrayExpression);
+            FoldExpression(indexExpression->indexExpression);
+            return std::nullopt;
+        } else if (auto memberExpression = dynamic_cast<MemberExpression*>(expression.get())) {
+            FoldExpression(memberExpression->objectExpression);
+            return std::nullopt;
+        } else if (auto sliceExpression = dynamic_cast<SliceExpression*>(expression.get())) {
+            FoldExpression(sliceExpression->arrayExpression);
+            if (sliceExpression->beginExpression) {
+                FoldExpression(sliceExpression->beginExpression);
+            }
+            if (sliceExpression->endExpression) {
+                FoldExpression(sliceExpression->endExpression);
+            }
+            return std::nullopt;
+        } else if (auto arrayLiteralExpression = dynamic_cast<ArrayLiteralExpression*>(expression.get())) {
+            for (auto& elementExpression : arrayLiteralExpression->elementsExpression) {
+                FoldExpression(elementExpression);
+            }
+            return std::nullopt;
+        } else if (auto spawnExpression = dynamic_cast<SpawnExpression*>(expression.get())) {
+            FoldExpression(spawnExpression->callExpression);
+            return std::nullopt;
+        } else if (auto awaitExpression = dynamic_cast<AwaitExpression*>(expression.get())) {
+            FoldExpression(awaitExpression->oprand);
+            return std::nullopt;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    std::optional<Constant> FoldUnaryExpression(std::unique_ptr<Expression>& expression, UnaryExpression& unaryExpression)
+    {
+        auto oprand = FoldExpression(unaryExpression.oprand);
+        if (!oprand) {
+            return std::nullopt;
+        }
+
+        switch (unaryExpression.op) {
+        case UnaryOp::Bracket:
+            // Only a literal can lose its brackets. Bools and small `long` values are not replaced by
+            // literals, so their expressions keep the brackets.
+            if (!m_collectAssignments && IsLiteral(*unaryExpression.oprand)) {
+                auto folded = std::move(unaryExpression.oprand);
+                expression = std::move(folded);
+            }
+            return oprand;
+
+        case UnaryOp::Minus: {
+            auto type = oprand->type == ConstantType::Bool ? ConstantType::Int : oprand->type;
+            auto result = Constant { -oprand->value, type };
+            if (oprand->value == std::numeric_limits<int64_t>::min() || !IsInRange(result, type)) {
+                return std::nullopt;
+            }
+            ReplaceWithLiteral(expression, result);
+            return result;
+        }
+
+        default:
+            return std::nullopt;
+        }
+    }
+
+    std::optional<Constant> FoldBinaryExpression(std::unique_ptr<Expression>& expression, BinaryExpression& binaryExpression)
+    {
+        if (binaryExpression.op <= BinaryOp::BitOrAssignment) {
+            // Assignment operators come first in `BinaryOp`, only the assigned value can be folded.
+            auto variableDeclaration = QueryAssignedVariable(*binaryExpression.leftOprand);
+            if (m_collectAssignments && variableDeclaration) {
+                m_assignedVariables.insert(variableDeclaration);
+            } else if (!variableDeclaration) {
+                // An element is assigned through its array, e.g. `a[i] = 0;`, its index is folded.
+                FoldExpression(binaryExpression.leftOprand);
+            }
+            FoldExpression(binaryExpression.rightOprand);
+            return std::nullopt;
+        }
+
+        auto left = FoldExpression(binaryExpression.leftOprand);
+        auto right = FoldExpression(binaryExpression.rightOprand);
+        if (!left || !right) {
+            return std::nullopt;
+        }
+
+        // Usual arithmetic conversions: bool promotes to int, int converts to long.
+        auto type = std::max({ left->type, right->type, ConstantType::Int });
+        auto l = left->value;
+        auto r = right->value;
+
+        auto result = Constant { 0, type };
+        switch (binaryExpression.op) {
+        case BinaryOp::Mul:
+            if (__builtin_mul_overflow(l, r, &result.value)) {
+                return std::nullopt;
+            }
+            break;
+        case BinaryOp::Div:
+        case BinaryOp::Mod:
+            if (r == 0 || (r == -1 && l == MinValue(type))) {
+                return std::nullopt;
+            }
+            result.value = binaryExpression.op == BinaryOp::Div ? l / r : l % r;
+            break;
+        case BinaryOp::Add:
+            if (__builtin_add_overflow(l, r, &result.value)) {
+                return std::nullopt;
+            }
+            break;
+        case BinaryOp::Sub:
+            if (__builtin_sub_overflow(l, r, &result.value)) {
+                return std::nullopt;
+            }
+            break;
+
+        case BinaryOp::Equal:
+            return Constant { l == r, ConstantType::Bool };
+        case BinaryOp::NotEqual:
+            return Constant { l != r, ConstantType::Bool };
+        case BinaryOp::Less:
+            return Constant { l < r, ConstantType::Bool };
+        case BinaryOp::LessEqual:
+            return Constant { l <= r, ConstantType::Bool };
+        case BinaryOp::Greater:
+            return Constant { l > r, ConstantType::Bool };
+        case BinaryOp::GreaterEqual:
+            return Constant { l >= r, ConstantType::Bool };
+
+        default:
+            return std::nullopt;
+        }
+
+        if (!IsInRange(result, type)) {
+            return std::nullopt;
+        }
+        ReplaceWithLiteral(expression, result);
+        return result;
+    }
+
+    void ReplaceWithLiteral(std::unique_ptr<Expression>& expression, const Constant& constant)
+    {
+        // A literal must have the same C++ type as the expression it replaces, so small `long`
+        // values are not replaced. They are still returned to allow folding of the outer expression.
+        if (m_collectAssignments || constant.type == ConstantType::Bool) {
+            return;
+        }
+        if (constant.type == ConstantType::Long && IsInRange(constant, ConstantType::Int)) {
+            return;
+        }
+        expression = MakeLiteralExpression(expression->sourceRange, constant);
+    }
+
+    std::unique_ptr<Expression> MakeLiteralExpression(const SourceRange& sourceRange, const Constant& constant)
+    {
+        // Negative literals are spelled as negated positive literals, whose type is the same as long
+        // as the minimum value is excluded, see `IsInRange`.
+        if (constant.value < 0) {
+            return std::make_unique<UnaryExpression>(sourceRange, UnaryOp::Minus, std::make_unique<IntegerLiteralExpression>(sourceRange, (uint64_t)-constant.value));
+        } else {
+            return std::make_unique<IntegerLiteralExpression>(sourceRange, (uint64_t)constant.value);
+        }
+    }
+
+    // A literal made by `MakeLiteralExpression`.
+    static bool IsLiteral(const Expression& expression)
+    {
+        if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(&expression); unaryExpression && unaryExpression->op == UnaryOp::Minus) {
+            return dynamic_cast<const IntegerLiteralExpression*>(unaryExpression->oprand.get()) != nullptr;
+        }
+        return dynamic_cast<const IntegerLiteralExpression*>(&expression) != nullptr;
+    }
+
+    static int64_t MinValue(ConstantType type)
+    {
+        return type == ConstantType::Long ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int32_t>::min();
+    }
+
+    static bool IsInRange(const Constant& constant, ConstantType type)
+    {
+        if (type == ConstantType::Long) {
+            return constant.value != std::numeric_limits<int64_t>::min();
+        } else {
+            return constant.value > std::numeric_limits<int32_t>::min() && constant.value <= std::numeric_limits<int32_t>::max();
+        }
+    }
+
+    VariableDeclaration* QueryVariable(const std::string& name) const
+    {
+        for (auto it = m_variables.rbegin(); it != m_variables.rend(); ++it) {
+            if (auto variable = it->find(name); variable != it->end()) {
+                return variable->second;
+            }
+        }
+        return nullptr;
+    }
+
+    VariableDeclaration* QueryAssignedVariable(const Expression& expression) const
+    {
+        if (auto identifierExpression = dynamic_cast<const IdentifierExpression*>(&expression)) {
+            return QueryVariable(identifierExpression->fullName);
+        } else if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(&expression); unaryExpression && unaryExpression->op == UnaryOp::Bracket) {
+            return QueryAssignedVariable(*unaryExpression->oprand);
+        } else {
+            return nullptr;
+        }
+    }
+
+    bool m_collectAssignments {};
+    std::vector<std::unordered_map<std::string, VariableDeclaration*>> m_variables {};
+    std::unordered_set<const VariableDeclaration*> m_assignedVariables {};
+    std::unordered_map<const VariableDeclaration*, int64_t> m_constants {};
+};
+
+}
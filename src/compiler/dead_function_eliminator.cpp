@@ -0,0 +1,29 @@
+module;
+
+#include <string>
+
+import scc.ast;
+
+export module scc.compiler:dead_function_eliminator;
+import :call_graph;
+
+namespace scc::compiler {
+
+using namespace ast;
+
+// Removes the functions which are not reachable from the entry point of the compile unit, so they
+// are neither translated nor compiled by clang.
+export struct DeadFunctionEliminator final {
+    void EliminateCompileUnit(Scope& scope)
+    {
+        auto reachable = CallGraph { scope }.GetReachableFunctions();
+        for (auto func : scope.GetFunctions()) {
+            auto funcName = static_cast<FunctionDefinitionStatement*>(func)->name;
+            if (funcName != "main" && !reachable.contains(funcName)) {
+                scope.RemoveFunction(funcName);
+            }
+        }
+    }
+};
+
+}
@@ -0,0 +1,320 @@
+module;
+
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+import scc.ir;
+
+export module scc.compiler:evaluator;
+import :format_string;
+
+namespace scc::compiler {
+
+export struct ProgramOutput final {
+    std::string text {};
+    int exitCode {};
+};
+
+// Runs the IR at compile time and returns what the program writes, so the program can be replaced
+// by one which only prints it. The IR can't read any input, and every function it calls must be
+// defined in the compile unit or be `std::print`/`std::println`, so the output is always the same.
+//
+// Anything which would make the output differ from running the compiled program, e.g. undefined
+// behavior, a call into another library or a program which doesn't finish in time, throws a
+// `std::runtime_error` telling why.
+export struct Evaluator final {
+    static constexpr uint64_t s_defaultMaxSteps = 100'000'000;
+    static constexpr int s_maxCallDepth = 4096;
+    static constexpr size_t s_maxOutputSize = 16 * 1024 * 1024;
+
+    explicit Evaluator(uint64_t maxSteps = s_defaultMaxSteps)
+        : m_maxSteps { maxSteps }
+    {
+    }
+
+    ProgramOutput EvaluateProgram(const ir::Program& program)
+    {
+        for (const auto& function : program.functions) {
+            m_functions[function->name] = function.get();
+        }
+
+        auto it = m_functions.find("main");
+        if (it == m_functions.end()) {
+            throw std::runtime_error { "the program has no 'main' function" };
+        }
+
+        auto exitCode = CallFunction(*it->second, {}).integer;
+        return { std::move(m_output), static_cast<int>(exitCode) };
+    }
+
+private:
+    struct Slot final {
+        int64_t integer {};
+        const std::string* string {};
+    };
+
+    using Frame = std::unordered_map<const ir::Value*, Slot>;
+
+    Slot CallFunction(const ir::Function& function, const std::vector<Slot>& args)
+    {
+        if (++m_callDepth > s_maxCallDepth) {
+            throw std::runtime_error { std::format("the calls are nested deeper than {} levels", s_maxCallDepth) };
+        }
+
+        auto frame = Frame {};
+        for (size_t i = 0; i < function.arguments.size(); ++i) {
+            frame[function.arguments[i].get()] = args[i];
+        }
+
+        const ir::BasicBlock* previous = nullptr;
+        auto block = function.GetEntryBlock();
+        for (;;) {
+            // All phis of the block take their values at once.
+            auto it = block->instructions.begin();
+            auto phis = std::vector<std::pair<const ir::Instruction*, Slot>> {};
+            for (; it != block->instructions.end() && (*it)->opcode == ir::Opcode::Phi; ++it) {
+                const auto& phi = **it;
+                for (size_t i = 0; i < phi.blocks.size(); ++i) {
+                    if (phi.blocks[i] == previous) {
+                        phis.emplace_back(&phi, GetOperand(frame, phi, i));
+                    }
+                }
+            }
+            for (const auto& [phi, slot] : phis) {
+                frame[phi] = slot;
+            }
+
+            const ir::BasicBlock* next = nullptr;
+            for (; it != block->instructions.end() && !next; ++it) {
+                const auto& instruction = **it;
+                if (++m_steps > m_maxSteps) {
+                    throw std::runtime_error { std::format("the program doesn't finish within {} steps", m_maxSteps) };
+                }
+
+                switch (instruction.opcode) {
+                case ir::Opcode::Branch:
+                    next = instruction.blocks[0];
+                    break;
+
+                case ir::Opcode::CondBranch:
+                    next = instruction.blocks[GetOperand(frame, instruction, 0).integer ? 0 : 1];
+                    break;
+
+                case ir::Opcode::Return:
+                    --m_callDepth;
+                    return instruction.operands.empty() ? Slot {} : GetOperand(frame, instruction, 0);
+
+                case ir::Opcode::Call:
+                    frame[&instruction] = Call(frame, instruction);
+                    break;
+
+                case ir::Opcode::Convert:
+                    frame[&instruction] = { Convert(GetOperand(frame, instruction, 0).integer, instruction.type) };
+                    break;
+
+                default:
+                    frame[&instruction] = { Compute(frame, instruction) };
+                    break;
+                }
+            }
+
+            if (!next) {
+                throw std::runtime_error { std::format("block '{}' of function '{}' has no terminator", block->id, function.name) };
+            }
+            previous = block;
+            block = next;
+        }
+    }
+
+    Slot Call(const Frame& frame, const ir::Instruction& call)
+    {
+        auto args = std::vector<Slot> {};
+        for (size_t i = 0; i < call.operands.size(); ++i) {
+            args.push_back(GetOperand(frame, call, i));
+        }
+
+        if (auto it = m_functions.find(call.callee); it != m_functions.end()) {
+            return CallFunction(*it->second, args);
+        }
+
+        if (call.callee != "std::print" && call.callee != "std::println") {
+            throw std::runtime_error { std::format("call to '{}' can't be evaluated at compile time", call.callee) };
+        }
+
+        if (!args.empty()) {
+            if (!args[0].string) {
+                throw std::runtime_error { std::format("the format of '{}' is not a string", call.callee) };
+            }
+            m_output += Format(*args[0].string, call, args);
+        }
+        if (call.callee == "std::println") {
+            m_output += '\n';
+        }
+
+        if (m_output.size() > s_maxOutputSize) {
+            throw std::runtime_error { std::format("the output is larger than {} bytes", s_maxOutputSize) };
+        }
+        return {};
+    }
+
+    // Formats like `std::format`, one replacement field at a time, because the arguments are only
+    // known at compile time of scc.
+    static std::string Format(std::string_view format, const ir::Instruction& call, const std::vector<Slot>& args)
+    {
+        auto result = std::string {};
+        for (const auto& piece : ParseFormatString(format, args.size() - 1)) {
+            if (piece.HasNestedFields()) {
+                throw std::runtime_error { "format specs with nested fields are only known at run time" };
+            } else if (piece.IsField()) {
+                auto arg = piece.argIndex + 1;
+                result += FormatArgument(std::format("{{:{}}}", piece.spec), call.operands[arg]->type, args[arg]);
+            } else {
+                result += piece.text;
+            }
+        }
+        return result;
+    }
+
+    static std::string FormatArgument(const std::string& replacementField, ir::Type type, const Slot& arg)
+    {
+        switch (type) {
+        case ir::Type::Bool: {
+            auto value = arg.integer != 0;
+            return std::vformat(replacementField, std::make_format_args(value));
+        }
+
+        case ir::Type::Int: {
+            auto value = static_cast<int32_t>(arg.integer);
+            return std::vformat(replacementField, std::make_format_args(value));
+        }
+
+        case ir::Type::Long: {
+            auto value = arg.integer;
+            return std::vformat(replacementField, std::make_format_args(value));
+        }
+
+        case ir::Type::String: {
+            auto value = std::string_view { *arg.string };
+            return std::vformat(replacementField, std::make_format_args(value));
+        }
+
+        default:
+            throw std::runtime_error { "a void value is printed" };
+        }
+    }
+
+    static int64_t Compute(const Frame& frame, const ir::Instruction& instruction)
+    {
+        auto left = GetOperand(frame, instruction, 0).integer;
+        auto right = instruction.operands.size() > 1 ? GetOperand(frame, instruction, 1).integer : 0;
+        auto result = int64_t {};
+        auto overflow = false;
+
+        switch (instruction.opcode) {
+        case ir::Opcode::Neg:
+            overflow = __builtin_sub_overflow(int64_t { 0 }, left, &result);
+            break;
+        case ir::Opcode::Mul:
+            overflow = __builtin_mul_overflow(left, right, &result);
+            break;
+        case ir::Opcode::Add:
+            overflow = __builtin_add_overflow(left, right, &result);
+            break;
+        case ir::Opcode::Sub:
+            overflow = __builtin_sub_overflow(left, right, &result);
+            break;
+
+        case ir::Opcode::Div:
+        case ir::Opcode::Mod: {
+            if (right == 0) {
+                throw std::runtime_error { "division by zero" };
+            }
+            auto quotient = int64_t {};
+            if (right == -1) {
+                overflow = __builtin_sub_overflow(int64_t { 0 }, left, &quotient);
+            } else {
+                quotient = left / right;
+            }
+            overflow = overflow || Convert(quotient, instruction.type) != quotient;
+            result = instruction.opcode == ir::Opcode::Div ? quotient : (right == -1 ? 0 : left % right);
+            break;
+        }
+
+        case ir::Opcode::ShiftLeft:
+        case ir::Opcode::ShiftRight:
+            if (right < 0 || right >= (instruction.type == ir::Type::Long ? 64 : 32)) {
+                throw std::runtime_error { std::format("shift count {} is out of range", right) };
+            }
+            // Shifts are defined for negative values since C++20.
+            return Convert(instruction.opcode == ir::Opcode::ShiftLeft ? static_cast<int64_t>(static_cast<uint64_t>(left) << right) : left >> right, instruction.type);
+
+        case ir::Opcode::BitAnd:
+            return left & right;
+        case ir::Opcode::BitXor:
+            return left ^ right;
+        case ir::Opcode::BitOr:
+            return left | right;
+
+        case ir::Opcode::Equal:
+            return left == right;
+        case ir::Opcode::NotEqual:
+            return left != right;
+        case ir::Opcode::Less:
+            return left < right;
+        case ir::Opcode::LessEqual:
+            return left <= right;
+        case ir::Opcode::Greater:
+            return left > right;
+        case ir::Opcode::GreaterEqual:
+            return left >= right;
+
+        default:
+            throw std::runtime_error { std::format("instruction '{}' can't be evaluated", ir::GetOpcodeName(instruction.opcode)) };
+        }
+
+        auto converted = Convert(result, instruction.type);
+        if ((overflow || converted != result) && !instruction.wraps) {
+            throw std::runtime_error { std::format("signed integer overflow in '{}'", ir::GetOpcodeName(instruction.opcode)) };
+        }
+        return converted;
+    }
+
+    // Converts like C++, where narrowing an integer keeps the low bits since C++20.
+    static int64_t Convert(int64_t value, ir::Type type)
+    {
+        switch (type) {
+        case ir::Type::Bool:
+            return value != 0;
+        case ir::Type::Int:
+            return static_cast<int32_t>(value);
+        default:
+            return value;
+        }
+    }
+
+    static Slot GetOperand(const Frame& frame, const ir::Instruction& instruction, size_t index)
+    {
+        auto operand = instruction.operands[index];
+        if (auto constant = dynamic_cast<const ir::Constant*>(operand)) {
+            return { constant->value };
+        } else if (auto stringConstant = dynamic_cast<const ir::StringConstant*>(operand)) {
+            return { 0, &stringConstant->value };
+        } else {
+            return frame.at(operand);
+        }
+    }
+
+    uint64_t m_maxSteps {};
+    uint64_t m_steps {};
+    int m_callDepth {};
+    std::string m_output {};
+    std::unordered_map<std::string, const ir::Function*> m_functions {};
+};
+
+}
\ No newline at end of file
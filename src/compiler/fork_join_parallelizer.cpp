@@ -0,0 +1,45 @@
+module;
+
+#include <algorithm>
+
+import scc.ast;
+
+export module scc.compiler:fork_join_parallelizer;
+import :call_graph;
+import :purity_analysis;
+
+namespace scc::compiler {
+
+using namespace ast;
+
+// Marks the recursive functions without side effects, so the translator evaluates the independent
+// calls in their binary expressions in parallel, e.g. `fib(n - 1) + fib(n - 2)`. Those are emitted
+// as `scc::std::fork_join`, which runs them on the work-stealing scheduler of `scc.std` and falls
+// back to sequential calls below a fork depth.
+export struct ForkJoinParallelizer final {
+    void ParallelizeCompileUnit(Scope& scope)
+    {
+        auto functions = scope.GetFunctions();
+
+        // Memoized functions already skip the repeated calls, and the tasks would each fill the
+        // table of their own thread.
+        auto isMemoized = [](auto func) { return static_cast<FunctionDefinitionStatement*>(func)->HasAttribute("memo"); };
+        if (std::ranges::any_of(functions, isMemoized)) {
+            return;
+        }
+
+        auto callGraph = CallGraph { scope };
+        auto purityAnalysis = PurityAnalysis { scope };
+        for (auto func : functions) {
+            auto& functionDefinitionStatement = *static_cast<FunctionDefinitionStatement*>(func);
+            const auto& name = functionDefinitionStatement.name;
+            // Compile-time functions can't start tasks.
+            auto isRunTime = functionDefinitionStatement.constness == Constness::None;
+            if (purityAnalysis.GetPurity(name) != Purity::Impure && callGraph.IsRecursive(name) && isRunTime) {
+                functionDefinitionStatement.attributes.push_back("fork_join");
+            }
+        }
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+module;
+
+#include <charconv>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module scc.compiler:format_string;
+
+namespace scc::compiler {
+
+export struct FormatPiece final {
+    // Text written as is, when `argIndex` is negative.
+    std::string text {};
+
+    int argIndex { -1 };
+
+    // Format spec of the replacement field after the ':', e.g. '>4' for `{:>4}`.
+    std::string spec {};
+
+    bool IsField() const
+    {
+        return argIndex >= 0;
+    }
+
+    // The width or precision of the spec is another argument, e.g. `{:{}}`, so the spec is only
+    // known at run time.
+    bool HasNestedFields() const
+    {
+        return spec.find('{') != std::string::npos;
+    }
+};
+
+// Splits a `std::format` string into its text and replacement fields, with the same checks
+// `std::format_string` does when it is constructed, except the format specs which depend on the
+// types of the arguments. The indexes of nested fields, e.g. the width of `{:{}}`, are checked
+// too, and the spec keeps them. Throws `std::format_error` if the format string is invalid.
+export std::vector<FormatPiece> ParseFormatString(std::string_view format, size_t argCount)
+{
+    auto pieces = std::vector<FormatPiece> {};
+    auto appendText = [&pieces](char ch) {
+        if (pieces.empty() || pieces.back().IsField()) {
+            pieces.emplace_back();
+        }
+        pieces.back().text += ch;
+    };
+
+    auto nextArg = 0;
+    auto manualIndexing = false;
+    auto takeArgIndex = [&](std::string_view index) {
+        auto argIndex = 0;
+        if (index.empty()) {
+            if (manualIndexing) {
+                throw std::format_error { "cannot switch from manual to automatic argument indexing" };
+            }
+            argIndex = nextArg++;
+        } else {
+            if (nextArg > 0) {
+                throw std::format_error { "cannot switch from automatic to manual argument indexing" };
+            }
+            if (std::from_chars(index.data(), index.data() + index.size(), argIndex).ptr != index.data() + index.size() || argIndex < 0) {
+                throw std::format_error { "invalid argument index in format string" };
+            }
+            manualIndexing = true;
+        }
+        if (static_cast<size_t>(argIndex) >= argCount) {
+            throw std::format_error { "argument index out of range" };
+        }
+        return argIndex;
+    };
+    for (size_t i = 0; i < format.size(); ++i) {
+        if (format[i] == '}') {
+            if (i + 1 == format.size() || format[i + 1] != '}') {
+                throw std::format_error { "unmatched '}' in format string" };
+            }
+            appendText('}');
+            ++i;
+            continue;
+        }
+        if (format[i] != '{') {
+            appendText(format[i]);
+            continue;
+        }
+        if (i + 1 < format.size() && format[i + 1] == '{') {
+            appendText('{');
+            ++i;
+            continue;
+        }
+
+        // The field ends at the first '}' which doesn't close a nested field of its spec.
+        auto end = i + 1;
+        for (auto nested = false; end < format.size() && (format[end] != '}' || nested); ++end) {
+            nested = format[end] == '{' || (nested && format[end] != '}');
+        }
+        if (end == format.size()) {
+            throw std::format_error { "unmatched '{' in format string" };
+        }
+        auto field = format.substr(i + 1, end - i - 1);
+        auto colon = field.find(':');
+        auto index = field.substr(0, colon);
+        auto spec = colon == std::string_view::npos ? std::string_view {} : field.substr(colon + 1);
+        if (index.find('{') != std::string_view::npos) {
+            throw std::format_error { "invalid argument index in format string" };
+        }
+
+        auto argIndex = takeArgIndex(index);
+        pieces.push_back({ "", argIndex, std::string { spec } });
+
+        // The arguments of the nested fields come after the argument of the field.
+        for (auto nestedStart = spec.find('{'); nestedStart != std::string_view::npos; nestedStart = spec.find('{', nestedStart)) {
+            auto nestedEnd = spec.find('}', nestedStart);
+            takeArgIndex(spec.substr(nestedStart + 1, nestedEnd - nestedStart - 1));
+            nestedStart = nestedEnd;
+        }
+        i = end;
+    }
+    return pieces;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,655 @@
+module;
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+import scc.ast;
+import scc.ir;
+
+export module scc.compiler:ir_lowering;
+import :exception;
+import :format_string;
+
+namespace scc::compiler {
+
+using namespace ast;
+
+// Lowers the AST of a compile unit into the SSA IR. Local variables are turned into SSA values
+// directly while lowering, with the algorithm from Braun et al., "Simple and Efficient
+// Construction of Static Single Assignment Form".
+//
+// Constructs which the IR can't express yet throw an `Exception`, the caller is expected to fall
+// back to the `Translator`.
+export struct IrLowering final {
+    std::unique_ptr<ir::Program> LowerCompileUnit(const Scope& scope)
+    {
+        auto program = std::make_unique<ir::Program>();
+
+        for (auto func : scope.GetFunctions()) {
+            const auto& functionDefinitionStatement = *static_cast<const FunctionDefinitionStatement*>(func);
+            m_functionTypes[functionDefinitionStatement.name] = GetFunctionReturnType(functionDefinitionStatement);
+        }
+
+        for (auto func : scope.GetFunctions()) {
+            program->functions.push_back(LowerFunction(*static_cast<const FunctionDefinitionStatement*>(func)));
+        }
+
+        if (!m_functionTypes.contains("main")) {
+            // The global statements are the body of 'main'.
+            auto function = std::make_unique<ir::Function>("main", ir::Type::Int);
+            BeginFunction(*function);
+            LowerScope(scope);
+            EndFunction();
+            program->functions.push_back(std::move(function));
+        }
+
+        return program;
+    }
+
+private:
+    std::unique_ptr<ir::Function> LowerFunction(const FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        if (!functionDefinitionStatement.attributes.empty()) {
+            throw Exception { functionDefinitionStatement.sourceRange, "function attributes are not supported by the IR" };
+        }
+        if (functionDefinitionStatement.constness != Constness::None) {
+            throw Exception { functionDefinitionStatement.sourceRange, "compile-time functions are not supported by the IR" };
+        }
+        if (functionDefinitionStatement.name.find('<') != std::string::npos) {
+            throw Exception { functionDefinitionStatement.sourceRange, "instances of generic functions are not supported by the IR" };
+        }
+
+        auto function = std::make_unique<ir::Function>(functionDefinitionStatement.name, m_functionTypes[functionDefinitionStatement.name]);
+        BeginFunction(*function);
+
+        m_variables.emplace_back();
+        for (const auto& variableDeclaration : functionDefinitionStatement.headerScope.variableDeclarations) {
+            if (variableDeclaration->parameterMode == ParameterMode::Ref) {
+                throw Exception { variableDeclaration->sourceRange, "'ref' parameters are not supported by the IR" };
+            }
+            function->arguments.push_back(std::make_unique<ir::Argument>(GetType(variableDeclaration->typeInfo, variableDeclaration->sourceRange), variableDeclaration->name));
+            m_variables.back()[variableDeclaration->name] = variableDeclaration.get();
+            WriteVariable(variableDeclaration.get(), m_block, function->arguments.back().get());
+        }
+        LowerScope(functionDefinitionStatement.bodyScope);
+        m_variables.pop_back();
+
+        EndFunction();
+        return function;
+    }
+
+    void BeginFunction(ir::Function& function)
+    {
+        m_function = &function;
+        m_block = function.CreateBlock();
+        m_sealedBlocks.insert(m_block);
+    }
+
+    void EndFunction()
+    {
+        if (!m_block->GetTerminator()) {
+            // Falling off the end returns 0 from 'main', and a value-initialized result otherwise.
+            auto returnValue = std::vector<ir::Value*> {};
+            if (m_function->name == "main") {
+                returnValue.push_back(m_function->GetConstant(ir::Type::Int, 0));
+            }
+            m_block->Append(std::make_unique<ir::Instruction>(ir::Opcode::Return, ir::Type::Void, std::move(returnValue)));
+        }
+
+        m_function->RemoveUnreachableBlocks();
+        RemoveTrivialPhis();
+        m_function->Renumber();
+
+        m_currentDefinitions.clear();
+        m_sealedBlocks.clear();
+        m_incompletePhis.clear();
+        m_breakTargets.clear();
+        m_continueTargets.clear();
+        m_function = nullptr;
+        m_block = nullptr;
+    }
+
+    void LowerScope(const Scope& scope)
+    {
+        m_variables.emplace_back();
+        for (const auto& statement : scope.statements) {
+            LowerStatement(*statement);
+        }
+        m_variables.pop_back();
+    }
+
+    void LowerStatement(const Statement& statement)
+    {
+        if (auto variableDefinitionStatement = dynamic_cast<const VariableDefinitionStatement*>(&statement)) {
+            const auto& variableDeclaration = variableDefinitionStatement->variableDeclaration;
+            if (variableDeclaration.constness == Constness::Constexpr) {
+                throw Exception { variableDeclaration.sourceRange, "constexpr variables are not supported by the IR" };
+            }
+            auto type = GetType(variableDeclaration.typeInfo, variableDeclaration.sourceRange);
+            auto value = variableDeclaration.initExpression
+                ? Convert(LowerExpression(*variableDeclaration.initExpression), type)
+                : m_function->GetConstant(type, 0);
+            m_variables.back()[variableDeclaration.name] = &variableDeclaration;
+            WriteVariable(&variableDeclaration, m_block, value);
+        } else if (auto expressionStatement = dynamic_cast<const ExpressionStatement*>(&statement)) {
+            LowerExpression(*expressionStatement->expression, /*allowVoid=*/true);
+        } else if (auto returnStatement = dynamic_cast<const ReturnStatement*>(&statement)) {
+            auto returnValue = std::vector<ir::Value*> {};
+            if (returnStatement->expression) {
+                returnValue.push_back(Convert(LowerExpression(*returnStatement->expression), m_function->returnType));
+            }
+            m_block->Append(std::make_unique<ir::Instruction>(ir::Opcode::Return, ir::Type::Void, std::move(returnValue)));
+            StartUnreachableBlock();
+        } else if (auto conditionalStatement = dynamic_cast<const ConditionalStatement*>(&statement)) {
+            LowerConditionalStatement(*conditionalStatement);
+        } else if (auto switchStatement = dynamic_cast<const SwitchStatement*>(&statement)) {
+            LowerSwitchStatement(*switchStatement);
+        } else if (auto forLoopStatement = dynamic_cast<const ForLoopStatement*>(&statement)) {
+            LowerForLoopStatement(*forLoopStatement);
+        } else if (dynamic_cast<const BreakStatement*>(&statement)) {
+            if (m_breakTargets.empty()) {
+                throw Exception { statement.sourceRange, "'break' statement not in loop statement" };
+            }
+            AddBranch(m_breakTargets.back());
+            StartUnreachableBlock();
+        } else if (dynamic_cast<const ContinueStatement*>(&statement)) {
+            if (m_continueTargets.empty()) {
+                throw Exception { statement.sourceRange, "'continue' statement not in loop statement" };
+            }
+            AddBranch(m_continueTargets.back());
+            StartUnreachableBlock();
+        } else {
+            throw Exception { statement.sourceRange, "statement is not supported by the IR" };
+        }
+    }
+
+    void LowerConditionalStatement(const ConditionalStatement& conditionalStatement)
+    {
+        auto condition = LowerExpression(*conditionalStatement.conditionalExpression);
+        auto trueBlock = m_function->CreateBlock();
+        auto falseBlock = m_function->CreateBlock();
+        auto joinBlock = m_function->CreateBlock();
+        AddCondBranch(condition, trueBlock, falseBlock);
+        SealBlock(trueBlock);
+        SealBlock(falseBlock);
+
+        m_block = trueBlock;
+        LowerScope(conditionalStatement.trueScope);
+        AddBranch(joinBlock);
+
+        m_block = falseBlock;
+        LowerScope(conditionalStatement.falseScope);
+        AddBranch(joinBlock);
+
+        SealBlock(joinBlock);
+        m_block = joinBlock;
+    }
+
+    // The IR has no multiway branch, the condition is compared with every case value in turn. The
+    // C++ compiler turns the comparisons back into a jump table where it pays off.
+    void LowerSwitchStatement(const SwitchStatement& switchStatement)
+    {
+        auto condition = LowerArithmeticOprand(*switchStatement.conditionalExpression);
+        condition = Convert(condition, std::max(condition->type, ir::Type::Int));
+        auto joinBlock = m_function->CreateBlock();
+
+        const SwitchCase* defaultCase {};
+        for (const auto& switchCase : switchStatement.cases) {
+            if (switchCase.values.empty()) {
+                defaultCase = &switchCase;
+                continue;
+            }
+
+            auto caseBlock = m_function->CreateBlock();
+            for (const auto& caseValue : switchCase.values) {
+                auto nextBlock = m_function->CreateBlock();
+                auto equal = Append(ir::Opcode::Equal, ir::Type::Bool, { condition, m_function->GetConstant(condition->type, caseValue.value) });
+                AddCondBranch(equal, caseBlock, nextBlock);
+                SealBlock(nextBlock);
+                m_block = nextBlock;
+            }
+            SealBlock(caseBlock);
+
+            auto nextBlock = m_block;
+            m_block = caseBlock;
+            LowerScope(switchCase.scope);
+            AddBranch(joinBlock);
+            m_block = nextBlock;
+        }
+
+        // No case has the value.
+        if (defaultCase) {
+            LowerScope(defaultCase->scope);
+        }
+        AddBranch(joinBlock);
+
+        SealBlock(joinBlock);
+        m_block = joinBlock;
+    }
+
+    void LowerForLoopStatement(const ForLoopStatement& forLoopStatement)
+    {
+        if (forLoopStatement.isParallel) {
+            throw Exception { forLoopStatement.sourceRange, "parallel for loops are not supported by the IR" };
+        }
+        m_variables.emplace_back();
+        for (const auto& statement : forLoopStatement.initScope.statements) {
+            LowerStatement(*statement);
+        }
+
+        // The current block is the preheader, the header is sealed once the latch branches back.
+        auto headerBlock = m_function->CreateBlock();
+        auto bodyBlock = m_function->CreateBlock();
+        auto latchBlock = m_function->CreateBlock();
+        auto exitBlock = m_function->CreateBlock();
+        AddBranch(headerBlock);
+
+        m_block = headerBlock;
+        if (forLoopStatement.conditionalExpression) {
+            AddCondBranch(LowerExpression(*forLoopStatement.conditionalExpression), bodyBlock, exitBlock);
+        } else {
+            AddBranch(bodyBlock);
+        }
+        SealBlock(bodyBlock);
+
+        m_block = bodyBlock;
+        m_breakTargets.push_back(exitBlock);
+        m_continueTargets.push_back(latchBlock);
+        LowerScope(forLoopStatement.bodyScope);
+        m_continueTargets.pop_back();
+        m_breakTargets.pop_back();
+        AddBranch(latchBlock);
+        SealBlock(latchBlock);
+
+        m_block = latchBlock;
+        if (forLoopStatement.iterationExpression) {
+            LowerExpression(*forLoopStatement.iterationExpression, /*allowVoid=*/true);
+        }
+        AddBranch(headerBlock);
+        SealBlock(headerBlock);
+
+        SealBlock(exitBlock);
+        m_block = exitBlock;
+        m_variables.pop_back();
+    }
+
+    ir::Value* LowerExpression(const Expression& expression, bool allowVoid = false)
+    {
+        auto value = LowerExpressionImpl(expression);
+        if (value->type == ir::Type::Void && !allowVoid) {
+            throw Exception { expression.sourceRange, "void value is used in the expression" };
+        }
+        return value;
+    }
+
+    ir::Value* LowerArithmeticOprand(const Expression& expression)
+    {
+        auto value = LowerExpression(expression);
+        if (value->type == ir::Type::String) {
+            throw Exception { expression.sourceRange, "invalid operand to arithmetic expression" };
+        }
+        return value;
+    }
+
+    ir::Value* LowerExpressionImpl(const Expression& expression)
+    {
+        if (expression.typeInfo && (expression.typeInfo->kind == TypeKind::Simd || expression.typeInfo->kind == TypeKind::Mask)) {
+            throw Exception { expression.sourceRange, "SIMD values are not supported by the IR" };
+        }
+        if (auto integerLiteralExpression = dynamic_cast<const IntegerLiteralExpression*>(&expression)) {
+            if (integerLiteralExpression->value <= std::numeric_limits<int32_t>::max()) {
+                return m_function->GetConstant(ir::Type::Int, (int64_t)integerLiteralExpression->value);
+            } else if (integerLiteralExpression->value <= std::numeric_limits<int64_t>::max()) {
+                return m_function->GetConstant(ir::Type::Long, (int64_t)integerLiteralExpression->value);
+            } else {
+                throw Exception { expression.sourceRange, "integer literal is too large" };
+            }
+        } else if (auto stringLiteralExpression = dynamic_cast<const StringLiteralExpression*>(&expression)) {
+            return m_function->GetStringConstant(stringLiteralExpression->value);
+        } else if (auto identifierExpression = dynamic_cast<const IdentifierExpression*>(&expression)) {
+            return ReadVariable(QueryVariable(*identifierExpression), m_block);
+        } else if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(&expression)) {
+            if (unaryExpression->op == UnaryOp::Bracket) {
+                return LowerExpression(*unaryExpression->oprand);
+            }
+            auto oprand = LowerArithmeticOprand(*unaryExpression->oprand);
+            auto type = std::max(oprand->type, ir::Type::Int);
+            return Append(ir::Opcode::Neg, type, { Convert(oprand, type) });
+        } else if (auto binaryExpression = dynamic_cast<const BinaryExpression*>(&expression)) {
+            return LowerBinaryExpression(*binaryExpression);
+        } else if (auto functionCallExpression = dynamic_cast<const FunctionCallExpression*>(&expression)) {
+            return LowerFunctionCallExpression(*functionCallExpression);
+        } else {
+            throw Exception { expression.sourceRange, "expression is not supported by the IR" };
+        }
+    }
+
+    ir::Value* LowerBinaryExpression(const BinaryExpression& binaryExpression)
+    {
+        switch (binaryExpression.op) {
+        case BinaryOp::Assignment:
+        case BinaryOp::MulAssignment:
+        case BinaryOp::DivAssignment:
+        case BinaryOp::ModAssignment:
+        case BinaryOp::AddAssignment:
+        case BinaryOp::SubAssignment:
+        case BinaryOp::ShiftLeftAssignment:
+        case BinaryOp::ShiftRightAssignment:
+        case BinaryOp::BitAndAssignment:
+        case BinaryOp::BitXorAssignment:
+        case BinaryOp::BitOrAssignment: {
+            auto leftOprand = binaryExpression.leftOprand.get();
+            while (auto unaryExpression = dynamic_cast<const UnaryExpression*>(leftOprand)) {
+                if (unaryExpression->op != UnaryOp::Bracket) {
+                    break;
+                }
+                leftOprand = unaryExpression->oprand.get();
+            }
+            auto identifierExpression = dynamic_cast<const IdentifierExpression*>(leftOprand);
+            if (!identifierExpression) {
+                throw Exception { binaryExpression.leftOprand->sourceRange, "expression is not assignable" };
+            }
+
+            auto variableDeclaration = QueryVariable(*identifierExpression);
+            auto type = GetType(variableDeclaration->typeInfo, variableDeclaration->sourceRange);
+            auto value = LowerArithmeticOprand(*binaryExpression.rightOprand);
+            if (binaryExpression.op != BinaryOp::Assignment) {
+                value = LowerArithmetic(GetCompoundOpcode(binaryExpression.op), ReadVariable(variableDeclaration, m_block), value);
+            }
+            value = Convert(value, type);
+            WriteVariable(variableDeclaration, m_block, value);
+            return value;
+        }
+
+        case BinaryOp::Mul:
+            return LowerArithmetic(ir::Opcode::Mul, binaryExpression);
+        case BinaryOp::Div:
+            return LowerArithmetic(ir::Opcode::Div, binaryExpression);
+        case BinaryOp::Mod:
+            return LowerArithmetic(ir::Opcode::Mod, binaryExpression);
+        case BinaryOp::Add:
+            return LowerArithmetic(ir::Opcode::Add, binaryExpression);
+        case BinaryOp::Sub:
+            return LowerArithmetic(ir::Opcode::Sub, binaryExpression);
+
+        case BinaryOp::Equal:
+            return LowerComparison(ir::Opcode::Equal, binaryExpression);
+        case BinaryOp::NotEqual:
+            return LowerComparison(ir::Opcode::NotEqual, binaryExpression);
+        case BinaryOp::Less:
+            return LowerComparison(ir::Opcode::Less, binaryExpression);
+        case BinaryOp::LessEqual:
+            return LowerComparison(ir::Opcode::LessEqual, binaryExpression);
+        case BinaryOp::Greater:
+            return LowerComparison(ir::Opcode::Greater, binaryExpression);
+        case BinaryOp::GreaterEqual:
+            return LowerComparison(ir::Opcode::GreaterEqual, binaryExpression);
+
+        default:
+            throw Exception { binaryExpression.sourceRange, "expression is not supported by the IR" };
+        }
+    }
+
+    ir::Value* LowerArithmetic(ir::Opcode opcode, const BinaryExpression& binaryExpression)
+    {
+        auto leftOprand = LowerArithmeticOprand(*binaryExpression.leftOprand);
+        auto rightOprand = LowerArithmeticOprand(*binaryExpression.rightOprand);
+        return LowerArithmetic(opcode, leftOprand, rightOprand);
+    }
+
+    ir::Value* LowerArithmetic(ir::Opcode opcode, ir::Value* leftOprand, ir::Value* rightOprand)
+    {
+        // Usual arithmetic conversions: bool promotes to int, int converts to long. The result of a
+        // shift has the type of its left operand.
+        auto type = std::max({ leftOprand->type, rightOprand->type, ir::Type::Int });
+        if (opcode == ir::Opcode::ShiftLeft || opcode == ir::Opcode::ShiftRight) {
+            type = std::max(leftOprand->type, ir::Type::Int);
+            return Append(opcode, type, { Convert(leftOprand, type), rightOprand });
+        }
+        return Append(opcode, type, { Convert(leftOprand, type), Convert(rightOprand, type) });
+    }
+
+    ir::Value* LowerComparison(ir::Opcode opcode, const BinaryExpression& binaryExpression)
+    {
+        auto leftOprand = LowerArithmeticOprand(*binaryExpression.leftOprand);
+        auto rightOprand = LowerArithmeticOprand(*binaryExpression.rightOprand);
+        auto type = std::max({ leftOprand->type, rightOprand->type, ir::Type::Int });
+        return Append(opcode, ir::Type::Bool, { Convert(leftOprand, type), Convert(rightOprand, type) });
+    }
+
+    ir::Value* LowerFunctionCallExpression(const FunctionCallExpression& functionCallExpression)
+    {
+        auto identifierExpression = dynamic_cast<const IdentifierExpression*>(functionCallExpression.funcExpression.get());
+        if (!identifierExpression) {
+            throw Exception { functionCallExpression.funcExpression->sourceRange, "called object is not a function" };
+        }
+
+        CheckFormatString(identifierExpression->fullName, functionCallExpression);
+
+        auto args = std::vector<ir::Value*> {};
+        for (const auto& argExpression : functionCallExpression.argsExpression) {
+            args.push_back(LowerExpression(*argExpression));
+        }
+
+        // Functions which are not defined in the compile unit, e.g. from `scc.std`, are assumed
+        // to return nothing.
+        auto it = m_functionTypes.find(identifierExpression->fullName);
+        auto type = it == m_functionTypes.end() ? ir::Type::Void : it->second;
+
+        auto call = std::make_unique<ir::Instruction>(ir::Opcode::Call, type, std::move(args));
+        call->callee = identifierExpression->fullName;
+        return m_block->Append(std::move(call));
+    }
+
+    // The format strings of `std::print` and `std::println` are parsed when the IR is translated,
+    // so report invalid ones here where the source is known.
+    static void CheckFormatString(const std::string& callee, const FunctionCallExpression& functionCallExpression)
+    {
+        if ((callee != "std::print" && callee != "std::println") || functionCallExpression.argsExpression.empty()) {
+            return;
+        }
+        if (auto format = dynamic_cast<const StringLiteralExpression*>(functionCallExpression.argsExpression[0].get())) {
+            try {
+                ParseFormatString(format->value, functionCallExpression.argsExpression.size() - 1);
+            } catch (const std::format_error& ex) {
+                throw Exception { format->sourceRange, "invalid format string: {}", ex.what() };
+            }
+        }
+    }
+
+    static ir::Opcode GetCompoundOpcode(BinaryOp op)
+    {
+        switch (op) {
+        case BinaryOp::MulAssignment:
+            return ir::Opcode::Mul;
+        case BinaryOp::DivAssignment:
+            return ir::Opcode::Div;
+        case BinaryOp::ModAssignment:
+            return ir::Opcode::Mod;
+        case BinaryOp::AddAssignment:
+            return ir::Opcode::Add;
+        case BinaryOp::SubAssignment:
+            return ir::Opcode::Sub;
+        case BinaryOp::ShiftLeftAssignment:
+            return ir::Opcode::ShiftLeft;
+        case BinaryOp::ShiftRightAssignment:
+            return ir::Opcode::ShiftRight;
+        case BinaryOp::BitAndAssignment:
+            return ir::Opcode::BitAnd;
+        case BinaryOp::BitXorAssignment:
+            return ir::Opcode::BitXor;
+        case BinaryOp::BitOrAssignment:
+            return ir::Opcode::BitOr;
+        default:
+            assert(false);
+            return ir::Opcode::Add;
+        }
+    }
+
+    ir::Type GetType(const TypeInfo& typeInfo, const SourceRange& sourceRange)
+    {
+        if (typeInfo.fullName == "int") {
+            return ir::Type::Int;
+        } else if (typeInfo.fullName == "void") {
+            return ir::Type::Void;
+        } else {
+            throw Exception { sourceRange, "type '{}' is not supported by the IR", typeInfo.fullName };
+        }
+    }
+
+    ir::Type GetFunctionReturnType(const FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        // 'main' always returns int in C++.
+        if (functionDefinitionStatement.name == "main") {
+            return ir::Type::Int;
+        }
+        return GetType(functionDefinitionStatement.typeInfo, functionDefinitionStatement.sourceRange);
+    }
+
+    ir::Value* Append(ir::Opcode opcode, ir::Type type, std::vector<ir::Value*> operands)
+    {
+        return m_block->Append(std::make_unique<ir::Instruction>(opcode, type, std::move(operands)));
+    }
+
+    ir::Value* Convert(ir::Value* value, ir::Type type)
+    {
+        if (value->type == type || type == ir::Type::Void) {
+            return value;
+        }
+        return Append(ir::Opcode::Convert, type, { value });
+    }
+
+    void AddBranch(ir::BasicBlock* target)
+    {
+        m_block->Append(std::make_unique<ir::Instruction>(ir::Opcode::Branch, ir::Type::Void, std::vector<ir::Value*> {}, std::vector<ir::BasicBlock*> { target }));
+        target->predecessors.push_back(m_block);
+    }
+
+    void AddCondBranch(ir::Value* condition, ir::BasicBlock* trueTarget, ir::BasicBlock* falseTarget)
+    {
+        m_block->Append(std::make_unique<ir::Instruction>(ir::Opcode::CondBranch, ir::Type::Void, std::vector<ir::Value*> { condition }, std::vector<ir::BasicBlock*> { trueTarget, falseTarget }));
+        trueTarget->predecessors.push_back(m_block);
+        falseTarget->predecessors.push_back(m_block);
+    }
+
+    // Code after 'return' or 'break' goes to a block without predecessor, which is removed later.
+    void StartUnreachableBlock()
+    {
+        m_block = m_function->CreateBlock();
+        m_sealedBlocks.insert(m_block);
+    }
+
+    const VariableDeclaration* QueryVariable(const IdentifierExpression& identifierExpression) const
+    {
+        for (auto it = m_variables.rbegin(); it != m_variables.rend(); ++it) {
+            if (auto variable = it->find(identifierExpression.fullName); variable != it->end()) {
+                return variable->second;
+            }
+        }
+        throw Exception { identifierExpression.sourceRange, "use of undeclared identifier '{}'", identifierExpression.fullName };
+    }
+
+    void WriteVariable(const VariableDeclaration* variable, ir::BasicBlock* block, ir::Value* value)
+    {
+        m_currentDefinitions[variable][block] = value;
+    }
+
+    ir::Value* ReadVariable(const VariableDeclaration* variable, ir::BasicBlock* block)
+    {
+        auto& definitions = m_currentDefinitions[variable];
+        if (auto it = definitions.find(block); it != definitions.end()) {
+            return it->second;
+        }
+
+        auto type = GetType(variable->typeInfo, variable->sourceRange);
+        ir::Value* value {};
+        if (!m_sealedBlocks.contains(block)) {
+            auto phi = block->InsertPhi(std::make_unique<ir::Instruction>(ir::Opcode::Phi, type));
+            m_incompletePhis[block].emplace_back(variable, phi);
+            value = phi;
+        } else if (block->predecessors.empty()) {
+            // Unreachable code.
+            value = m_function->GetConstant(type, 0);
+        } else if (block->predecessors.size() == 1) {
+            value = ReadVariable(variable, block->predecessors.front());
+        } else {
+            auto phi = block->InsertPhi(std::make_unique<ir::Instruction>(ir::Opcode::Phi, type));
+            WriteVariable(variable, block, phi);
+            AddPhiOperands(variable, phi);
+            value = phi;
+        }
+        WriteVariable(variable, block, value);
+        return value;
+    }
+
+    void AddPhiOperands(const VariableDeclaration* variable, ir::Instruction* phi)
+    {
+        for (auto predecessor : phi->parent->predecessors) {
+            phi->operands.push_back(ReadVariable(variable, predecessor));
+            phi->blocks.push_back(predecessor);
+        }
+    }
+
+    void SealBlock(ir::BasicBlock* block)
+    {
+        for (auto [variable, phi] : m_incompletePhis[block]) {
+            AddPhiOperands(variable, phi);
+        }
+        m_incompletePhis.erase(block);
+        m_sealedBlocks.insert(block);
+    }
+
+    // Removes phis whose operands are all the same value, or the phi itself.
+    void RemoveTrivialPhis()
+    {
+        for (auto changed = true; changed;) {
+            changed = false;
+            for (const auto& block : m_function->blocks) {
+                for (auto it = block->instructions.begin(); it != block->instructions.end() && (*it)->opcode == ir::Opcode::Phi;) {
+                    auto phi = it->get();
+                    ir::Value* same {};
+                    auto trivial = true;
+                    for (auto operand : phi->operands) {
+                        if (operand == same || operand == phi) {
+                            continue;
+                        }
+                        if (same) {
+                            trivial = false;
+                            break;
+                        }
+                        same = operand;
+                    }
+                    if (!trivial) {
+                        ++it;
+                        continue;
+                    }
+
+                    m_function->ReplaceAllUses(phi, same ? same : m_function->GetConstant(phi->type, 0));
+                    it = block->instructions.erase(it);
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    ir::Function* m_function {};
+    ir::BasicBlock* m_block {};
+    std::unordered_map<std::string, ir::Type> m_functionTypes {};
+    std::vector<std::unordered_map<std::string, const VariableDeclaration*>> m_variables {};
+    std::unordered_map<const VariableDeclaration*, std::unordered_map<ir::BasicBlock*, ir::Value*>> m_currentDefinitions {};
+    std::unordered_set<ir::BasicBlock*> m_sealedBlocks {};
+    std::unordered_map<ir::BasicBlock*, std::vector<std::pair<const VariableDeclaration*, ir::Instruction*>>> m_incompletePhis {};
+    std::vector<ir::BasicBlock*> m_breakTargets {};
+    std::vector<ir::BasicBlock*> m_continueTargets {};
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+module;
+
+#include <format>
+#include <memory>
+#include <ostream>
+#include <string>
+
+import scc.ir;
+
+export module scc.compiler:ir_printer;
+import :printer;
+
+namespace scc::compiler {
+
+// Prints the IR in a readable textual form, used by `--emit-ir`.
+export struct IrPrinter final {
+    IrPrinter(std::shared_ptr<std::ostream> out)
+        : m_printer { std::move(out) }
+    {
+    }
+
+    void PrintProgram(const ir::Program& program)
+    {
+        for (size_t i = 0; i < program.functions.size(); ++i) {
+            if (i) {
+                m_printer.Println();
+            }
+            PrintFunction(*program.functions[i]);
+        }
+    }
+
+    void PrintFunction(const ir::Function& function)
+    {
+        m_printer.Print("function {} @{}(", ir::GetTypeName(function.returnType), function.name);
+        for (size_t i = 0; i < function.arguments.size(); ++i) {
+            m_printer.Print("{}{} %{}", i ? ", " : "", ir::GetTypeName(function.arguments[i]->type), function.arguments[i]->name);
+        }
+        m_printer.Println(")");
+
+        for (const auto& block : function.blocks) {
+            m_printer.Println("bb{}:", block->id);
+            m_printer.PushIndent();
+            for (const auto& instruction : block->instructions) {
+                PrintInstruction(*instruction);
+            }
+            m_printer.PopIndent();
+        }
+    }
+
+private:
+    void PrintInstruction(const ir::Instruction& instruction)
+    {
+        if (instruction.type != ir::Type::Void) {
+            m_printer.Print("%{} = ", instruction.id);
+        }
+        m_printer.Print("{}{}", ir::GetOpcodeName(instruction.opcode), instruction.wraps ? ".wrap" : "");
+        if (instruction.type != ir::Type::Void) {
+            m_printer.Print(" {}", ir::GetTypeName(instruction.type));
+        }
+
+        switch (instruction.opcode) {
+        case ir::Opcode::Call:
+            m_printer.Print(" @{}(", instruction.callee);
+            for (size_t i = 0; i < instruction.operands.size(); ++i) {
+                m_printer.Print("{}{}", i ? ", " : "", GetOperand(*instruction.operands[i]));
+            }
+            m_printer.Print(")");
+            break;
+
+        case ir::Opcode::Phi:
+            for (size_t i = 0; i < instruction.operands.size(); ++i) {
+                m_printer.Print("{} [{}, bb{}]", i ? "," : "", GetOperand(*instruction.operands[i]), instruction.blocks[i]->id);
+            }
+            break;
+
+        default:
+            for (size_t i = 0; i < instruction.operands.size(); ++i) {
+                m_printer.Print("{} {}", i ? "," : "", GetOperand(*instruction.operands[i]));
+            }
+            for (size_t i = 0; i < instruction.blocks.size(); ++i) {
+                m_printer.Print("{} bb{}", i || !instruction.operands.empty() ? "," : "", instruction.blocks[i]->id);
+            }
+            break;
+        }
+        m_printer.Println();
+    }
+
+    static std::string GetOperand(const ir::Value& value)
+    {
+        if (auto constant = dynamic_cast<const ir::Constant*>(&value)) {
+            if (constant->type == ir::Type::Bool) {
+                return constant->value ? "true" : "false";
+            }
+            return std::format("{}", constant->value);
+        } else if (auto stringConstant = dynamic_cast<const ir::StringConstant*>(&value)) {
+            auto escaped = std::string { "\"" };
+            for (const auto ch : stringConstant->value) {
+                if (ch == '"' || ch == '\\') {
+                    escaped += '\\';
+                    escaped += ch;
+                } else if (ch >= ' ' && ch <= '~') {
+                    escaped += ch;
+                } else {
+                    escaped += std::format("\\{:02x}", (unsigned char)ch);
+                }
+            }
+            return escaped + '"';
+        } else if (auto argument = dynamic_cast<const ir::Argument*>(&value)) {
+            return "%" + argument->name;
+        } else {
+            return std::format("%{}", static_cast<const ir::Instruction&>(value).id);
+        }
+    }
+
+    Printer m_printer;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,389 @@
+module;
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+import scc.ir;
+
+export module scc.compiler:ir_translator;
+import :format_string;
+import :printer;
+import :std_imports;
+
+namespace scc::compiler {
+
+// Translates the IR into C++. Every SSA value becomes a local variable and every basic block a
+// label. A phi is assigned through a second variable by the branches into its block, so all phis of
+// a block take their new values at once.
+export struct IrTranslator final {
+    IrTranslator(std::shared_ptr<std::ostream> out)
+        : m_printer { std::move(out) }
+    {
+    }
+
+    // The output is written a function at a time.
+    void TranslateProgram(const ir::Program& program)
+    {
+        m_printer.Println("// scc autogenerated file.");
+        m_printer.Println();
+        GetStdImports(program).Print(m_printer);
+
+        if (program.functions.size() > 1) {
+            m_printer.Println("// function declarations");
+            for (const auto& function : program.functions) {
+                if (function->name != "main") {
+                    PrintFunctionHeader(*function);
+                    m_printer.Println(";");
+                }
+            }
+            m_printer.Println();
+            m_printer.Flush();
+
+            m_printer.Println("// function definitions");
+            for (const auto& function : program.functions) {
+                if (function->name != "main") {
+                    TranslateFunction(*function);
+                    m_printer.Println();
+                    m_printer.Flush();
+                }
+            }
+        }
+
+        for (const auto& function : program.functions) {
+            if (function->name == "main") {
+                TranslateFunction(*function);
+            }
+        }
+    }
+
+private:
+    // The modules of the functions of `scc.std` the program calls, and of the parts the calls with
+    // a constant format are printed as.
+    static StdImports GetStdImports(const ir::Program& program)
+    {
+        auto imports = StdImports {};
+        for (const auto& function : program.functions) {
+            for (const auto& block : function->blocks) {
+                for (const auto& instruction : block->instructions) {
+                    if (instruction->opcode != ir::Opcode::Call || !instruction->callee.starts_with("std::")) {
+                        continue;
+                    }
+                    imports.AddName(GetFormatPieces(*instruction) ? std::string_view { "print_parts" } : std::string_view { instruction->callee }.substr(5));
+                }
+            }
+        }
+        return imports;
+    }
+
+    void TranslateFunction(const ir::Function& function)
+    {
+        PrintFunctionHeader(function);
+        m_printer.Println();
+        m_printer.Println("{{");
+        m_printer.PushIndent();
+
+        auto hasLocals = false;
+        for (const auto& block : function.blocks) {
+            for (const auto& instruction : block->instructions) {
+                if (instruction->type == ir::Type::Void) {
+                    continue;
+                }
+                m_printer.Println("{} _v{} {{}};", GetTypeName(instruction->type), instruction->id);
+                if (instruction->opcode == ir::Opcode::Phi) {
+                    m_printer.Println("{} _p{} {{}};", GetTypeName(instruction->type), instruction->id);
+                }
+                hasLocals = true;
+            }
+        }
+        if (hasLocals) {
+            m_printer.Println();
+        }
+
+        for (const auto& block : function.blocks) {
+            m_printer.Println("_bb{}:", block->id);
+            m_printer.PushIndent();
+            for (const auto& instruction : block->instructions) {
+                TranslateInstruction(function, *instruction);
+            }
+            m_printer.PopIndent();
+        }
+
+        m_printer.PopIndent();
+        m_printer.Println("}}");
+    }
+
+    void TranslateInstruction(const ir::Function& function, const ir::Instruction& instruction)
+    {
+        switch (instruction.opcode) {
+        case ir::Opcode::Neg:
+            if (instruction.wraps) {
+                m_printer.Println("_v{} = ({})(0 - ({}){});", instruction.id, GetTypeName(instruction.type), GetUnsignedTypeName(instruction.type), GetOperand(instruction, 0));
+            } else {
+                m_printer.Println("_v{} = -{};", instruction.id, GetOperand(instruction, 0));
+            }
+            break;
+
+        case ir::Opcode::Mul:
+        case ir::Opcode::Add:
+        case ir::Opcode::Sub:
+            if (instruction.wraps) {
+                m_printer.Println("_v{} = ({})(({}){} {} ({}){});", instruction.id, GetTypeName(instruction.type),
+                    GetUnsignedTypeName(instruction.type), GetOperand(instruction, 0), GetOperator(instruction.opcode),
+                    GetUnsignedTypeName(instruction.type), GetOperand(instruction, 1));
+                break;
+            }
+            [[fallthrough]];
+
+        case ir::Opcode::Div:
+        case ir::Opcode::Mod:
+        case ir::Opcode::ShiftLeft:
+        case ir::Opcode::ShiftRight:
+        case ir::Opcode::BitAnd:
+        case ir::Opcode::BitXor:
+        case ir::Opcode::BitOr:
+        case ir::Opcode::Equal:
+        case ir::Opcode::NotEqual:
+        case ir::Opcode::Less:
+        case ir::Opcode::LessEqual:
+        case ir::Opcode::Greater:
+        case ir::Opcode::GreaterEqual:
+            m_printer.Println("_v{} = {} {} {};", instruction.id, GetOperand(instruction, 0), GetOperator(instruction.opcode), GetOperand(instruction, 1));
+            break;
+
+        case ir::Opcode::Convert:
+            m_printer.Println("_v{} = ({}){};", instruction.id, GetTypeName(instruction.type), GetOperand(instruction, 0));
+            break;
+
+        case ir::Opcode::Call: {
+            if (PrintFormattedCall(instruction)) {
+                break;
+            }
+            auto args = std::string {};
+            for (size_t i = 0; i < instruction.operands.size(); ++i) {
+                args += i ? ", " : "";
+                args += GetOperand(instruction, i);
+            }
+            auto callee = instruction.callee.starts_with("std::") ? "scc::" + instruction.callee : instruction.callee;
+            if (instruction.type == ir::Type::Void) {
+                m_printer.Println("{}({});", callee, args);
+            } else {
+                m_printer.Println("_v{} = {}({});", instruction.id, callee, args);
+            }
+            break;
+        }
+
+        case ir::Opcode::Phi:
+            m_printer.Println("_v{} = _p{};", instruction.id, instruction.id);
+            break;
+
+        case ir::Opcode::Branch:
+            PrintPhiCopies(*instruction.parent, *instruction.blocks[0]);
+            m_printer.Println("goto _bb{};", instruction.blocks[0]->id);
+            break;
+
+        case ir::Opcode::CondBranch:
+            if (!HasPhis(*instruction.blocks[0]) && !HasPhis(*instruction.blocks[1])) {
+                m_printer.Println("if ({}) goto _bb{}; else goto _bb{};", GetOperand(instruction, 0), instruction.blocks[0]->id, instruction.blocks[1]->id);
+                break;
+            }
+            m_printer.Println("if ({})", GetOperand(instruction, 0));
+            m_printer.Println("{{");
+            m_printer.PushIndent();
+            PrintPhiCopies(*instruction.parent, *instruction.blocks[0]);
+            m_printer.Println("goto _bb{};", instruction.blocks[0]->id);
+            m_printer.PopIndent();
+            m_printer.Println("}}");
+            m_printer.Println("else");
+            m_printer.Println("{{");
+            m_printer.PushIndent();
+            PrintPhiCopies(*instruction.parent, *instruction.blocks[1]);
+            m_printer.Println("goto _bb{};", instruction.blocks[1]->id);
+            m_printer.PopIndent();
+            m_printer.Println("}}");
+            break;
+
+        case ir::Opcode::Return:
+            if (!instruction.operands.empty()) {
+                m_printer.Println("return {};", GetOperand(instruction, 0));
+            } else if (function.name == "main") {
+                m_printer.Println("return 0;");
+            } else if (function.returnType == ir::Type::Void) {
+                m_printer.Println("return;");
+            } else {
+                m_printer.Println("return {{}};");
+            }
+            break;
+
+        default:
+            assert(false);
+        }
+    }
+
+    // Parses the constant format string of a call of `std::print` or `std::println`, with the
+    // newline of `std::println` appended to the text. Returns nothing if the call is left to
+    // `std::format`, like specs with nested fields are in the AST translator.
+    static std::optional<std::vector<FormatPiece>> GetFormatPieces(const ir::Instruction& call)
+    {
+        if ((call.callee != "std::print" && call.callee != "std::println") || call.operands.empty()) {
+            return std::nullopt;
+        }
+        auto format = dynamic_cast<const ir::StringConstant*>(call.operands[0]);
+        if (!format) {
+            return std::nullopt;
+        }
+
+        auto pieces = std::vector<FormatPiece> {};
+        try {
+            pieces = ParseFormatString(format->value, call.operands.size() - 1);
+        } catch (const std::format_error&) {
+            // Let std::format report it.
+            return std::nullopt;
+        }
+        if (std::ranges::any_of(pieces, [](const auto& piece) { return piece.HasNestedFields(); })) {
+            return std::nullopt;
+        }
+
+        if (call.callee == "std::println") {
+            if (pieces.empty() || pieces.back().IsField()) {
+                pieces.emplace_back();
+            }
+            pieces.back().text += '\n';
+        }
+        return pieces;
+    }
+
+    // Prints a call of `std::print` or `std::println` with a constant format string as the text and
+    // arguments to write one after the other, so the format string isn't parsed at run time.
+    bool PrintFormattedCall(const ir::Instruction& call)
+    {
+        auto pieces = GetFormatPieces(call);
+        if (!pieces) {
+            return false;
+        }
+
+        auto parts = std::string {};
+        for (const auto& piece : *pieces) {
+            parts += parts.empty() ? "" : ", ";
+            if (!piece.IsField()) {
+                parts += EscapeString(piece.text);
+            } else if (piece.spec.empty()) {
+                parts += GetOperand(call, piece.argIndex + 1);
+            } else {
+                parts += std::format("scc::std::format_part({}, {})", EscapeString("{:" + piece.spec + "}"), GetOperand(call, piece.argIndex + 1));
+            }
+        }
+        m_printer.Println("scc::std::print_parts({});", parts);
+        return true;
+    }
+
+    void PrintPhiCopies(const ir::BasicBlock& from, const ir::BasicBlock& to)
+    {
+        for (const auto& instruction : to.instructions) {
+            if (instruction->opcode != ir::Opcode::Phi) {
+                break;
+            }
+            for (size_t i = 0; i < instruction->blocks.size(); ++i) {
+                if (instruction->blocks[i] == &from) {
+                    m_printer.Println("_p{} = {};", instruction->id, GetOperand(*instruction, i));
+                }
+            }
+        }
+    }
+
+    static bool HasPhis(const ir::BasicBlock& block)
+    {
+        return !block.instructions.empty() && block.instructions.front()->opcode == ir::Opcode::Phi;
+    }
+
+    void PrintFunctionHeader(const ir::Function& function)
+    {
+        m_printer.Print("{} {}(", GetTypeName(function.returnType), function.name);
+        for (size_t i = 0; i < function.arguments.size(); ++i) {
+            m_printer.Print("{}{} {}", i ? ", " : "", GetTypeName(function.arguments[i]->type), function.arguments[i]->name);
+        }
+        m_printer.Print(")");
+    }
+
+    static std::string GetOperand(const ir::Instruction& instruction, size_t index)
+    {
+        auto operand = instruction.operands[index];
+        if (auto constant = dynamic_cast<const ir::Constant*>(operand)) {
+            if (constant->type == ir::Type::Bool) {
+                return constant->value ? "true" : "false";
+            }
+            auto isLong = constant->type == ir::Type::Long;
+            auto text = FormatInteger(constant->value, isLong ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int32_t>::min(), isLong ? "L" : "");
+            return constant->value < 0 ? "(" + text + ")" : text;
+        } else if (auto stringConstant = dynamic_cast<const ir::StringConstant*>(operand)) {
+            return EscapeString(stringConstant->value);
+        } else if (auto argument = dynamic_cast<const ir::Argument*>(operand)) {
+            return argument->name;
+        } else {
+            return std::format("_v{}", static_cast<const ir::Instruction*>(operand)->id);
+        }
+    }
+
+    static std::string_view GetTypeName(ir::Type type)
+    {
+        return type == ir::Type::String ? "const char*" : ir::GetTypeName(type);
+    }
+
+    static std::string_view GetUnsignedTypeName(ir::Type type)
+    {
+        return type == ir::Type::Long ? "unsigned long" : "unsigned";
+    }
+
+    static std::string_view GetOperator(ir::Opcode opcode)
+    {
+        switch (opcode) {
+        case ir::Opcode::Mul:
+            return "*";
+        case ir::Opcode::Div:
+            return "/";
+        case ir::Opcode::Mod:
+            return "%";
+        case ir::Opcode::Add:
+            return "+";
+        case ir::Opcode::Sub:
+            return "-";
+        case ir::Opcode::ShiftLeft:
+            return "<<";
+        case ir::Opcode::ShiftRight:
+            return ">>";
+        case ir::Opcode::BitAnd:
+            return "&";
+        case ir::Opcode::BitXor:
+            return "^";
+        case ir::Opcode::BitOr:
+            return "|";
+        case ir::Opcode::Equal:
+            return "==";
+        case ir::Opcode::NotEqual:
+            return "!=";
+        case ir::Opcode::Less:
+            return "<";
+        case ir::Opcode::LessEqual:
+            return "<=";
+        case ir::Opcode::Greater:
+            return ">";
+        case ir::Opcode::GreaterEqual:
+            return ">=";
+        default:
+            assert(false);
+            return "";
+        }
+    }
+
+    Printer m_printer;
+};
+
+}
\ No newline at end of file
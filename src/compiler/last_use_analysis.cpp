@@ -0,0 +1,213 @@
+module;
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+import scc.ast;
+
+export module scc.compiler:last_use_analysis;
+
+namespace scc::compiler {
+
+using namespace ast;
+
+// Finds the arguments which are the last use of a variable owning memory, i.e. containing a vector,
+// so the translator moves the variable into a by-value or `move` parameter instead of copying it.
+//
+// A use is the last one if no use of the variable comes after it in source order, it's not in a
+// loop the variable is declared outside of, and its statement doesn't use the variable again, as
+// arguments are evaluated in an unspecified order. Calls in spawned tasks work on the copies the
+// task captured, and functions which declare slices, which may view the variable, are left alone.
+export struct LastUseAnalysis final {
+    explicit LastUseAnalysis(const FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        auto collector = UseCollector {};
+        collector.frames.emplace_back();
+        for (const auto& parameter : functionDefinitionStatement.headerScope.variableDeclarations) {
+            collector.Declare(*parameter);
+        }
+        collector.VisitAstScope(functionDefinitionStatement.bodyScope);
+        Analyze(collector);
+    }
+
+    // Analyzes the statements of the global scope, which are the body of `main`.
+    explicit LastUseAnalysis(const Scope& scope)
+    {
+        auto collector = UseCollector {};
+        collector.VisitAstScope(scope);
+        Analyze(collector);
+    }
+
+    bool IsLastUse(const Expression& argExpression) const
+    {
+        return m_lastUses.contains(&argExpression);
+    }
+
+private:
+    struct Use {
+        const IdentifierExpression* expression {};
+        const Statement* statement {};
+        int loopDepth {};
+    };
+
+    struct UseCollector final : RecursiveVisitor {
+        std::vector<std::unordered_map<std::string, const VariableDeclaration*>> frames {};
+        std::unordered_map<const VariableDeclaration*, int> declarationLoopDepths {};
+        std::unordered_map<const VariableDeclaration*, std::vector<Use>> uses {};
+        std::unordered_set<const Expression*> movableArguments {};
+        const Statement* statement {};
+        int loopDepth {};
+        int spawnDepth {};
+        bool declaresSlices {};
+
+        void Declare(const VariableDeclaration& variableDeclaration)
+        {
+            frames.back()[variableDeclaration.name] = &variableDeclaration;
+            declarationLoopDepths[&variableDeclaration] = loopDepth;
+        }
+
+        void VisitAstConditionalStatement(const ConditionalStatement& conditionalStatement) override
+        {
+            statement = &conditionalStatement;
+            RecursiveVisitor::VisitAstConditionalStatement(conditionalStatement);
+        }
+
+        void VisitAstExpressionStatement(const ExpressionStatement& expressionStatement) override
+        {
+            statement = &expressionStatement;
+            RecursiveVisitor::VisitAstExpressionStatement(expressionStatement);
+        }
+
+        void VisitAstForLoopStatement(const ForLoopStatement& forLoopStatement) override
+        {
+            frames.emplace_back();
+            for (const auto& initStatement : forLoopStatement.initScope.statements) {
+                initStatement->Visit(*this);
+            }
+
+            // The condition, the iteration and the body run again in every iteration.
+            ++loopDepth;
+            statement = &forLoopStatement;
+            if (forLoopStatement.conditionalExpression) {
+                forLoopStatement.conditionalExpression->Visit(*this);
+            }
+            if (forLoopStatement.iterationExpression) {
+                forLoopStatement.iterationExpression->Visit(*this);
+            }
+            VisitAstScope(forLoopStatement.bodyScope);
+            --loopDepth;
+            frames.pop_back();
+        }
+
+        void VisitAstFunctionCallExpression(const FunctionCallExpression& functionCallExpression) override
+        {
+            // The function expression names a function, never a variable.
+            const auto& args = functionCallExpression.argsExpression;
+            for (size_t i = 0; i < args.size(); ++i) {
+                if (functionCallExpression.function && spawnDepth == 0 && dynamic_cast<const IdentifierExpression*>(args[i].get())) {
+                    auto parameterMode = functionCallExpression.function->headerScope.variableDeclarations[i]->parameterMode;
+                    if (parameterMode == ParameterMode::Value || parameterMode == ParameterMode::Move) {
+                        movableArguments.insert(args[i].get());
+                    }
+                }
+                args[i]->Visit(*this);
+            }
+        }
+
+        void VisitFunctionDefinitionStatement(const FunctionDefinitionStatement& functionDefinitionStatement) override
+        {
+            // Functions are analyzed on their own.
+        }
+
+        void VisitAstIdentifierExpression(const IdentifierExpression& identifierExpression) override
+        {
+            for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+                if (auto variable = it->find(identifierExpression.fullName); variable != it->end()) {
+                    uses[variable->second].push_back(Use { &identifierExpression, statement, loopDepth });
+                    return;
+                }
+            }
+        }
+
+        void VisitReturnStatement(const ReturnStatement& returnStatement) override
+        {
+            statement = &returnStatement;
+            RecursiveVisitor::VisitReturnStatement(returnStatement);
+        }
+
+        void VisitAstScope(const Scope& scope) override
+        {
+            frames.emplace_back();
+            RecursiveVisitor::VisitAstScope(scope);
+            frames.pop_back();
+        }
+
+        void VisitAstSpawnExpression(const SpawnExpression& spawnExpression) override
+        {
+            ++spawnDepth;
+            RecursiveVisitor::VisitAstSpawnExpression(spawnExpression);
+            --spawnDepth;
+        }
+
+        void VisitAstSwitchStatement(const SwitchStatement& switchStatement) override
+        {
+            statement = &switchStatement;
+            RecursiveVisitor::VisitAstSwitchStatement(switchStatement);
+        }
+
+        void VisitAstVariableDeclaration(const VariableDeclaration& variableDeclaration) override
+        {
+            RecursiveVisitor::VisitAstVariableDeclaration(variableDeclaration);
+            declaresSlices = declaresSlices || ContainsKind(variableDeclaration.typeInfo, TypeKind::Slice);
+            Declare(variableDeclaration);
+        }
+
+        void VisitAstVariableDefinitionStatement(const VariableDefinitionStatement& variableDefinitionStatemet) override
+        {
+            statement = &variableDefinitionStatemet;
+            RecursiveVisitor::VisitAstVariableDefinitionStatement(variableDefinitionStatemet);
+        }
+    };
+
+    void Analyze(const UseCollector& collector)
+    {
+        if (collector.declaresSlices) {
+            return;
+        }
+        for (const auto& [variableDeclaration, uses] : collector.uses) {
+            if (!IsMovable(*variableDeclaration)) {
+                continue;
+            }
+            const auto& last = uses.back();
+            auto usedAgain = std::ranges::count(uses, last.statement, &Use::statement) > 1;
+            if (!usedAgain && last.loopDepth == collector.declarationLoopDepths.at(variableDeclaration) && collector.movableArguments.contains(last.expression)) {
+                m_lastUses.insert(last.expression);
+            }
+        }
+    }
+
+    // `const` variables and `in` parameters can't be moved from, and `ref` parameters belong to the
+    // caller.
+    static bool IsMovable(const VariableDeclaration& variableDeclaration)
+    {
+        return variableDeclaration.constness == Constness::None && variableDeclaration.parameterMode != ParameterMode::Ref
+            && ContainsKind(variableDeclaration.typeInfo, TypeKind::Vector);
+    }
+
+    static bool ContainsKind(const TypeInfo& type, TypeKind kind)
+    {
+        if (type.kind == kind) {
+            return true;
+        } else if (type.elementType) {
+            return ContainsKind(*type.elementType, kind);
+        }
+        return std::ranges::any_of(type.fields, [kind](const auto& field) { return ContainsKind(*field.typeInfo, kind); });
+    }
+
+    std::unordered_set<const Expression*> m_lastUses {};
+};
+
+}
\ No newline at end of file
@@ -1,9 +1,12 @@
 module;
 
 #include <cassert>
+#include <cctype>
 #include <deque>
 #include <istream>
 #include <memory>
+#include <optional>
+#include <string>
 
 import scc.ast;
 
@@ -14,8 +17,11 @@ import :token;
 namespace scc::compiler {
 
 export struct Lexer final {
-    Lexer(std::shared_ptr<std::istream> in)
+    // The input starts at `line` and `column`, e.g. when it is a part of a source file.
+    Lexer(std::shared_ptr<std::istream> in, int line = 1, int column = 1)
         : m_in { std::move(in) }
+        , m_line { line }
+        , m_column { column }
     {
         assert(m_in);
     }
@@ -57,6 +63,22 @@ export struct Lexer final {
         m_tokens.push_front(std::move(token));
     }
 
+    // Records the characters read from the input until `StopRecording` returns them. The peeked
+    // tokens must be consumed first, their characters are read already.
+    void StartRecording()
+    {
+        assert(m_tokens.empty());
+        m_recording.emplace();
+    }
+
+    std::string StopRecording()
+    {
+        assert(m_recording);
+        auto recording = std::move(*m_recording);
+        m_recording.reset();
+        return recording;
+    }
+
 private:
     static_assert(TOKEN_EOF == std::istream::traits_type::eof());
 
@@ -68,7 +90,7 @@ private:
             } else if (isalpha(ch) || ch == '_') {
                 return ReadIdentifier();
             } else if (isdigit(ch)) {
-                return ReadInteger();
+                return ReadNumber();
             } else {
                 switch (ch) {
                 case '#':
@@ -219,10 +241,14 @@ private:
 
                 case '(':
                 case ')':
+                case '[':
+                case ']':
                 case '{':
                 case '}':
                 case ';':
                 case ',':
+                case '.':
+                case '@':
                     GetChar();
                     return Token { ch, m_line, m_column - 1 };
 
@@ -295,6 +321,30 @@ private:
             return Token { TOKEN_ELSE, startLine, startColumn, m_column - 1 };
         } else if (str == "return") {
             return Token { TOKEN_RETURN, startLine, startColumn, m_column - 1 };
+        } else if (str == "struct") {
+            return Token { TOKEN_STRUCT, startLine, startColumn, m_column - 1 };
+        } else if (str == "const") {
+            return Token { TOKEN_CONST, startLine, startColumn, m_column - 1 };
+        } else if (str == "constexpr") {
+            return Token { TOKEN_CONSTEXPR, startLine, startColumn, m_column - 1 };
+        } else if (str == "consteval") {
+            return Token { TOKEN_CONSTEVAL, startLine, startColumn, m_column - 1 };
+        } else if (str == "parallel") {
+            return Token { TOKEN_PARALLEL, startLine, startColumn, m_column - 1 };
+        } else if (str == "spawn") {
+            return Token { TOKEN_SPAWN, startLine, startColumn, m_column - 1 };
+        } else if (str == "await") {
+            return Token { TOKEN_AWAIT, startLine, startColumn, m_column - 1 };
+        } else if (str == "switch") {
+            return Token { TOKEN_SWITCH, startLine, startColumn, m_column - 1 };
+        } else if (str == "case") {
+            return Token { TOKEN_CASE, startLine, startColumn, m_column - 1 };
+        } else if (str == "default") {
+            return Token { TOKEN_DEFAULT, startLine, startColumn, m_column - 1 };
+        } else if (str == "embed") {
+            return Token { TOKEN_EMBED, startLine, startColumn, m_column - 1 };
+        } else if (str == "x" && PeekChar() == '"') {
+            return ReadBytes(startLine, startColumn);
         } else {
             return Token { TOKEN_IDENTIFIER, startLine, startColumn, m_line, m_column - 1, std::move(str) };
         }
@@ -326,7 +376,44 @@ private:
         }
     }
 
-    Token ReadInteger()
+    // `x"0a 0b 0c"`, a byte string of pairs of hex digits, which may be separated by white space and
+    // span lines.
+    Token ReadBytes(int startLine, int startColumn)
+    {
+        assert(PeekChar() == '"');
+        GetChar();
+
+        std::string bytes;
+        auto highDigit = -1;
+        auto ch = PeekChar();
+        for (; ch != '"' && ch != TOKEN_EOF; ch = PeekChar()) {
+            if (std::isspace(ch)) {
+                GetChar();
+                continue;
+            }
+            if (!std::isxdigit(ch)) {
+                throw Exception { m_line, m_column, "invalid hex digit '{}' in byte string", (char)ch };
+            }
+            auto digit = std::isdigit(ch) ? ch - '0' : std::tolower(ch) - 'a' + 10;
+            GetChar();
+            if (highDigit < 0) {
+                highDigit = digit;
+            } else {
+                bytes += (char)(highDigit << 4 | digit);
+                highDigit = -1;
+            }
+        }
+        if (ch == TOKEN_EOF) {
+            throw Exception { m_line, m_column, "missing terminating '\"' character" };
+        } else if (highDigit >= 0) {
+            throw Exception { m_line, m_column, "byte string has an odd number of hex digits" };
+        } else {
+            GetChar();
+            return Token { TOKEN_BYTES, startLine, startColumn, m_line, m_column - 1, std::move(bytes) };
+        }
+    }
+
+    Token ReadNumber()
     {
         assert(std::isdigit(PeekChar()));
 
@@ -334,12 +421,40 @@ private:
         int startColumn = m_column;
 
         uint64_t v {};
+        auto spelling = std::string {};
         for (auto ch = PeekChar(); std::isdigit(ch); ch = PeekChar()) {
+            spelling += (char)ch;
             v *= 10;
             v += GetChar() - '0';
             // TODO: handle overflow
         }
-        return Token { TOKEN_INTEGER, startLine, startColumn, m_line, m_column - 1, v };
+        if (PeekChar() != '.' && PeekChar() != 'e' && PeekChar() != 'E') {
+            return Token { TOKEN_INTEGER, startLine, startColumn, m_line, m_column - 1, v };
+        }
+
+        // Floating point literals keep their spelling, the parser converts them.
+        if (PeekChar() == '.') {
+            spelling += (char)GetChar();
+            while (std::isdigit(PeekChar())) {
+                spelling += (char)GetChar();
+            }
+        }
+        if (PeekChar() == 'e' || PeekChar() == 'E') {
+            spelling += (char)GetChar();
+            if (PeekChar() == '+' || PeekChar() == '-') {
+                spelling += (char)GetChar();
+            }
+            if (!std::isdigit(PeekChar())) {
+                throw Exception { m_line, m_column, "exponent has no digits" };
+            }
+            while (std::isdigit(PeekChar())) {
+                spelling += (char)GetChar();
+            }
+        }
+        if (PeekChar() == 'f' || PeekChar() == 'F') {
+            spelling += (char)GetChar();
+        }
+        return Token { TOKEN_FLOAT, startLine, startColumn, m_line, m_column - 1, std::move(spelling) };
     }
 
     int PeekChar()
@@ -350,6 +465,9 @@ private:
     int GetChar()
     {
         auto ch = m_in->get();
+        if (m_recording && ch != TOKEN_EOF) {
+            *m_recording += (char)ch;
+        }
         if (ch == '\n') {
             m_column = 1;
             ++m_line;
@@ -455,6 +573,7 @@ private:
     int m_line { 1 };
     int m_column { 1 };
     std::deque<Token> m_tokens {};
+    std::optional<std::string> m_recording {};
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+module;
+
+#include <string>
+
+import scc.ast;
+
+export module scc.compiler:memoizer;
+import :call_graph;
+import :exception;
+import :purity_analysis;
+
+namespace scc::compiler {
+
+using namespace ast;
+
+// Checks that the functions with the `@memo` attribute can be memoized, which the translator does
+// by caching their results in a table keyed by the arguments. In automatic mode, recursive
+// functions whose results only depend on their integer arguments get the attribute too.
+export struct Memoizer final {
+    explicit Memoizer(bool automatic = false)
+        : m_automatic { automatic }
+    {
+    }
+
+    void MemoizeCompileUnit(Scope& scope)
+    {
+        auto callGraph = CallGraph { scope };
+        auto purityAnalysis = PurityAnalysis { scope };
+        for (auto func : scope.GetFunctions()) {
+            auto& functionDefinitionStatement = *static_cast<FunctionDefinitionStatement*>(func);
+            const auto& name = functionDefinitionStatement.name;
+            // Memo tables can't be used at compile time.
+            auto memoizable = functionDefinitionStatement.typeInfo.fullName != "void" && purityAnalysis.GetPurity(name) == Purity::Const
+                && functionDefinitionStatement.constness == Constness::None;
+            if (functionDefinitionStatement.HasAttribute("memo")) {
+                if (!memoizable) {
+                    throw Exception { functionDefinitionStatement.sourceRange, "function '{}' can't be memoized, it must return a value which only depends on its integer arguments", name };
+                }
+            } else if (m_automatic && memoizable && callGraph.IsRecursive(name)) {
+                functionDefinitionStatement.attributes.push_back("memo");
+            }
+        }
+    }
+
+private:
+    bool m_automatic {};
+};
+
+}
\ No newline at end of file
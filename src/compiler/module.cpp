@@ -1,8 +1,24 @@
 module;
 
 export module scc.compiler;
+export import :bounds_check_eliminator;
+export import :call_graph;
+export import :constant_folder;
+export import :dead_function_eliminator;
+export import :evaluator;
 export import :exception;
+export import :fork_join_parallelizer;
+export import :ir_lowering;
+export import :ir_printer;
+export import :ir_translator;
+export import :last_use_analysis;
 export import :lexer;
+export import :memoizer;
+export import :output_translator;
 export import :parser;
+export import :purity_analysis;
+export import :switch_converter;
+export import :tail_call_eliminator;
 export import :token;
-export import :translator;
\ No newline at end of file
+export import :translator;
+export import :type_checker;
\ No newline at end of file
@@ -0,0 +1,62 @@
+module;
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+export module scc.compiler:output_translator;
+import :evaluator;
+import :printer;
+import :std_imports;
+
+namespace scc::compiler {
+
+// Translates the output of a program evaluated by the `Evaluator` into a C++ program which only
+// writes it. Every line of the output is a string literal of its own.
+export struct OutputTranslator final {
+    OutputTranslator(std::shared_ptr<std::ostream> out)
+        : m_printer { std::move(out) }
+    {
+    }
+
+    void TranslateOutput(const ProgramOutput& output)
+    {
+        auto imports = StdImports {};
+        if (!output.text.empty()) {
+            imports.AddName("write");
+        }
+        m_printer.Println("// scc autogenerated file.");
+        m_printer.Println();
+        imports.Print(m_printer);
+
+        m_printer.Println("int main()");
+        m_printer.Println("{{");
+        m_printer.PushIndent();
+
+        if (!output.text.empty()) {
+            m_printer.Println("scc::std::write({{");
+            m_printer.PushIndent();
+            for (size_t start = 0; start < output.text.size();) {
+                auto end = output.text.find('\n', start);
+                end = end == std::string::npos ? output.text.size() : end + 1;
+                m_printer.WriteString(std::string_view { output.text }.substr(start, end - start));
+                if (end < output.text.size()) {
+                    m_printer.Println();
+                }
+                start = end;
+            }
+            m_printer.Println(", {} }});", output.text.size());
+            m_printer.PopIndent();
+        }
+
+        m_printer.Println("return {};", output.exitCode);
+        m_printer.PopIndent();
+        m_printer.Println("}}");
+    }
+
+private:
+    Printer m_printer;
+};
+
+}
\ No newline at end of file
@@ -1,8 +1,21 @@
 module;
 
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 import scc.ast;
@@ -10,12 +23,27 @@ import scc.ast;
 export module scc.compiler:parser;
 import :exception;
 import :lexer;
+import :token;
 
 namespace scc::compiler {
 
 using namespace ast;
 
 export struct Parser {
+    Parser() = default;
+
+    // Parses the instances of generic functions, where the type parameters name the type arguments.
+    explicit Parser(std::unordered_map<std::string, std::string> typeArguments)
+        : m_typeArguments { std::move(typeArguments) }
+    {
+    }
+
+    // Embedded files are found relative to `directory`, usually the one of the source file.
+    explicit Parser(std::filesystem::path directory)
+        : m_directory { std::move(directory) }
+    {
+    }
+
     // compile_unit
     //  : /* empty */
     //  : compile_unit statement
@@ -40,8 +68,14 @@ export struct Parser {
     //  : /* empty statement */ ';'
     //  : declaration_or_expression_statement
     //  | for_loop_statement
+    //  | parallel_for_loop_statement
     //  | if_statement
+    //  | switch_statement
     //  | return_statement
+    //  | struct_declaration_statement
+    //  | generic_function_declaration_statement
+    //  | attributed_statement
+    //  | qualified_statement
     void ParseStatement(Scope& scope, Lexer& lexer)
     {
         const auto& token = lexer.PeekToken();
@@ -65,14 +99,40 @@ export struct Parser {
             ParseForStatement(scope, lexer);
             break;
 
+        case TOKEN_PARALLEL:
+            ParseParallelForStatement(scope, lexer);
+            break;
+
         case TOKEN_IF:
             ParseIfStatement(scope, lexer);
             break;
 
+        case TOKEN_SWITCH:
+            ParseSwitchStatement(scope, lexer);
+            break;
+
         case TOKEN_RETURN:
             ParseReturnStatement(scope, lexer);
             break;
 
+        case TOKEN_STRUCT:
+            ParseStructDeclarationStatement(scope, lexer);
+            break;
+
+        case '<':
+            ParseGenericFunctionDeclarationStatement(scope, lexer);
+            break;
+
+        case '@':
+            ParseAttributedStatement(scope, lexer);
+            break;
+
+        case TOKEN_CONST:
+        case TOKEN_CONSTEXPR:
+        case TOKEN_CONSTEVAL:
+            ParseQualifiedStatement(scope, lexer);
+            break;
+
         default:
             ParseExpressionStatement(scope, lexer);
             break;
@@ -90,6 +150,7 @@ export struct Parser {
 
         // Query the identifer in the scope.
         if (auto typeInfo = scope.QueryTypeInfo(identifier->fullName)) {
+            ParseTypeSuffix(lexer, *identifier);
             ParseVariableOrFunctionDeclarationStatement(scope, lexer, std::move(identifier));
         } else {
             ParseExpressionStatement(scope, lexer, std::move(identifier));
@@ -125,6 +186,7 @@ export struct Parser {
 
         // Query the identifer in the scope.
         if (auto typeInfo = scope.QueryTypeInfo(identifier->fullName)) {
+            ParseTypeSuffix(lexer, *identifier);
             ParseVariableDeclarationStatement(scope, lexer, std::move(identifier));
         } else {
             ParseExpressionStatement(scope, lexer, std::move(identifier));
@@ -162,11 +224,22 @@ export struct Parser {
     }
 
     // variable_declaration
-    //  : type_idenitifer IDENTIFIER ('=' expression)?
+    //  : ('@' IDENTIFIER)? type_idenitifer type_suffix IDENTIFIER ('=' expression)?
     void ParseVariableDeclaration(Scope& scope, Lexer& lexer, bool allowInitExpression, std::unique_ptr<IdentifierExpression> typeIdentifierExpression = nullptr)
     {
         if (!typeIdentifierExpression) {
+            auto attribute = std::optional<Token> {};
+            if (lexer.PeekToken().type == '@') {
+                attribute = ParseAttribute(lexer);
+                if (attribute->string() != "soa") {
+                    throw Exception { attribute->sourceRange, "attribute '{}' can only be applied to function definitions", attribute->string() };
+                }
+            }
             typeIdentifierExpression.reset(static_cast<IdentifierExpression*>(ParseIdentifierExpression(scope, lexer).release()));
+            ParseTypeSuffix(lexer, *typeIdentifierExpression);
+            if (attribute) {
+                ApplySoaAttribute(scope, *typeIdentifierExpression, attribute->sourceRange);
+            }
         }
 
         assert(typeIdentifierExpression);
@@ -179,6 +252,35 @@ export struct Parser {
         ParseVariableDeclarationWithType(scope, lexer, *type, allowInitExpression, &typeIdentifierExpression->sourceRange);
     }
 
+    // type_suffix
+    //  : /* empty */
+    //  | type_suffix '[' TOKEN_INTEGER ']'
+    //  | type_suffix '[' ']'
+    //  | type_suffix '[' ':' ']'
+    //
+    // The suffix becomes part of the type name, e.g. `f64[:]`, which the scope resolves.
+    void ParseTypeSuffix(Lexer& lexer, IdentifierExpression& typeIdentifierExpression)
+    {
+        while (lexer.PeekToken().type == '[') {
+            lexer.GetToken();
+            auto suffix = std::string { "[" };
+            if (lexer.PeekToken().type == TOKEN_INTEGER) {
+                auto token = lexer.GetToken();
+                if (token.integer() == 0) {
+                    throw Exception { token.sourceRange, "array must have at least one element" };
+                }
+                suffix += std::to_string(token.integer());
+            } else if (lexer.PeekToken().type == ':') {
+                lexer.GetToken();
+                suffix += ':';
+            }
+            const auto& endToken = lexer.GetRequiredToken(']');
+            typeIdentifierExpression.fullName += suffix + ']';
+            typeIdentifierExpression.sourceRange.endLine = endToken.sourceRange.endLine;
+            typeIdentifierExpression.sourceRange.endColumn = endToken.sourceRange.endColumn;
+        }
+    }
+
     void ParseVariableDeclarationWithType(Scope& scope, Lexer& lexer, TypeInfo& type, bool allowInitExpression, const SourceRange* typeSourceRange = nullptr)
     {
         auto identifier = lexer.GetRequiredToken(TOKEN_IDENTIFIER);
@@ -199,9 +301,146 @@ export struct Parser {
         scope.statements.push_back(std::make_unique<VariableDefinitionStatement>(std::move(sourceRange), *scope.variableDeclarations.back()));
     }
 
+    // attributed_statement
+    //  : attribute+ variable_or_function_declaration_statement
+    //
+    // `@memo` applies to function definitions, `@soa` to the arrays and vectors of structs declared.
+    void ParseAttributedStatement(Scope& scope, Lexer& lexer)
+    {
+        auto attributes = std::vector<std::string> {};
+        auto soaAttribute = std::optional<SourceRange> {};
+        while (lexer.PeekToken().type == '@') {
+            auto token = ParseAttribute(lexer);
+            if (token.string() == "soa") {
+                soaAttribute = token.sourceRange;
+            } else {
+                attributes.push_back(token.string());
+            }
+        }
+
+        auto typeIdentifierExpression = std::unique_ptr<IdentifierExpression>(static_cast<IdentifierExpression*>(ParseIdentifierExpression(scope, lexer).release()));
+        if (!scope.QueryTypeInfo(typeIdentifierExpression->fullName)) {
+            throw Exception { typeIdentifierExpression->sourceRange, "attributes can only be applied to declarations" };
+        }
+        ParseTypeSuffix(lexer, *typeIdentifierExpression);
+        if (soaAttribute) {
+            ApplySoaAttribute(scope, *typeIdentifierExpression, *soaAttribute);
+        }
+
+        auto token = lexer.GetRequiredToken(TOKEN_IDENTIFIER);
+        auto isFunction = lexer.PeekToken().type == '(';
+        lexer.PutbackToken(std::move(token));
+        if (isFunction) {
+            ParseFunctionDeclarationStatement(scope, lexer, std::move(typeIdentifierExpression), std::move(attributes));
+        } else if (!attributes.empty()) {
+            throw Exception { typeIdentifierExpression->sourceRange, "attribute '{}' can only be applied to function definitions", attributes.front() };
+        } else {
+            ParseVariableDeclarationStatement(scope, lexer, std::move(typeIdentifierExpression));
+        }
+    }
+
+    // qualified_statement
+    //  : (TOKEN_CONST | TOKEN_CONSTEXPR) variable_declaration_statement
+    //  | (TOKEN_CONSTEXPR | TOKEN_CONSTEVAL) function_declaration_statement
+    void ParseQualifiedStatement(Scope& scope, Lexer& lexer)
+    {
+        auto qualifier = lexer.GetToken();
+        auto constness = qualifier.type == TOKEN_CONST ? Constness::Const : qualifier.type == TOKEN_CONSTEXPR ? Constness::Constexpr : Constness::Consteval;
+
+        auto typeIdentifierExpression = std::unique_ptr<IdentifierExpression>(static_cast<IdentifierExpression*>(ParseIdentifierExpression(scope, lexer).release()));
+        ParseTypeSuffix(lexer, *typeIdentifierExpression);
+
+        auto token = lexer.GetRequiredToken(TOKEN_IDENTIFIER);
+        auto isFunction = lexer.PeekToken().type == '(';
+        lexer.PutbackToken(std::move(token));
+        if (isFunction) {
+            if (constness == Constness::Const) {
+                throw Exception { qualifier.sourceRange, "'const' can only be applied to variable declarations" };
+            }
+            ParseFunctionDeclarationStatement(scope, lexer, std::move(typeIdentifierExpression)).constness = constness;
+            return;
+        }
+
+        if (constness == Constness::Consteval) {
+            throw Exception { qualifier.sourceRange, "'consteval' can only be applied to function definitions" };
+        }
+        auto first = scope.variableDeclarations.size();
+        ParseVariableDeclarationStatement(scope, lexer, std::move(typeIdentifierExpression));
+        for (auto i = first; i < scope.variableDeclarations.size(); ++i) {
+            auto& variableDeclaration = *scope.variableDeclarations[i];
+            if (!variableDeclaration.initExpression) {
+                throw Exception { variableDeclaration.sourceRange, "{} variable '{}' must be initialized", (TokenType)qualifier.type, variableDeclaration.name };
+            }
+            variableDeclaration.constness = constness;
+        }
+    }
+
+    // attribute
+    //  : '@' IDENTIFIER
+    Token ParseAttribute(Lexer& lexer)
+    {
+        lexer.GetRequiredToken('@');
+        auto token = lexer.GetRequiredToken(TOKEN_IDENTIFIER);
+        if (token.string() != "memo" && token.string() != "soa") {
+            throw Exception { token.sourceRange, "unknown attribute '{}'", token.string() };
+        }
+        return token;
+    }
+
+    // `@soa S[N]` and `@soa S[]` store each field of the struct `S` in an array of its own, the type
+    // name keeps the attribute.
+    void ApplySoaAttribute(Scope& scope, IdentifierExpression& typeIdentifierExpression, const SourceRange& attributeSourceRange)
+    {
+        typeIdentifierExpression.fullName = "@soa " + typeIdentifierExpression.fullName;
+        if (!scope.QueryTypeInfo(typeIdentifierExpression.fullName)) {
+            throw Exception { attributeSourceRange, "'@soa' can only be applied to arrays and vectors of structs" };
+        }
+    }
+
+    // struct_declaration_statement
+    //  : TOKEN_STRUCT IDENTIFIER '{' (variable_declaration ';')+ '}'
+    void ParseStructDeclarationStatement(Scope& scope, Lexer& lexer)
+    {
+        const auto& startToken = lexer.GetRequiredToken(TOKEN_STRUCT);
+        if (scope.parentScope) {
+            throw Exception { startToken.sourceRange, "structs can only be declared in the global scope" };
+        }
+
+        auto name = lexer.GetRequiredToken(TOKEN_IDENTIFIER);
+        if (scope.QueryTypeInfo(name.string())) {
+            throw Exception { name.sourceRange, "redefinition of type '{}'", name.string() };
+        }
+
+        // The fields are parsed as variable declarations, the struct itself isn't defined yet.
+        auto fieldScope = Scope { &scope };
+        lexer.GetRequiredToken('{');
+        if (lexer.PeekToken().type == '}') {
+            throw Exception { name.sourceRange, "struct '{}' must have at least one field", name.string() };
+        }
+        while (lexer.PeekToken().type != '}') {
+            ParseVariableDeclaration(fieldScope, lexer, /*allowInitExpression=*/false);
+            lexer.GetRequiredToken(';');
+        }
+        lexer.GetRequiredToken('}');
+
+        auto typeInfo = TypeInfo { name.string(), TypeKind::Struct };
+        for (const auto& field : fieldScope.variableDeclarations) {
+            if (field->typeInfo.kind == TypeKind::Void || field->typeInfo.kind == TypeKind::Slice) {
+                throw Exception { field->sourceRange, "field '{}' can't have type '{}'", field->name, field->typeInfo.fullName };
+            }
+            if (typeInfo.QueryField(field->name)) {
+                throw Exception { field->sourceRange, "duplicate member '{}'", field->name };
+            }
+            typeInfo.fields.push_back(FieldInfo { field->name, &field->typeInfo });
+        }
+        scope.AddStructType(std::move(typeInfo));
+    }
+
     // function_declaration_statement
-    //  type_identifier IDENTIFIER '(' (variable_declaration ',')* ')' '{' statement* '}'
-    void ParseFunctionDeclarationStatement(Scope& scope, Lexer& lexer, std::unique_ptr<IdentifierExpression> typeIdentifierExpression)
+    //  type_identifier type_suffix IDENTIFIER '(' (parameter_declaration ',')* ')' '{' statement* '}'
+    //
+    // Instances of generic functions are added as `instanceName` instead of their own name.
+    FunctionDefinitionStatement& ParseFunctionDeclarationStatement(Scope& scope, Lexer& lexer, std::unique_ptr<IdentifierExpression> typeIdentifierExpression, std::vector<std::string> attributes = {}, std::string instanceName = {})
     {
         assert(typeIdentifierExpression);
 
@@ -210,15 +449,19 @@ export struct Parser {
             throw Exception { typeIdentifierExpression->sourceRange, "Undefined type '{}'", typeIdentifierExpression->fullName };
         }
 
-        auto funcName = lexer.GetRequiredToken(TOKEN_IDENTIFIER).string();
+        auto nameToken = lexer.GetRequiredToken(TOKEN_IDENTIFIER);
+        auto funcName = instanceName.empty() ? std::move(nameToken.string()) : std::move(instanceName);
+        if (scope.QueryGenericFunction(funcName)) {
+            throw Exception { nameToken.sourceRange, "redefinition of '{}'", funcName };
+        }
 
         auto funcHeaderScope = Scope { &scope };
         lexer.GetRequiredToken('(');
         if (lexer.PeekToken().type != ')') {
-            ParseVariableDeclaration(funcHeaderScope, lexer, /*allowInitExpression=*/false);
+            ParseParameterDeclaration(funcHeaderScope, lexer);
             while (lexer.PeekToken().type == ',') {
                 lexer.GetToken();
-                ParseVariableDeclaration(funcHeaderScope, lexer, /*allowInitExpression=*/false);
+                ParseParameterDeclaration(funcHeaderScope, lexer);
             }
         }
         lexer.GetRequiredToken(')');
@@ -233,7 +476,138 @@ export struct Parser {
         auto func = std::make_unique<FunctionDefinitionStatement>(
             SourceRange { typeIdentifierExpression->sourceRange, lastToken.sourceRange },
             *type, funcName, std::move(funcHeaderScope), std::move(funcBodyScope));
-        scope.AddFunction(std::move(funcName), std::move(func));
+        func->attributes = std::move(attributes);
+        scope.AddFunction(funcName, std::move(func));
+        return *static_cast<FunctionDefinitionStatement*>(scope.QueryFunction(funcName));
+    }
+
+    // parameter_declaration
+    //  : parameter_mode variable_declaration
+    void ParseParameterDeclaration(Scope& scope, Lexer& lexer)
+    {
+        auto parameterMode = ParseParameterMode(scope, lexer);
+        ParseVariableDeclaration(scope, lexer, /*allowInitExpression=*/false);
+        auto& parameter = *scope.variableDeclarations.back();
+        parameter.parameterMode = parameterMode;
+        if (parameterMode == ParameterMode::In) {
+            parameter.constness = Constness::Const;
+        }
+    }
+
+    // parameter_mode
+    //  : /* empty */
+    //  | 'in'
+    //  | 'ref'
+    //  | 'move'
+    //
+    // The modes are only keywords where a parameter type is expected, and not if a type has the
+    // same name.
+    ParameterMode ParseParameterMode(Scope& scope, Lexer& lexer)
+    {
+        const auto& token = lexer.PeekToken();
+        if (token.type != TOKEN_IDENTIFIER || scope.QueryTypeInfo(token.string()) || m_typeArguments.contains(token.string())) {
+            return ParameterMode::Value;
+        }
+
+        auto parameterMode = ParameterMode::Value;
+        if (token.string() == "in") {
+            parameterMode = ParameterMode::In;
+        } else if (token.string() == "ref") {
+            parameterMode = ParameterMode::Ref;
+        } else if (token.string() == "move") {
+            parameterMode = ParameterMode::Move;
+        }
+        if (parameterMode != ParameterMode::Value) {
+            lexer.GetToken();
+        }
+        return parameterMode;
+    }
+
+    // generic_function_declaration_statement
+    //  : '<' (IDENTIFIER ',')* IDENTIFIER '>' function_declaration_statement
+    //
+    // Only the name and the parameter types are taken from the definition, a function is parsed
+    // from its source for every list of type arguments it is called with.
+    void ParseGenericFunctionDeclarationStatement(Scope& scope, Lexer& lexer)
+    {
+        const auto& startToken = lexer.GetRequiredToken('<');
+        if (scope.parentScope) {
+            throw Exception { startToken.sourceRange, "generic functions can only be declared in the global scope" };
+        }
+
+        auto genericFunction = std::make_unique<GenericFunctionDefinition>();
+        auto& typeParameters = genericFunction->typeParameters;
+        do {
+            if (!typeParameters.empty()) {
+                lexer.GetRequiredToken(',');
+            }
+            auto token = lexer.GetRequiredToken(TOKEN_IDENTIFIER);
+            if (scope.QueryTypeInfo(token.string()) || std::ranges::find(typeParameters, token.string()) != typeParameters.end()) {
+                throw Exception { token.sourceRange, "type parameter '{}' shadows a type", token.string() };
+            }
+            typeParameters.push_back(std::move(token.string()));
+        } while (lexer.PeekToken().type != '>');
+
+        const auto& endToken = lexer.GetRequiredToken('>');
+        genericFunction->sourceLine = endToken.sourceRange.endLine;
+        genericFunction->sourceColumn = endToken.sourceRange.endColumn + 1;
+        lexer.StartRecording();
+
+        auto returnTypeIdentifierExpression = ParseIdentifierExpression(scope, lexer);
+        ParseTypeSuffix(lexer, static_cast<IdentifierExpression&>(*returnTypeIdentifierExpression));
+        auto nameToken = lexer.GetRequiredToken(TOKEN_IDENTIFIER);
+        genericFunction->name = nameToken.string();
+        if (scope.QueryFunction(genericFunction->name) || scope.QueryGenericFunction(genericFunction->name)) {
+            throw Exception { nameToken.sourceRange, "redefinition of '{}'", genericFunction->name };
+        }
+
+        lexer.GetRequiredToken('(');
+        while (lexer.PeekToken().type != ')') {
+            if (!genericFunction->parameterTypes.empty()) {
+                lexer.GetRequiredToken(',');
+            }
+            auto parameterType = std::string {};
+            ParseParameterMode(scope, lexer);
+            if (lexer.PeekToken().type == '@') {
+                auto attribute = ParseAttribute(lexer);
+                if (attribute.string() != "soa") {
+                    throw Exception { attribute.sourceRange, "attribute '{}' can only be applied to function definitions", attribute.string() };
+                }
+                parameterType = "@soa ";
+            }
+            auto typeIdentifierExpression = ParseIdentifierExpression(scope, lexer);
+            ParseTypeSuffix(lexer, static_cast<IdentifierExpression&>(*typeIdentifierExpression));
+            genericFunction->parameterTypes.push_back(parameterType + static_cast<IdentifierExpression&>(*typeIdentifierExpression).fullName);
+            lexer.GetRequiredToken(TOKEN_IDENTIFIER);
+        }
+        lexer.GetRequiredToken(')');
+
+        // Skip the body, it is checked with the instances.
+        lexer.GetRequiredToken('{');
+        for (auto depth = 1; depth > 0;) {
+            auto type = lexer.PeekToken().type;
+            if (type == '}' || type == TOKEN_EOF) {
+                lexer.GetRequiredToken('}');
+                --depth;
+            } else if (lexer.GetToken().type == '{') {
+                ++depth;
+            }
+        }
+        genericFunction->source = lexer.StopRecording();
+
+        scope.AddGenericFunction(std::move(genericFunction));
+    }
+
+    // Parses a generic function again, with the type arguments given to the parser, and adds the
+    // instance to the scope as `instanceName`.
+    FunctionDefinitionStatement& ParseGenericFunctionInstance(Scope& scope, const GenericFunctionDefinition& genericFunction, std::string instanceName)
+    {
+        assert(!m_typeArguments.empty());
+
+        auto lexer = Lexer { std::make_shared<std::istringstream>(genericFunction.source), genericFunction.sourceLine, genericFunction.sourceColumn };
+        auto typeIdentifierExpression = std::unique_ptr<IdentifierExpression>(static_cast<IdentifierExpression*>(ParseIdentifierExpression(scope, lexer).release()));
+        ParseTypeSuffix(lexer, *typeIdentifierExpression);
+        return ParseFunctionDeclarationStatement(scope, lexer, std::move(typeIdentifierExpression), {}, std::move(instanceName));
     }
 
     // expression_statement
@@ -452,27 +826,99 @@ export struct Parser {
     }
 
     // primary_expression
-    //  : identifier_expression
-    //  | function_call_expression
+    //  : postfix_expression
     //  | integer_literal_expression
+    //  | float_literal_expression
     //  | string_literal_expression
+    //  | array_literal_expression
+    //  | embed_expression
+    //  | bytes_literal_expression
     //  | '(' expression ')'
+    //  | '-' primary_expression
+    //  | SPAWN function_call_expression
+    //  | AWAIT primary_expression
     std::unique_ptr<Expression> ParsePrimaryExpression(Scope& scope, Lexer& lexer, std::unique_ptr<IdentifierExpression> preExpression = nullptr)
     {
         if (preExpression) {
-            return ParseFunctionCallExpression(scope, lexer, std::move(preExpression));
+            return ParsePostfixExpression(scope, lexer, std::move(preExpression));
         } else if (lexer.PeekToken().type == TOKEN_INTEGER) {
             return ParseIntegerLiteralExpression(scope, lexer);
+        } else if (lexer.PeekToken().type == TOKEN_FLOAT) {
+            return ParseFloatLiteralExpression(scope, lexer);
         } else if (lexer.PeekToken().type == TOKEN_STRING) {
             return ParseStringLiteralExpression(scope, lexer);
+        } else if (lexer.PeekToken().type == '[') {
+            return ParseArrayLiteralExpression(scope, lexer);
+        } else if (lexer.PeekToken().type == TOKEN_EMBED) {
+            return ParseEmbedExpression(scope, lexer);
+        } else if (lexer.PeekToken().type == TOKEN_BYTES) {
+            return ParseBytesLiteralExpression(scope, lexer);
         } else if (lexer.PeekToken().type == '(') {
             lexer.GetRequiredToken('(');
             auto expression = ParseExpression(scope, lexer);
             lexer.GetRequiredToken(')');
             return std::make_unique<UnaryExpression>(expression->sourceRange, UnaryOp::Bracket, std::move(expression));
+        } else if (lexer.PeekToken().type == '-') {
+            auto startSourceRange = lexer.GetToken().sourceRange;
+            auto oprand = ParsePrimaryExpression(scope, lexer);
+            auto sourceRange = SourceRange { startSourceRange, oprand->sourceRange };
+            return std::make_unique<UnaryExpression>(std::move(sourceRange), UnaryOp::Minus, std::move(oprand));
+        } else if (lexer.PeekToken().type == TOKEN_SPAWN) {
+            auto startSourceRange = lexer.GetToken().sourceRange;
+            auto callExpression = ParsePostfixExpression(scope, lexer);
+            if (!dynamic_cast<const FunctionCallExpression*>(callExpression.get())) {
+                throw Exception { callExpression->sourceRange, "'spawn' requires a function call" };
+            }
+            auto sourceRange = SourceRange { startSourceRange, callExpression->sourceRange };
+            return std::make_unique<SpawnExpression>(std::move(sourceRange), std::move(callExpression));
+        } else if (lexer.PeekToken().type == TOKEN_AWAIT) {
+            auto startSourceRange = lexer.GetToken().sourceRange;
+            auto oprand = ParsePrimaryExpression(scope, lexer);
+            auto sourceRange = SourceRange { startSourceRange, oprand->sourceRange };
+            return std::make_unique<AwaitExpression>(std::move(sourceRange), std::move(oprand));
         } else {
-            return ParseFunctionCallExpression(scope, lexer);
+            return ParsePostfixExpression(scope, lexer);
+        }
+    }
+
+    // postfix_expression
+    //  : function_call_expression
+    //  | postfix_expression '[' expression ']'
+    //  | postfix_expression '[' expression? ':' expression? ']'
+    //  | postfix_expression '.' IDENTIFIER
+    std::unique_ptr<Expression> ParsePostfixExpression(Scope& scope, Lexer& lexer, std::unique_ptr<IdentifierExpression> preExpression = nullptr)
+    {
+        auto expression = ParseFunctionCallExpression(scope, lexer, std::move(preExpression));
+        while (lexer.PeekToken().type == '[' || lexer.PeekToken().type == '.') {
+            if (lexer.GetToken().type == '.') {
+                auto member = lexer.GetRequiredToken(TOKEN_IDENTIFIER);
+                auto sourceRange = SourceRange { expression->sourceRange, member.sourceRange };
+                expression = std::make_unique<MemberExpression>(std::move(sourceRange), std::move(expression), std::move(member.string()));
+                continue;
+            }
+
+            auto beginExpression = std::unique_ptr<Expression> {};
+            if (lexer.PeekToken().type != ':') {
+                beginExpression = ParseExpression(scope, lexer);
+            }
+            auto isSlice = lexer.PeekToken().type == ':';
+            auto endExpression = std::unique_ptr<Expression> {};
+            if (isSlice) {
+                lexer.GetToken();
+                if (lexer.PeekToken().type != ']') {
+                    endExpression = ParseExpression(scope, lexer);
+                }
+            }
+
+            const auto& endToken = lexer.GetRequiredToken(']');
+            auto sourceRange = SourceRange { expression->sourceRange, endToken.sourceRange };
+            if (isSlice) {
+                expression = std::make_unique<SliceExpression>(std::move(sourceRange), std::move(expression), std::move(beginExpression), std::move(endExpression));
+            } else {
+                expression = std::make_unique<IndexExpression>(std::move(sourceRange), std::move(expression), std::move(beginExpression));
+            }
         }
+        return expression;
     }
 
     // function_call_expression
@@ -507,6 +953,10 @@ export struct Parser {
 
     // identifier_expression
     //  : (IDENTIFIER '::')* IDENTIFIER
+    //  | 'task' '<' type_identifier type_suffix '>'
+    //
+    // `task` followed by a type in angle brackets is the type of a spawned call, e.g. `task<i32[]>`.
+    // Nested tasks need a space before the closing brackets, as `>>` is a shift.
     std::unique_ptr<Expression> ParseIdentifierExpression(Scope& scope, Lexer& lexer)
     {
         auto token = lexer.GetRequiredToken(TOKEN_IDENTIFIER);
@@ -522,13 +972,31 @@ export struct Parser {
             fullName += std::move(token.string());
         }
 
+        if (fullName == "task" && lexer.PeekToken().type == '<') {
+            auto lessToken = lexer.GetToken();
+            const auto& nextToken = lexer.PeekToken();
+            if (nextToken.type == TOKEN_IDENTIFIER && (m_typeArguments.contains(nextToken.string()) || scope.QueryTypeInfo(nextToken.string()))) {
+                auto resultType = std::unique_ptr<IdentifierExpression>(static_cast<IdentifierExpression*>(ParseIdentifierExpression(scope, lexer).release()));
+                ParseTypeSuffix(lexer, *resultType);
+                const auto& endToken = lexer.GetRequiredToken('>');
+                sourceRange.endLine = endToken.sourceRange.endLine;
+                sourceRange.endColumn = endToken.sourceRange.endColumn;
+                return std::make_unique<IdentifierExpression>(std::move(sourceRange), std::format("task<{}>", resultType->fullName));
+            }
+            // A comparison with a variable named `task`.
+            lexer.PutbackToken(std::move(lessToken));
+        }
+
+        if (auto it = m_typeArguments.find(fullName); it != m_typeArguments.end()) {
+            fullName = it->second;
+        }
         return std::make_unique<IdentifierExpression>(std::move(sourceRange), std::move(fullName));
     }
 
     // for_statement
     //  : FOR '(' variable_declaration_or_expression_statement expression? ';' expression ')' '{' statements* '}'
     //  : FOR '(' expression? ';' expression? ';' expression ')' '{' statements* '}'
-    void ParseForStatement(Scope& scope, Lexer& lexer)
+    ForLoopStatement& ParseForStatement(Scope& scope, Lexer& lexer, bool isParallel = false)
     {
         const auto& startToken = lexer.GetRequiredToken(TOKEN_FOR);
 
@@ -553,6 +1021,12 @@ export struct Parser {
         }
         lexer.GetRequiredToken(')');
 
+        // The reduction clauses of a parallel for loop come before its body.
+        auto reductions = std::vector<Reduction> {};
+        while (isParallel && lexer.PeekToken().type == TOKEN_IDENTIFIER) {
+            ParseReductionClause(lexer, reductions);
+        }
+
         // Parse body.
         auto forBodyScope = Scope { &forInitScope };
         lexer.GetRequiredToken('{');
@@ -563,8 +1037,86 @@ export struct Parser {
         const auto& lastToken = lexer.GetRequiredToken('}');
 
         // Finish for statement parsing, add to parent scope.
-        scope.statements.push_back(std::make_unique<ForLoopStatement>(
-            SourceRange { startToken.sourceRange, lastToken.sourceRange }, std::move(forInitScope), std::move(conditionalExpression), std::move(iterationExpression), std::move(forBodyScope)));
+        auto forLoopStatement = std::make_unique<ForLoopStatement>(
+            SourceRange { startToken.sourceRange, lastToken.sourceRange }, std::move(forInitScope), std::move(conditionalExpression), std::move(iterationExpression), std::move(forBodyScope));
+        forLoopStatement->isParallel = isParallel;
+        forLoopStatement->reductions = std::move(reductions);
+        auto& result = *forLoopStatement;
+        scope.statements.push_back(std::move(forLoopStatement));
+        return result;
+    }
+
+    // parallel_for_loop_statement
+    //  : TOKEN_PARALLEL FOR '(' type_identifier IDENTIFIER '=' expression ';' IDENTIFIER '<' expression ';' IDENTIFIER '+=' 1 ')' reduction_clause* '{' statements* '}'
+    //
+    // The iterations are split into chunks, so the loop variable must count up by one to a bound
+    // which is known before the loop starts.
+    void ParseParallelForStatement(Scope& scope, Lexer& lexer)
+    {
+        auto startSourceRange = lexer.GetRequiredToken(TOKEN_PARALLEL).sourceRange;
+        if (const auto& token = lexer.PeekToken(); token.type != TOKEN_FOR) {
+            throw Exception { token.sourceRange, "expected 'for' after 'parallel'" };
+        }
+
+        auto& forLoopStatement = ParseForStatement(scope, lexer, /*isParallel=*/true);
+        forLoopStatement.sourceRange = SourceRange { startSourceRange, forLoopStatement.sourceRange };
+        if (!IsCanonicalParallelLoop(forLoopStatement)) {
+            throw Exception { forLoopStatement.sourceRange, "parallel for loops must have the form 'parallel for (T i = begin; i < end; i += 1)', where 'T' is an integer type" };
+        }
+    }
+
+    // reduction_clause
+    //  : ('sum' | 'min' | 'max') '(' IDENTIFIER (',' IDENTIFIER)* ')'
+    void ParseReductionClause(Lexer& lexer, std::vector<Reduction>& reductions)
+    {
+        auto token = lexer.GetRequiredToken(TOKEN_IDENTIFIER);
+        auto op = ReductionOp {};
+        if (token.string() == "sum") {
+            op = ReductionOp::Sum;
+        } else if (token.string() == "min") {
+            op = ReductionOp::Min;
+        } else if (token.string() == "max") {
+            op = ReductionOp::Max;
+        } else {
+            throw Exception { token.sourceRange, "unknown reduction '{}', expected 'sum', 'min' or 'max'", token.string() };
+        }
+
+        lexer.GetRequiredToken('(');
+        auto first = true;
+        do {
+            if (!std::exchange(first, false)) {
+                lexer.GetRequiredToken(',');
+            }
+            auto variable = lexer.GetRequiredToken(TOKEN_IDENTIFIER);
+            reductions.push_back(Reduction { variable.sourceRange, op, std::move(variable.string()) });
+        } while (lexer.PeekToken().type != ')');
+        lexer.GetRequiredToken(')');
+    }
+
+    static bool IsCanonicalParallelLoop(const ForLoopStatement& forLoopStatement)
+    {
+        const auto& initScope = forLoopStatement.initScope;
+        if (initScope.statements.size() != 1 || initScope.variableDeclarations.size() != 1) {
+            return false;
+        }
+        const auto& variableDeclaration = *initScope.variableDeclarations.front();
+        if (variableDeclaration.typeInfo.kind != TypeKind::Integer || !variableDeclaration.initExpression) {
+            return false;
+        }
+
+        auto condition = dynamic_cast<const BinaryExpression*>(forLoopStatement.conditionalExpression.get());
+        if (!condition || condition->op != BinaryOp::Less || !IsIdentifier(*condition->leftOprand, variableDeclaration.name)) {
+            return false;
+        }
+        auto iteration = dynamic_cast<const BinaryExpression*>(forLoopStatement.iterationExpression.get());
+        auto step = iteration ? dynamic_cast<const IntegerLiteralExpression*>(iteration->rightOprand.get()) : nullptr;
+        return iteration && iteration->op == BinaryOp::AddAssignment && IsIdentifier(*iteration->leftOprand, variableDeclaration.name) && step && step->value == 1;
+    }
+
+    static bool IsIdentifier(const Expression& expression, const std::string& name)
+    {
+        auto identifierExpression = dynamic_cast<const IdentifierExpression*>(&expression);
+        return identifierExpression && identifierExpression->fullName == name;
     }
 
     // if_statement
@@ -604,6 +1156,69 @@ export struct Parser {
         scope.statements.push_back(std::make_unique<ConditionalStatement>(SourceRange { startSourceRange, lastSourceRange }, std::move(conditionalExpression), std::move(trueScope), std::move(falseScope)));
     }
 
+    // switch_statement
+    //  : TOKEN_SWITCH '(' expression ')' '{' switch_case* '}'
+    //
+    // switch_case
+    //  : TOKEN_CASE case_value (',' case_value)* '{' statements* '}'
+    //  | TOKEN_DEFAULT '{' statements* '}'
+    void ParseSwitchStatement(Scope& scope, Lexer& lexer)
+    {
+        auto startSourceRange = lexer.GetRequiredToken(TOKEN_SWITCH).sourceRange;
+
+        lexer.GetRequiredToken('(');
+        auto conditionalExpression = ParseExpression(scope, lexer);
+        lexer.GetRequiredToken(')');
+
+        auto cases = std::vector<SwitchCase> {};
+        auto hasDefault = false;
+        lexer.GetRequiredToken('{');
+        while (lexer.PeekToken().type != '}') {
+            auto token = lexer.GetToken();
+            auto switchCase = SwitchCase { token.sourceRange, {}, Scope { &scope } };
+            if (token.type == TOKEN_CASE) {
+                switchCase.values.push_back(ParseCaseValue(lexer));
+                while (lexer.PeekToken().type == ',') {
+                    lexer.GetToken();
+                    switchCase.values.push_back(ParseCaseValue(lexer));
+                }
+            } else if (token.type != TOKEN_DEFAULT) {
+                throw Exception { token.sourceRange, "expected 'case' or 'default'" };
+            } else if (std::exchange(hasDefault, true)) {
+                throw Exception { token.sourceRange, "multiple default cases in one switch statement" };
+            }
+
+            lexer.GetRequiredToken('{');
+            while (lexer.PeekToken().type != '}') {
+                ParseStatement(switchCase.scope, lexer);
+            }
+            lexer.GetRequiredToken('}');
+            cases.push_back(std::move(switchCase));
+        }
+        const auto& lastToken = lexer.GetRequiredToken('}');
+
+        scope.statements.push_back(std::make_unique<SwitchStatement>(SourceRange { startSourceRange, lastToken.sourceRange }, std::move(conditionalExpression), std::move(cases)));
+    }
+
+    // case_value
+    //  : '-'? TOKEN_INTEGER
+    CaseValue ParseCaseValue(Lexer& lexer)
+    {
+        auto sourceRange = lexer.PeekToken().sourceRange;
+        auto negative = lexer.PeekToken().type == '-';
+        if (negative) {
+            lexer.GetToken();
+        }
+        const auto& token = lexer.GetRequiredToken(TOKEN_INTEGER);
+        sourceRange = SourceRange { sourceRange, token.sourceRange };
+
+        // Case values are stored as `i64`, whose minimum has a magnitude one above its maximum.
+        if (token.integer() > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + negative) {
+            throw Exception { sourceRange, "case value is too large" };
+        }
+        return CaseValue { sourceRange, static_cast<int64_t>(negative ? 0 - token.integer() : token.integer()) };
+    }
+
     // return_statement
     //  : TOKEN_RETURN expression ';'
     void ParseReturnStatement(Scope& scope, Lexer& lexer)
@@ -624,6 +1239,40 @@ export struct Parser {
         return std::make_unique<IntegerLiteralExpression>(std::move(token.sourceRange), token.integer());
     }
 
+    // float_literal_expression
+    //  : TOKEN_FLOAT
+    std::unique_ptr<Expression> ParseFloatLiteralExpression(Scope& scope, Lexer& lexer)
+    {
+        auto token = lexer.GetRequiredToken(TOKEN_FLOAT);
+        const auto& spelling = token.string();
+        auto value = std::strtod(spelling.c_str(), nullptr);
+        if (std::isinf(value)) {
+            throw Exception { token.sourceRange, "floating point literal is too large" };
+        }
+        auto isSinglePrecision = std::tolower(spelling.back()) == 'f';
+        return std::make_unique<FloatLiteralExpression>(std::move(token.sourceRange), value, isSinglePrecision);
+    }
+
+    // array_literal_expression
+    //  : '[' (expression ',')* expression ']'
+    std::unique_ptr<Expression> ParseArrayLiteralExpression(Scope& scope, Lexer& lexer)
+    {
+        auto sourceRange = lexer.GetRequiredToken('[').sourceRange;
+
+        std::vector<std::unique_ptr<Expression>> elements {};
+        do {
+            if (!elements.empty()) {
+                lexer.GetRequiredToken(',');
+            }
+            elements.push_back(ParseExpression(scope, lexer));
+        } while (lexer.PeekToken().type != ']');
+
+        const auto& endToken = lexer.GetRequiredToken(']');
+        sourceRange.endLine = endToken.sourceRange.endLine;
+        sourceRange.endColumn = endToken.sourceRange.endColumn;
+        return std::make_unique<ArrayLiteralExpression>(std::move(sourceRange), std::move(elements));
+    }
+
     // string_literal_expression
     //  : TOKEN_STRING
     std::unique_ptr<Expression> ParseStringLiteralExpression(Scope& scope, Lexer& lexer)
@@ -631,6 +1280,45 @@ export struct Parser {
         auto token = lexer.GetRequiredToken(TOKEN_STRING);
         return std::make_unique<StringLiteralExpression>(std::move(token.sourceRange), std::move(token.string()));
     }
+
+    // embed_expression
+    //  : EMBED '(' TOKEN_STRING ')'
+    std::unique_ptr<Expression> ParseEmbedExpression(Scope& scope, Lexer& lexer)
+    {
+        auto sourceRange = lexer.GetRequiredToken(TOKEN_EMBED).sourceRange;
+        lexer.GetRequiredToken('(');
+        auto fileToken = lexer.GetRequiredToken(TOKEN_STRING);
+        const auto& endToken = lexer.GetRequiredToken(')');
+        sourceRange.endLine = endToken.sourceRange.endLine;
+        sourceRange.endColumn = endToken.sourceRange.endColumn;
+
+        // Only the size is needed here, the contents are copied by the assembler.
+        auto path = std::filesystem::absolute(m_directory / fileToken.string()).lexically_normal();
+        auto error = std::error_code {};
+        auto size = std::filesystem::file_size(path, error);
+        if (error) {
+            throw Exception { fileToken.sourceRange, "cannot read the embedded file '{}'", fileToken.string() };
+        }
+        if (size == 0) {
+            throw Exception { fileToken.sourceRange, "embedded file '{}' is empty", fileToken.string() };
+        }
+        return std::make_unique<EmbedExpression>(std::move(sourceRange), path.string(), size);
+    }
+
+    // bytes_literal_expression
+    //  : TOKEN_BYTES
+    std::unique_ptr<Expression> ParseBytesLiteralExpression(Scope& scope, Lexer& lexer)
+    {
+        auto token = lexer.GetRequiredToken(TOKEN_BYTES);
+        if (token.string().empty()) {
+            throw Exception { token.sourceRange, "byte string is empty" };
+        }
+        return std::make_unique<EmbedExpression>(std::move(token.sourceRange), std::move(token.string()));
+    }
+
+private:
+    std::unordered_map<std::string, std::string> m_typeArguments {};
+    std::filesystem::path m_directory {};
 };
 
 }
\ No newline at end of file
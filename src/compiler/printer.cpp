@@ -1,72 +1,200 @@
 module;
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <format>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <ostream>
-#include <stack>
+#include <string>
+#include <string_view>
 
 export module scc.compiler:printer;
 
 namespace scc::compiler {
 
+// Appends `str` as a C++ string literal. Runs of characters which don't need escaping are appended
+// at once.
+void AppendEscapedString(std::string& out, std::string_view str)
+{
+    constexpr auto digits = std::string_view { "01234567" };
+    out += '"';
+    while (!str.empty()) {
+        auto run = std::ranges::find_if(str, [](char ch) { return ch == '"' || ch == '\\' || ch < ' ' || ch > '~'; });
+        out.append(str.begin(), run);
+        if (run == str.end()) {
+            break;
+        }
+
+        auto ch = (unsigned char)*run;
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += ch;
+        } else if (ch == '\n') {
+            out += "\\n";
+        } else if (ch == '\t') {
+            out += "\\t";
+        } else {
+            // Always three digits, so a digit after it isn't read as part of the escape.
+            out += '\\';
+            out += digits[ch >> 6];
+            out += digits[(ch >> 3) & 7];
+            out += digits[ch & 7];
+        }
+        str.remove_prefix(run - str.begin() + 1);
+    }
+    out += '"';
+}
+
+export std::string EscapeString(std::string_view str)
+{
+    auto escaped = std::string {};
+    escaped.reserve(str.size() + 2);
+    AppendEscapedString(escaped, str);
+    return escaped;
+}
+
+// Spells an integer as a literal with `suffix`, negated if the integer is negative. The minimum `min`
+// of the type has no literal for its magnitude, so it's spelled as the negated maximum minus one.
+// Negative integers must be bracketed where they are operands.
+export std::string FormatInteger(int64_t value, int64_t min = std::numeric_limits<int64_t>::min(), std::string_view suffix = "")
+{
+    return value == min ? std::format("{}{} - 1", min + 1, suffix) : std::format("{}{}", value, suffix);
+}
+
+// Collects the printed text in one buffer, which is written to the stream when the printer is
+// flushed or destroyed, so the output takes a write per flush. The translators flush a top-level
+// declaration at a time. Lines are indented as they start, with a prefix of the precomputed run of
+// spaces.
 export struct Printer final {
     Printer(std::shared_ptr<std::ostream> out)
         : m_out { std::move(out) }
     {
+        m_buffer.reserve(s_initialCapacity);
     }
 
-    template <class... Args>
-    void Print(const std::string_view& fmt, Args&&... args)
+    Printer(Printer&&) = default;
+
+    ~Printer()
     {
-        auto str = std::vformat(fmt, std::make_format_args(args...));
-        auto s = 0;
-        while (s < str.length()) {
-            if (m_newLine && !m_indents.empty()) {
-                *m_out << m_indents.top();
-            }
+        Flush();
+    }
 
-            auto e = str.find('\n', s);
-            if (e == std::string::npos) {
-                *m_out << str.c_str() + s;
-                m_newLine = false;
-                break;
-            } else {
-                *m_out << std::string_view { str.c_str() + s, e - s + 1 };
-                m_newLine = true;
-                s = e + 1;
+    // The format string is checked at compile time. Without arguments, it's written as it is unless
+    // it has escaped braces.
+    template <class... Args>
+    void Print(std::format_string<Args...> fmt, Args&&... args)
+    {
+        if constexpr (sizeof...(Args) == 0) {
+            if (fmt.get().find_first_of("{}") == std::string_view::npos) {
+                Write(fmt.get());
+                return;
             }
         }
+        m_scratch.clear();
+        std::format_to(std::back_inserter(m_scratch), fmt, std::forward<Args>(args)...);
+        Write(m_scratch);
     }
 
     template <class... Args>
-    void Println(const std::string_view& fmt, Args&&... args)
+    void Println(std::format_string<Args...> fmt, Args&&... args)
     {
         Print(fmt, std::forward<Args>(args)...);
-        *m_out << std::endl;
-        m_newLine = true;
+        Println();
     }
 
     void Println()
     {
-        *m_out << std::endl;
+        m_buffer += '\n';
         m_newLine = true;
     }
 
+    // Writes the text as it is, without formatting.
+    void Write(std::string_view text)
+    {
+        while (!text.empty()) {
+            if (m_newLine) {
+                m_buffer.append(m_indents, 0, m_indent);
+                m_newLine = false;
+            }
+
+            auto end = text.find('\n');
+            if (end == std::string_view::npos) {
+                m_buffer += text;
+                break;
+            }
+            m_buffer += text.substr(0, end + 1);
+            m_newLine = true;
+            text.remove_prefix(end + 1);
+        }
+    }
+
+    // Writes `str` as a C++ string literal.
+    void WriteString(std::string_view str)
+    {
+        if (m_newLine) {
+            m_buffer.append(m_indents, 0, m_indent);
+            m_newLine = false;
+        }
+        AppendEscapedString(m_buffer, str);
+    }
+
+    // Appends the text taken from another printer as it is, which is only the same as printing it
+    // when neither is indented.
+    void Append(std::string_view text)
+    {
+        assert(m_indent == 0);
+        m_buffer += text;
+        if (!text.empty()) {
+            m_newLine = text.back() == '\n';
+        }
+    }
+
+    // Returns the printed text, and starts over with an empty buffer of the same capacity.
+    std::string TakeText()
+    {
+        auto text = m_buffer;
+        m_buffer.clear();
+        m_newLine = false;
+        m_indent = 0;
+        return text;
+    }
+
     void PushIndent()
     {
-        int indents = (m_indents.empty() ? 0 : m_indents.top().length()) + m_defaultIdent;
-        m_indents.emplace(indents, ' ');
+        m_indent += s_indentWidth;
+        if (m_indents.size() < m_indent) {
+            m_indents.resize(m_indent * 2, ' ');
+        }
     }
 
     void PopIndent()
     {
-        m_indents.pop();
+        m_indent -= s_indentWidth;
+    }
+
+    void Flush()
+    {
+        if (m_out && !m_buffer.empty()) {
+            m_out->write(m_buffer.data(), m_buffer.size());
+            m_out->flush();
+            m_buffer.clear();
+        }
     }
 
 private:
+    static constexpr size_t s_indentWidth = 4;
+    static constexpr size_t s_initialCapacity = 64 * 1024;
+
     bool m_newLine {};
-    int m_defaultIdent { 4 };
-    std::stack<std::string> m_indents {};
+    size_t m_indent {};
+    std::string m_indents {};
+    std::string m_buffer {};
+
+    // The formatted text of the last `Print`, kept to reuse its storage.
+    std::string m_scratch {};
     std::shared_ptr<std::ostream> m_out {};
 };
 
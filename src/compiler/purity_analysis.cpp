@@ -0,0 +1,168 @@
+module;
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+import scc.ast;
+
+export module scc.compiler:purity_analysis;
+import :call_graph;
+
+namespace scc::compiler {
+
+using namespace ast;
+
+export enum class Purity {
+    // The function has side effects, e.g. it prints.
+    Impure,
+
+    // The function has no side effects, but its result may depend on memory its arguments refer to.
+    Pure,
+
+    // The result of the function only depends on the values of its arguments.
+    Const,
+};
+
+// Finds the functions without side effects: they don't call functions from outside of the compile
+// unit, which may do I/O, and only call functions without side effects themselves. Global
+// variables are locals of 'main' in the generated C++, so functions can't access them.
+//
+// Arrays and vectors are passed by value, but slices refer to the elements of the caller, so a
+// function which writes elements while it has slice parameters has side effects too. Spawning and
+// awaiting tasks go through the scheduler shared by all threads, so they count as side effects.
+// `ref` parameters are the caller's variables, so functions with them are never free of side
+// effects, and `in` and `move` parameters are references, so the result may depend on memory.
+// Functions without side effects are const when every parameter is an integer or `bool` passed by
+// value, of any width, since those are the keys the memo tables can hold.
+export struct PurityAnalysis final {
+    explicit PurityAnalysis(const Scope& scope)
+    {
+        auto callGraph = CallGraph { scope };
+        for (auto func : scope.GetFunctions()) {
+            const auto& functionDefinitionStatement = *static_cast<const FunctionDefinitionStatement*>(func);
+            const auto& name = functionDefinitionStatement.name;
+            auto externalCallees = callGraph.GetExternalCallees(name);
+            auto callsExternal = std::ranges::any_of(externalCallees, [&scope](const auto& callee) { return !IsSideEffectFree(scope, callee); });
+            if (name == "main" || callsExternal || WritesThroughSlices(functionDefinitionStatement) || UsesTasks(functionDefinitionStatement) || HasRefParameters(functionDefinitionStatement)) {
+                m_purities[name] = Purity::Impure;
+            } else {
+                m_purities[name] = GetArgumentsPurity(functionDefinitionStatement);
+            }
+        }
+
+        // A function is no purer than the functions it calls, repeat until nothing changes.
+        for (auto changed = true; changed;) {
+            changed = false;
+            for (auto& [name, purity] : m_purities) {
+                for (const auto& callee : callGraph.GetCallees(name)) {
+                    if (auto calleePurity = m_purities.at(callee); calleePurity < purity) {
+                        purity = calleePurity;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    Purity GetPurity(const std::string& funcName) const
+    {
+        auto it = m_purities.find(funcName);
+        return it == m_purities.end() ? Purity::Impure : it->second;
+    }
+
+private:
+    // Functions of `scc.std` which only change their arguments.
+    static inline const std::unordered_set<std::string> s_sideEffectFreeFunctions { "std::len", "std::push", "std::store", "std::reduce_add", "std::reduce_min", "std::reduce_max", "std::select", "std::any", "std::all", "std::count", "std::shift_up" };
+
+    // Calls of SIMD types, e.g. `f32x8(values, i)`, load or broadcast values.
+    static bool IsSideEffectFree(const Scope& scope, const std::string& callee)
+    {
+        auto typeInfo = scope.QueryTypeInfo(callee);
+        return s_sideEffectFreeFunctions.contains(callee) || (typeInfo && typeInfo->kind == TypeKind::Simd);
+    }
+
+    struct ElementWriteFinder final : RecursiveVisitor {
+        bool found {};
+
+        void VisitAstBinaryExpression(const BinaryExpression& binaryExpression) override
+        {
+            // Assignment operators come first in `BinaryOp`. A field of an element, `s[i].x`, is
+            // written through the slice as well.
+            auto leftOprand = binaryExpression.leftOprand.get();
+            while (true) {
+                if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(leftOprand)) {
+                    leftOprand = unaryExpression->oprand.get();
+                } else if (auto memberExpression = dynamic_cast<const MemberExpression*>(leftOprand)) {
+                    leftOprand = memberExpression->objectExpression.get();
+                } else {
+                    break;
+                }
+            }
+            found = found || (binaryExpression.op <= BinaryOp::BitOrAssignment && dynamic_cast<const IndexExpression*>(leftOprand));
+            RecursiveVisitor::VisitAstBinaryExpression(binaryExpression);
+        }
+
+        void VisitAstFunctionCallExpression(const FunctionCallExpression& functionCallExpression) override
+        {
+            auto identifierExpression = dynamic_cast<const IdentifierExpression*>(functionCallExpression.funcExpression.get());
+            found = found || (identifierExpression && (identifierExpression->fullName == "std::push" || identifierExpression->fullName == "std::store"));
+            RecursiveVisitor::VisitAstFunctionCallExpression(functionCallExpression);
+        }
+    };
+
+    // Without slice parameters, all slices of a function refer to its own variables.
+    static bool WritesThroughSlices(const FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        const auto& variableDeclarations = functionDefinitionStatement.headerScope.variableDeclarations;
+        if (std::ranges::none_of(variableDeclarations, [](const auto& variableDeclaration) { return ContainsSlice(variableDeclaration->typeInfo); })) {
+            return false;
+        }
+        auto finder = ElementWriteFinder {};
+        finder.VisitAstScope(functionDefinitionStatement.bodyScope);
+        return finder.found;
+    }
+
+    struct TaskFinder final : RecursiveVisitor {
+        bool found {};
+
+        void VisitAstAwaitExpression(const AwaitExpression& awaitExpression) override
+        {
+            found = true;
+        }
+
+        void VisitAstSpawnExpression(const SpawnExpression& spawnExpression) override
+        {
+            found = true;
+        }
+    };
+
+    static bool UsesTasks(const FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        auto finder = TaskFinder {};
+        finder.VisitAstScope(functionDefinitionStatement.bodyScope);
+        return finder.found;
+    }
+
+    static bool HasRefParameters(const FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        return std::ranges::any_of(functionDefinitionStatement.headerScope.variableDeclarations, [](const auto& variableDeclaration) { return variableDeclaration->parameterMode == ParameterMode::Ref; });
+    }
+
+    static bool ContainsSlice(const TypeInfo& typeInfo)
+    {
+        return typeInfo.kind == TypeKind::Slice || (typeInfo.elementType && ContainsSlice(*typeInfo.elementType));
+    }
+
+    static Purity GetArgumentsPurity(const FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        const auto& variableDeclarations = functionDefinitionStatement.headerScope.variableDeclarations;
+        auto isScalar = [](const auto& variableDeclaration) { return variableDeclaration->typeInfo.IsIntegral() && variableDeclaration->parameterMode == ParameterMode::Value; };
+        return std::ranges::all_of(variableDeclarations, isScalar) ? Purity::Const : Purity::Pure;
+    }
+
+    std::unordered_map<std::string, Purity> m_purities {};
+};
+
+}
\ No newline at end of file
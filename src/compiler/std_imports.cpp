@@ -0,0 +1,88 @@
+module;
+
+#include <set>
+#include <string_view>
+#include <unordered_map>
+
+export module scc.compiler:std_imports;
+import :printer;
+
+namespace scc::compiler {
+
+// The module of `scc.std` declaring each name the translators print.
+const std::unordered_map<std::string_view, std::string_view> s_stdModules {
+    { "find_case", "scc.std.find_case" },
+    { "memo_table", "scc.std.memo_table" },
+    { "fork_join", "scc.std.fork_join" },
+    { "parallel_for", "scc.std.parallel_for" },
+    { "reduce_sum", "scc.std.parallel_for" },
+    { "await", "scc.std.spawn" },
+    { "spawn", "scc.std.spawn" },
+    { "task_handle", "scc.std.spawn" },
+    { "format_part", "scc.std.print_parts" },
+    { "print_parts", "scc.std.print_parts" },
+    { "print", "scc.std.println" },
+    { "println", "scc.std.println" },
+    { "write", "scc.std.println" },
+    { "array", "scc.std.sequence" },
+    { "fixed_column", "scc.std.sequence" },
+    { "len", "scc.std.sequence" },
+    { "push", "scc.std.sequence" },
+    { "slice", "scc.std.sequence" },
+    { "soa", "scc.std.sequence" },
+    { "vector", "scc.std.sequence" },
+    { "all", "scc.std.simd" },
+    { "any", "scc.std.simd" },
+    { "count", "scc.std.simd" },
+    { "mask", "scc.std.simd" },
+    { "reduce_add", "scc.std.simd" },
+    { "reduce_min", "scc.std.simd" },
+    { "reduce_max", "scc.std.simd" },
+    { "select", "scc.std.simd" },
+    { "shift_up", "scc.std.simd" },
+    { "simd", "scc.std.simd" },
+    { "store", "scc.std.simd" },
+    { "i8", "scc.std.types" },
+    { "i16", "scc.std.types" },
+    { "i32", "scc.std.types" },
+    { "i64", "scc.std.types" },
+    { "u8", "scc.std.types" },
+    { "u16", "scc.std.types" },
+    { "u32", "scc.std.types" },
+    { "u64", "scc.std.types" },
+    { "f32", "scc.std.types" },
+    { "f64", "scc.std.types" },
+};
+
+// The modules of `scc.std` a generated file refers to. Generated files only import the runtime
+// they use, so clang loads and links less of it for small programs. The translators find the
+// modules before printing, so the imports come first and the rest is written as it's translated.
+export struct StdImports final {
+    std::set<std::string_view> modules {};
+
+    // Adds the module declaring `name`, which is printed as `scc::std::name`. A name of no known
+    // module needs the whole `scc.std`.
+    void AddName(std::string_view name)
+    {
+        auto it = s_stdModules.find(name);
+        modules.insert(it == s_stdModules.end() ? "scc.std" : it->second);
+    }
+
+    // Prints the imports and a blank line after them, except the ones `included` already has, e.g.
+    // the header of a split unit.
+    void Print(Printer& printer, const StdImports& included = {}) const
+    {
+        auto printed = false;
+        for (auto moduleName : modules) {
+            if (!included.modules.contains(moduleName)) {
+                printer.Println("import {};", moduleName);
+                printed = true;
+            }
+        }
+        if (printed) {
+            printer.Println();
+        }
+    }
+};
+
+}
\ No newline at end of file
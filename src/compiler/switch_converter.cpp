@@ -0,0 +1,164 @@
+module;
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+import scc.ast;
+
+export module scc.compiler:switch_converter;
+
+namespace scc::compiler {
+
+using namespace ast;
+
+// Turns chains of conditional statements which compare one integer variable with constants,
+//
+//     if (x == 1) { ... } else if (x == 5) { ... } else if (x == 9) { ... } else { ... }
+//
+// into switch statements, which the translator dispatches with a jump table or a binary search
+// instead of one comparison per branch. The conditions of the chain only read the variable, and a
+// branch only runs after all conditions before it, so comparing the value once is the same.
+//
+// The chain ends at the first condition which compares another variable, repeats a value or
+// compares with a value out of the range of the variable, and the rest becomes the `default`
+// case. Only chains with at least `s_minCases` cases are converted.
+//
+// The types are annotated by the `TypeChecker`, which must run first.
+export struct SwitchConverter final {
+    void ConvertCompileUnit(Scope& scope)
+    {
+        for (auto func : scope.GetFunctions()) {
+            ConvertScope(static_cast<FunctionDefinitionStatement*>(func)->bodyScope);
+        }
+        ConvertScope(scope);
+    }
+
+private:
+    static constexpr size_t s_minCases { 3 };
+
+    struct Comparison {
+        IdentifierExpression* variable {};
+        int64_t value {};
+    };
+
+    void ConvertScope(Scope& scope)
+    {
+        for (auto& statement : scope.statements) {
+            if (auto conditionalStatement = dynamic_cast<ConditionalStatement*>(statement.get())) {
+                if (auto switchStatement = ConvertChain(*conditionalStatement)) {
+                    statement = std::move(switchStatement);
+                }
+            }
+
+            if (auto conditionalStatement = dynamic_cast<ConditionalStatement*>(statement.get())) {
+                ConvertScope(conditionalStatement->trueScope);
+                ConvertScope(conditionalStatement->falseScope);
+            } else if (auto switchStatement = dynamic_cast<SwitchStatement*>(statement.get())) {
+                for (auto& switchCase : switchStatement->cases) {
+                    ConvertScope(switchCase.scope);
+                }
+            } else if (auto forLoopStatement = dynamic_cast<ForLoopStatement*>(statement.get())) {
+                ConvertScope(forLoopStatement->bodyScope);
+            }
+        }
+    }
+
+    std::unique_ptr<SwitchStatement> ConvertChain(ConditionalStatement& conditionalStatement)
+    {
+        auto links = std::vector<ConditionalStatement*> {};
+        auto comparisons = std::vector<Comparison> {};
+        auto values = std::unordered_set<int64_t> {};
+        for (auto link = &conditionalStatement; link;) {
+            auto comparison = MatchComparison(*link->conditionalExpression);
+            if (!comparison || (!comparisons.empty() && comparison->variable->fullName != comparisons.front().variable->fullName)) {
+                break;
+            }
+            if (!IsInRange(comparison->value, *comparison->variable->typeInfo) || !values.insert(comparison->value).second) {
+                break;
+            }
+            links.push_back(link);
+            comparisons.push_back(*comparison);
+
+            // `else if` is a conditional statement alone in the false branch.
+            const auto& falseStatements = link->falseScope.statements;
+            link = falseStatements.size() == 1 ? dynamic_cast<ConditionalStatement*>(falseStatements.front().get()) : nullptr;
+        }
+        if (links.size() < s_minCases) {
+            return nullptr;
+        }
+
+        auto cases = std::vector<SwitchCase> {};
+        for (size_t i = 0; i < links.size(); ++i) {
+            const auto& sourceRange = links[i]->conditionalExpression->sourceRange;
+            cases.push_back(SwitchCase { sourceRange, { CaseValue { sourceRange, comparisons[i].value } }, std::move(links[i]->trueScope) });
+        }
+        if (auto& falseScope = links.back()->falseScope; !falseScope.statements.empty()) {
+            cases.push_back(SwitchCase { links.back()->sourceRange, {}, std::move(falseScope) });
+        }
+
+        // Take the variable from the first condition before the chain is destroyed.
+        auto& condition = static_cast<BinaryExpression&>(*UnwrapBrackets(*conditionalStatement.conditionalExpression));
+        auto& variable = dynamic_cast<IdentifierExpression*>(UnwrapBrackets(*condition.leftOprand)) ? condition.leftOprand : condition.rightOprand;
+        return std::make_unique<SwitchStatement>(conditionalStatement.sourceRange, std::move(variable), std::move(cases));
+    }
+
+    // Matches `x == c` or `c == x`, where `x` is an integer variable and `c` an integer literal.
+    static std::optional<Comparison> MatchComparison(Expression& expression)
+    {
+        auto binaryExpression = dynamic_cast<BinaryExpression*>(UnwrapBrackets(expression));
+        if (!binaryExpression || binaryExpression->op != BinaryOp::Equal) {
+            return std::nullopt;
+        }
+
+        auto left = UnwrapBrackets(*binaryExpression->leftOprand);
+        auto right = UnwrapBrackets(*binaryExpression->rightOprand);
+        auto variable = dynamic_cast<IdentifierExpression*>(left);
+        auto value = GetLiteralValue(*right);
+        if (!variable) {
+            variable = dynamic_cast<IdentifierExpression*>(right);
+            value = GetLiteralValue(*left);
+        }
+        if (!variable || !value || !variable->typeInfo || variable->typeInfo->kind != TypeKind::Integer) {
+            return std::nullopt;
+        }
+        return Comparison { variable, *value };
+    }
+
+    static std::optional<int64_t> GetLiteralValue(Expression& expression)
+    {
+        auto negative = false;
+        auto literal = &expression;
+        if (auto unaryExpression = dynamic_cast<UnaryExpression*>(literal); unaryExpression && unaryExpression->op == UnaryOp::Minus) {
+            negative = true;
+            literal = UnwrapBrackets(*unaryExpression->oprand);
+        }
+        auto integerLiteralExpression = dynamic_cast<IntegerLiteralExpression*>(literal);
+        if (!integerLiteralExpression || integerLiteralExpression->value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+            return std::nullopt;
+        }
+        auto value = static_cast<int64_t>(integerLiteralExpression->value);
+        return negative ? -value : value;
+    }
+
+    static Expression* UnwrapBrackets(Expression& expression)
+    {
+        auto unaryExpression = dynamic_cast<UnaryExpression*>(&expression);
+        return unaryExpression && unaryExpression->op == UnaryOp::Bracket ? UnwrapBrackets(*unaryExpression->oprand) : &expression;
+    }
+
+    static bool IsInRange(int64_t value, const TypeInfo& type)
+    {
+        if (type.bits == 64) {
+            return type.isSigned || value >= 0;
+        }
+        auto min = type.isSigned ? -(int64_t { 1 } << (type.bits - 1)) : 0;
+        auto max = type.isSigned ? (int64_t { 1 } << (type.bits - 1)) - 1 : (int64_t { 1 } << type.bits) - 1;
+        return value >= min && value <= max;
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+module;
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+import scc.ast;
+
+export module scc.compiler:tail_call_eliminator;
+
+namespace scc::compiler {
+
+using namespace ast;
+
+// Makes tail calls run in constant stack space, whatever optimization level clang compiles with.
+//
+// When a function calls itself in a tail position outside of any loop, its body is wrapped in an
+// endless loop, and the call is replaced by assigning the arguments to the parameters and
+// continuing the loop. The remaining tail calls to functions with the same signature, e.g. mutually
+// recursive functions or self calls inside a loop, are emitted with `[[clang::musttail]]` unless
+// variables with destructors are in scope.
+export struct TailCallEliminator final {
+    void EliminateCompileUnit(Scope& scope)
+    {
+        for (auto func : scope.GetFunctions()) {
+            const auto& functionDefinitionStatement = *static_cast<FunctionDefinitionStatement*>(func);
+            if (!HasReferenceParameters(functionDefinitionStatement)) {
+                m_signatures[functionDefinitionStatement.name] = GetSignature(functionDefinitionStatement);
+            }
+        }
+
+        for (auto func : scope.GetFunctions()) {
+            auto& functionDefinitionStatement = *static_cast<FunctionDefinitionStatement*>(func);
+            if (functionDefinitionStatement.name == "main" || HasReferenceParameters(functionDefinitionStatement)) {
+                continue;
+            }
+
+            m_function = &functionDefinitionStatement;
+            if (RewriteSelfTailCalls(functionDefinitionStatement.bodyScope, /*loopDepth=*/0)) {
+                WrapBodyInLoop(functionDefinitionStatement);
+            }
+            MarkMustTailCalls(functionDefinitionStatement.bodyScope, HasDestructors(functionDefinitionStatement.headerScope));
+            m_function = nullptr;
+        }
+    }
+
+private:
+    struct VariableReadCollector final : RecursiveVisitor {
+        std::unordered_set<std::string> names {};
+
+        void VisitAstIdentifierExpression(const IdentifierExpression& identifierExpression) override
+        {
+            names.insert(identifierExpression.fullName);
+        }
+    };
+
+    bool RewriteSelfTailCalls(Scope& scope, int loopDepth)
+    {
+        auto rewritten = false;
+        for (size_t i = 0; i < scope.statements.size(); ++i) {
+            auto statement = scope.statements[i].get();
+            if (auto returnStatement = dynamic_cast<ReturnStatement*>(statement)) {
+                if (loopDepth == 0 && IsSelfCall(returnStatement->expression.get())) {
+                    auto statements = RewriteSelfTailCall(scope, *returnStatement);
+
+                    // The statements after the return are unreachable.
+                    scope.statements.erase(scope.statements.begin() + i, scope.statements.end());
+                    for (auto& newStatement : statements) {
+                        scope.statements.push_back(std::move(newStatement));
+                    }
+                    return true;
+                }
+            } else if (auto conditionalStatement = dynamic_cast<ConditionalStatement*>(statement)) {
+                rewritten = RewriteSelfTailCalls(conditionalStatement->trueScope, loopDepth) || rewritten;
+                rewritten = RewriteSelfTailCalls(conditionalStatement->falseScope, loopDepth) || rewritten;
+            } else if (auto switchStatement = dynamic_cast<SwitchStatement*>(statement)) {
+                // 'continue' passes through the C++ switch to the loop around the body.
+                for (auto& switchCase : switchStatement->cases) {
+                    rewritten = RewriteSelfTailCalls(switchCase.scope, loopDepth) || rewritten;
+                }
+            } else if (auto forLoopStatement = dynamic_cast<ForLoopStatement*>(statement)) {
+                // 'continue' would restart the inner loop, leave the call to `MarkMustTailCalls`.
+                rewritten = RewriteSelfTailCalls(forLoopStatement->bodyScope, loopDepth + 1) || rewritten;
+            }
+        }
+        return rewritten;
+    }
+
+    // Returns the statements which assign the arguments of the call to the parameters, and restart
+    // the function body.
+    std::vector<std::unique_ptr<Statement>> RewriteSelfTailCall(Scope& scope, ReturnStatement& returnStatement)
+    {
+        auto& args = static_cast<FunctionCallExpression*>(returnStatement.expression.get())->argsExpression;
+        const auto& parameters = m_function->headerScope.variableDeclarations;
+        const auto& sourceRange = returnStatement.sourceRange;
+
+        // An argument which reads a parameter assigned before it must be evaluated into a temporary
+        // first, e.g. `return gcd(b, a % b);`.
+        auto useTemporaries = false;
+        auto assigned = std::unordered_set<std::string> {};
+        for (size_t i = 0; i < args.size(); ++i) {
+            auto collector = VariableReadCollector {};
+            args[i]->Visit(collector);
+            for (const auto& name : collector.names) {
+                useTemporaries = useTemporaries || assigned.contains(name);
+            }
+            if (!IsVariable(*args[i], parameters[i]->name)) {
+                assigned.insert(parameters[i]->name);
+            }
+        }
+
+        auto statements = std::vector<std::unique_ptr<Statement>> {};
+        auto assignments = std::vector<std::unique_ptr<Statement>> {};
+        for (size_t i = 0; i < args.size(); ++i) {
+            const auto& parameter = *parameters[i];
+            if (IsVariable(*args[i], parameter.name)) {
+                continue;
+            }
+
+            auto value = std::move(args[i]);
+            if (useTemporaries) {
+                auto& temporary = *scope.variableDeclarations.emplace_back(std::make_unique<VariableDeclaration>(sourceRange, parameter.typeInfo, "scc_" + parameter.name, std::move(value)));
+                statements.push_back(std::make_unique<VariableDefinitionStatement>(sourceRange, temporary));
+                value = std::make_unique<IdentifierExpression>(sourceRange, temporary.name);
+            }
+
+            auto assignment = std::make_unique<BinaryExpression>(sourceRange, std::make_unique<IdentifierExpression>(sourceRange, parameter.name), BinaryOp::Assignment, std::move(value));
+            assignments.push_back(std::make_unique<ExpressionStatement>(sourceRange, std::move(assignment)));
+        }
+
+        for (auto& assignment : assignments) {
+            statements.push_back(std::move(assignment));
+        }
+        statements.push_back(std::make_unique<ContinueStatement>(sourceRange));
+        return statements;
+    }
+
+    void WrapBodyInLoop(FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        auto body = std::move(functionDefinitionStatement.bodyScope);
+
+        // Falling off the end of the body must still return. Other functions leave the loop and fall
+        // off their end as before, which clang diagnoses, instead of looping forever.
+        auto last = body.statements.empty() ? nullptr : body.statements.back().get();
+        if (functionDefinitionStatement.typeInfo.fullName == "void") {
+            if (!dynamic_cast<ReturnStatement*>(last)) {
+                body.statements.push_back(std::make_unique<ReturnStatement>(functionDefinitionStatement.sourceRange, nullptr));
+            }
+        } else if (!dynamic_cast<ReturnStatement*>(last) && !dynamic_cast<ContinueStatement*>(last)) {
+            body.statements.push_back(std::make_unique<BreakStatement>(functionDefinitionStatement.sourceRange));
+        }
+
+        functionDefinitionStatement.bodyScope = Scope { &functionDefinitionStatement.headerScope };
+        functionDefinitionStatement.bodyScope.statements.push_back(std::make_unique<ForLoopStatement>(
+            functionDefinitionStatement.sourceRange, Scope { &functionDefinitionStatement.headerScope }, nullptr, nullptr, std::move(body)));
+    }
+
+    // Clang rejects `[[clang::musttail]]` while destructors are pending, so calls in the scope of
+    // variables with destructors are left to the optimizer.
+    void MarkMustTailCalls(Scope& scope, bool hasDestructors)
+    {
+        hasDestructors = hasDestructors || HasDestructors(scope);
+        for (const auto& statement : scope.statements) {
+            if (auto returnStatement = dynamic_cast<ReturnStatement*>(statement.get())) {
+                auto functionCallExpression = dynamic_cast<FunctionCallExpression*>(returnStatement->expression.get());
+                auto identifierExpression = functionCallExpression ? dynamic_cast<IdentifierExpression*>(functionCallExpression->funcExpression.get()) : nullptr;
+                if (identifierExpression && identifierExpression->fullName != "main" && !hasDestructors) {
+                    auto it = m_signatures.find(identifierExpression->fullName);
+                    returnStatement->mustTail = it != m_signatures.end() && it->second == m_signatures[m_function->name];
+                }
+            } else if (auto conditionalStatement = dynamic_cast<ConditionalStatement*>(statement.get())) {
+                MarkMustTailCalls(conditionalStatement->trueScope, hasDestructors);
+                MarkMustTailCalls(conditionalStatement->falseScope, hasDestructors);
+            } else if (auto switchStatement = dynamic_cast<SwitchStatement*>(statement.get())) {
+                for (auto& switchCase : switchStatement->cases) {
+                    MarkMustTailCalls(switchCase.scope, hasDestructors);
+                }
+            } else if (auto forLoopStatement = dynamic_cast<ForLoopStatement*>(statement.get())) {
+                MarkMustTailCalls(forLoopStatement->bodyScope, hasDestructors || HasDestructors(forLoopStatement->initScope));
+            }
+        }
+    }
+
+    bool IsSelfCall(const Expression* expression) const
+    {
+        auto functionCallExpression = dynamic_cast<const FunctionCallExpression*>(expression);
+        if (!functionCallExpression || functionCallExpression->argsExpression.size() != m_function->headerScope.variableDeclarations.size()) {
+            return false;
+        }
+        auto identifierExpression = dynamic_cast<const IdentifierExpression*>(functionCallExpression->funcExpression.get());
+        return identifierExpression && identifierExpression->fullName == m_function->name;
+    }
+
+    static bool IsVariable(const Expression& expression, const std::string& name)
+    {
+        auto identifierExpression = dynamic_cast<const IdentifierExpression*>(&expression);
+        return identifierExpression && identifierExpression->fullName == name;
+    }
+
+    // `in`, `ref` and `move` parameters may refer to variables of the caller, which can't be
+    // reassigned in a loop or outlive a frame reused by a tail call, so these functions are kept.
+    static bool HasReferenceParameters(const FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        return std::ranges::any_of(functionDefinitionStatement.headerScope.variableDeclarations, [](const auto& variableDeclaration) { return variableDeclaration->parameterMode != ParameterMode::Value; });
+    }
+
+    static bool HasDestructors(const Scope& scope)
+    {
+        return std::ranges::any_of(scope.variableDeclarations, [](const auto& variableDeclaration) { return HasDestructor(variableDeclaration->typeInfo); });
+    }
+
+    // Vectors and task handles own memory, as do arrays and structs containing them.
+    static bool HasDestructor(const TypeInfo& typeInfo)
+    {
+        switch (typeInfo.kind) {
+        case TypeKind::Vector:
+        case TypeKind::Task:
+            return true;
+        case TypeKind::Array:
+            return HasDestructor(*typeInfo.elementType);
+        case TypeKind::Struct:
+            return std::ranges::any_of(typeInfo.fields, [](const auto& field) { return field.typeInfo && HasDestructor(*field.typeInfo); });
+        default:
+            return false;
+        }
+    }
+
+    // Clang only allows `[[clang::musttail]]` between functions with the same signature.
+    static std::string GetSignature(const FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        auto signature = functionDefinitionStatement.typeInfo.fullName + "(";
+        for (const auto& variableDeclaration : functionDefinitionStatement.headerScope.variableDeclarations) {
+            signature += variableDeclaration->typeInfo.fullName + ",";
+        }
+        return signature + ")";
+    }
+
+    FunctionDefinitionStatement* m_function {};
+    std::unordered_map<std::string, std::string> m_signatures {};
+};
+
+}
\ No newline at end of file
@@ -23,6 +23,7 @@ export enum TokenType {
     TOKEN_RETURN,
     TOKEN_SCOPE,
     TOKEN_INTEGER,
+    TOKEN_FLOAT,
     TOKEN_STRING,
     TOKEN_EQUAL,
     TOKEN_NOT_EQUAL,
@@ -41,6 +42,18 @@ export enum TokenType {
     TOKEN_BIT_XOR_ASSIGNMENT,
     TOKEN_BIT_OR_ASSIGNMENT,
     TOKEN_FOR,
+    TOKEN_STRUCT,
+    TOKEN_CONST,
+    TOKEN_CONSTEXPR,
+    TOKEN_CONSTEVAL,
+    TOKEN_PARALLEL,
+    TOKEN_SPAWN,
+    TOKEN_AWAIT,
+    TOKEN_SWITCH,
+    TOKEN_CASE,
+    TOKEN_DEFAULT,
+    TOKEN_EMBED,
+    TOKEN_BYTES,
 };
 
 export struct Token final {
@@ -111,6 +124,39 @@ struct std::formatter<scc::compiler::TokenType> {
         case scc::compiler::TOKEN_STRING:
             return std::format_to(ctx.out(), "STRING");
 
+        case scc::compiler::TOKEN_CONST:
+            return std::format_to(ctx.out(), "const");
+
+        case scc::compiler::TOKEN_CONSTEXPR:
+            return std::format_to(ctx.out(), "constexpr");
+
+        case scc::compiler::TOKEN_CONSTEVAL:
+            return std::format_to(ctx.out(), "consteval");
+
+        case scc::compiler::TOKEN_PARALLEL:
+            return std::format_to(ctx.out(), "parallel");
+
+        case scc::compiler::TOKEN_SPAWN:
+            return std::format_to(ctx.out(), "spawn");
+
+        case scc::compiler::TOKEN_AWAIT:
+            return std::format_to(ctx.out(), "await");
+
+        case scc::compiler::TOKEN_SWITCH:
+            return std::format_to(ctx.out(), "switch");
+
+        case scc::compiler::TOKEN_CASE:
+            return std::format_to(ctx.out(), "case");
+
+        case scc::compiler::TOKEN_DEFAULT:
+            return std::format_to(ctx.out(), "default");
+
+        case scc::compiler::TOKEN_EMBED:
+            return std::format_to(ctx.out(), "embed");
+
+        case scc::compiler::TOKEN_BYTES:
+            return std::format_to(ctx.out(), "BYTES");
+
         default:
             assert(false);
             return std::format_to(ctx.out(), "(TokenType: {})", type);
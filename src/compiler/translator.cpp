@@ -1,100 +1,116 @@
 module;
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include <optional>
 #include <ostream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 import scc.ast;
 
 export module scc.compiler:translator;
+import :exception;
+import :format_string;
+import :last_use_analysis;
 import :printer;
+import :purity_analysis;
+import :std_imports;
 
 namespace scc::compiler {
 
 using namespace ast;
 
 export struct Translator final : Visitor {
-    Translator(std::shared_ptr<std::ostream> out)
+    Translator(std::shared_ptr<std::ostream> out, unsigned threadCount = std::max(std::thread::hardware_concurrency(), 1u))
         : m_printer { std::move(out) }
+        , m_threadCount { threadCount }
     {
     }
 
-    void VisitAstBinaryExpression(const BinaryExpression& binaryExpression) override
+    // Translates the compile unit into a header, written to the output of the translator, and units
+    // including it as `headerName`. The header holds what the function definitions depend on, and
+    // the definitions are spread over the units by their size. The first unit also holds the
+    // embedded data and `main`.
+    void TranslateCompileUnit(const Scope& scope, std::string_view headerName, const std::vector<std::shared_ptr<std::ostream>>& units)
     {
-        binaryExpression.leftOprand->Visit(*this);
-        switch (binaryExpression.op) {
-        case BinaryOp::Assignment:
-            m_printer.Print(" = ");
-            break;
-        case BinaryOp::MulAssignment:
-            m_printer.Print(" *= ");
-            break;
-        case BinaryOp::DivAssignment:
-            m_printer.Print(" /= ");
-            break;
-        case BinaryOp::ModAssignment:
-            m_printer.Print(" %= ");
-            break;
-        case BinaryOp::AddAssignment:
-            m_printer.Print(" += ");
-            break;
-        case BinaryOp::SubAssignment:
-            m_printer.Print(" -= ");
-            break;
-        case BinaryOp::ShiftLeftAssignment:
-            m_printer.Print(" <<= ");
-            break;
-        case BinaryOp::ShiftRightAssignment:
-            m_printer.Print(" >>= ");
-            break;
-        case BinaryOp::BitAndAssignment:
-            m_printer.Print(" &= ");
-            break;
-        case BinaryOp::BitXorAssignment:
-            m_printer.Print(" ^= ");
-            break;
-        case BinaryOp::BitOrAssignment:
-            m_printer.Print(" |= ");
-            break;
+        assert(!scope.parentScope && !units.empty());
+        auto functions = GetDistinctFunctions(scope);
+        auto embedExpressions = CollectEmbedExpressions(scope, functions);
+        m_purityAnalysis = std::make_shared<const PurityAnalysis>(scope);
+        auto headerImports = GetDeclarationImports(scope, functions);
+        m_printer.Println("// scc autogenerated file.");
+        m_printer.Println();
+        m_printer.Println("#pragma once");
+        m_printer.Println();
+        headerImports.Print(m_printer);
+        auto runTimeFunctions = PrintDeclarations(scope, functions, true);
 
-        case BinaryOp::Mul:
-            m_printer.Print(" * ");
-            break;
-        case BinaryOp::Div:
-            m_printer.Print(" / ");
-            break;
-        case BinaryOp::Mod:
-            m_printer.Print(" % ");
-            break;
-        case BinaryOp::Add:
-            m_printer.Print(" + ");
-            break;
-        case BinaryOp::Sub:
-            m_printer.Print(" - ");
-            break;
+        // The units may be compiled as soon as they are written, so the header must be complete
+        // before.
+        m_printer.Flush();
 
-        case BinaryOp::Equal:
-            m_printer.Print(" == ");
-            break;
-        case BinaryOp::NotEqual:
-            m_printer.Print(" != ");
-            break;
-        case BinaryOp::Less:
-            m_printer.Print(" < ");
-            break;
-        case BinaryOp::LessEqual:
-            m_printer.Print(" <= ");
-            break;
-        case BinaryOp::Greater:
-            m_printer.Print(" > ");
-            break;
-        case BinaryOp::GreaterEqual:
-            m_printer.Print(" >= ");
-            break;
+        // A unit only imports the modules the header doesn't.
+        auto unitFunctions = PartitionFunctions(runTimeFunctions, functions.end(), units.size());
+        for (size_t i = 0; i < units.size(); ++i) {
+            auto unit = Translator { units[i], m_threadCount, m_purityAnalysis, m_blobNames };
+            unit.m_printer.Println("// scc autogenerated file.");
+            unit.m_printer.Println();
+            unit.m_printer.Println("#include \"{}\"", headerName);
+            unit.m_printer.Println();
+            GetDefinitionImports(unitFunctions[i].begin(), unitFunctions[i].end(), i == 0 ? &scope : nullptr).Print(unit.m_printer, headerImports);
+            if (i == 0) {
+                unit.PrintBlobDefinitions(embedExpressions);
+            }
+            unit.PrintFunctionDefinitions("// function definitions", unitFunctions[i].begin(), unitFunctions[i].end());
+            if (i == 0) {
+                unit.PrintMain(scope);
+            }
+        }
+    }
 
-        default:
-            assert(false);
+    void VisitAstArrayLiteralExpression(const ArrayLiteralExpression& arrayLiteralExpression) override
+    {
+        assert(arrayLiteralExpression.typeInfo);
+        m_printer.Print("{} {{ ", GetTypeName(*arrayLiteralExpression.typeInfo));
+        PrintArrayElements(arrayLiteralExpression);
+        m_printer.Print(" }}");
+    }
+
+    void VisitAstAwaitExpression(const AwaitExpression& awaitExpression) override
+    {
+        m_printer.Print("scc::std::await(");
+        awaitExpression.oprand->Visit(*this);
+        m_printer.Print(")");
+    }
+
+    void VisitAstBinaryExpression(const BinaryExpression& binaryExpression) override
+    {
+        if (CanForkJoin(m_currentFunction, binaryExpression)) {
+            // Evaluate the operands in parallel, the right one may be stolen by another worker.
+            m_printer.Print("scc::std::fork_join([&] {{ return ");
+            binaryExpression.leftOprand->Visit(*this);
+            m_printer.Print("; }}, [&] {{ return ");
+            binaryExpression.rightOprand->Visit(*this);
+            m_printer.Print("; }}, [](auto scc_left, auto scc_right) {{ return scc_left {} scc_right; }})", GetBinaryOperator(binaryExpression.op));
+            return;
         }
+
+        binaryExpression.leftOprand->Visit(*this);
+        m_printer.Print(" {} ", GetBinaryOperator(binaryExpression.op));
         binaryExpression.rightOprand->Visit(*this);
     }
 
@@ -108,8 +124,21 @@ export struct Translator final : Visitor {
         conditionalStatement.conditionalExpression->Visit(*this);
         m_printer.Println(")");
         VisitAstScope(conditionalStatement.trueScope);
-        m_printer.Println("else");
-        VisitAstScope(conditionalStatement.falseScope);
+        if (!conditionalStatement.falseScope.statements.empty()) {
+            m_printer.Println("else");
+            VisitAstScope(conditionalStatement.falseScope);
+        }
+    }
+
+    void VisitAstContinueStatement(const ContinueStatement& continueStatement) override
+    {
+        m_printer.Println("continue;");
+    }
+
+    void VisitAstEmbedExpression(const EmbedExpression& embedExpression) override
+    {
+        assert(m_blobNames.contains(&embedExpression));
+        m_printer.Write(m_blobNames.at(&embedExpression));
     }
 
     void VisitAstExpressionStatement(const ExpressionStatement& expressionStatement) override
@@ -119,29 +148,56 @@ export struct Translator final : Visitor {
         m_printer.Println(";");
     }
 
+    void VisitAstFloatLiteralExpression(const FloatLiteralExpression& floatLiteralExpression) override
+    {
+        // The shortest spelling which reads back as the same value, kept a floating point literal.
+        auto value = std::format("{}", floatLiteralExpression.value);
+        if (value.find_first_of(".e") == std::string::npos) {
+            value += ".0";
+        }
+        m_printer.Print("{}{}", value, floatLiteralExpression.isSinglePrecision ? "f" : "");
+    }
+
     void VisitAstFunctionCallExpression(const FunctionCallExpression& functionCallExpression) override
     {
         assert(functionCallExpression.funcExpression);
-        functionCallExpression.funcExpression->Visit(*this);
+        if (IsPrintWithLiteralFormat(functionCallExpression) && PrintFormattedCall(functionCallExpression)) {
+            return;
+        }
+        if (PrintSoaFunctionCall(functionCallExpression)) {
+            return;
+        }
+        if (IsSimdConstruction(functionCallExpression)) {
+            m_printer.Write(GetTypeName(*functionCallExpression.typeInfo));
+        } else {
+            functionCallExpression.funcExpression->Visit(*this);
+        }
 
         m_printer.Print("(");
-        if (!functionCallExpression.argsExpression.empty()) {
-            auto it = functionCallExpression.argsExpression.begin();
-            assert(*it);
-            (*it)->Visit(*this);
-            while (++it != functionCallExpression.argsExpression.end()) {
-                m_printer.Print(", ");
-                (*it)->Visit(*this);
-            }
+        for (size_t i = 0; i < functionCallExpression.argsExpression.size(); ++i) {
+            assert(functionCallExpression.argsExpression[i]);
+            m_printer.Write(i ? ", " : "");
+            PrintArgument(functionCallExpression, i);
         }
         m_printer.Print(")");
     }
 
     void VisitFunctionDefinitionStatement(const FunctionDefinitionStatement& functionDefinitionStatement) override
     {
-        PrintFunctionHeader(functionDefinitionStatement);
-        m_printer.Println();
-        VisitAstScope(functionDefinitionStatement.bodyScope);
+        m_currentFunction = &functionDefinitionStatement;
+        m_lastUseAnalysis.emplace(functionDefinitionStatement);
+        if (functionDefinitionStatement.HasAttribute("memo")) {
+            PrintFunctionHeader(functionDefinitionStatement, s_uncachedSuffix);
+            m_printer.Println();
+            VisitAstScope(functionDefinitionStatement.bodyScope);
+            m_printer.Println();
+            PrintMemoizedFunction(functionDefinitionStatement);
+        } else {
+            PrintFunctionHeader(functionDefinitionStatement);
+            m_printer.Println();
+            VisitAstScope(functionDefinitionStatement.bodyScope);
+        }
+        m_currentFunction = nullptr;
     }
 
     void VisitAstIdentifierExpression(const IdentifierExpression& identifierExpression) override
@@ -149,17 +205,47 @@ export struct Translator final : Visitor {
         if (identifierExpression.fullName.starts_with("std::")) {
             m_printer.Print("scc::{}", identifierExpression.fullName);
         } else {
-            m_printer.Print(identifierExpression.fullName);
+            m_printer.Write(GetFunctionName(identifierExpression.fullName));
         }
     }
 
+    void VisitAstIndexExpression(const IndexExpression& indexExpression) override
+    {
+        // Unchecked elements are read through the pointer, which keeps the loops vectorizable.
+        indexExpression.arrayExpression->Visit(*this);
+        m_printer.Write(indexExpression.checked ? "[" : ".data()[");
+        indexExpression.indexExpression->Visit(*this);
+        m_printer.Print("]");
+    }
+
     void VisitAstIntegerLiteralExpression(const IntegerLiteralExpression& integerLiteralExpression) override
     {
         m_printer.Print("{}", integerLiteralExpression.value);
     }
 
+    void VisitAstMemberExpression(const MemberExpression& memberExpression) override
+    {
+        // A field of an element of a struct of arrays is an element of the array of the field,
+        // `a[i].x` is `a.x[i]`.
+        auto indexExpression = dynamic_cast<const IndexExpression*>(memberExpression.objectExpression.get());
+        if (indexExpression && indexExpression->arrayExpression->typeInfo && indexExpression->arrayExpression->typeInfo->isSoa) {
+            indexExpression->arrayExpression->Visit(*this);
+            m_printer.Print(".{}{}", memberExpression.memberName, indexExpression->checked ? "[" : ".data()[");
+            indexExpression->indexExpression->Visit(*this);
+            m_printer.Print("]");
+        } else {
+            memberExpression.objectExpression->Visit(*this);
+            m_printer.Print(".{}", memberExpression.memberName);
+        }
+    }
+
     void VisitAstForLoopStatement(const ForLoopStatement& forLoopStatement) override
     {
+        if (forLoopStatement.isParallel) {
+            PrintParallelForLoop(forLoopStatement);
+            return;
+        }
+
         m_printer.Println("{{");
         m_printer.PushIndent();
 
@@ -187,6 +273,9 @@ export struct Translator final : Visitor {
 
     void VisitReturnStatement(const ReturnStatement& returnStatement) override
     {
+        if (returnStatement.mustTail) {
+            m_printer.Print("[[clang::musttail]] ");
+        }
         if (returnStatement.expression) {
             m_printer.Print("return ");
             returnStatement.expression->Visit(*this);
@@ -199,33 +288,21 @@ export struct Translator final : Visitor {
     void VisitAstScope(const Scope& scope) override
     {
         if (!scope.parentScope) {
-            // Output declare for global scope.
+            // The imports are known before anything is printed, so the output is written as it's
+            // translated, and clang++ reading it from a pipe starts with the modules while the
+            // functions are translated.
+            auto functions = GetDistinctFunctions(scope);
+            m_purityAnalysis = std::make_shared<const PurityAnalysis>(scope);
+            auto imports = GetDeclarationImports(scope, functions);
+            imports.modules.merge(GetDefinitionImports(functions.begin(), functions.end(), &scope).modules);
             m_printer.Println("// scc autogenerated file.");
             m_printer.Println();
-            m_printer.Println("import scc.std;");
-            m_printer.Println();
-
-            // Output function forward declaration.
-            auto functions = scope.GetFunctions();
-            if (!functions.empty()) {
-                m_printer.Println("// function declarations");
-                for (const auto& func : functions) {
-                    PrintFunctionHeader(*static_cast<FunctionDefinitionStatement*>(func));
-                    m_printer.Println(";");
-                }
-                m_printer.Println("int main();");
-                m_printer.Println();
-
-                // Output function.
-                m_printer.Println("// function definitions");
-                for (const auto& func : functions) {
-                    VisitFunctionDefinitionStatement(*static_cast<FunctionDefinitionStatement*>(func));
-                    m_printer.Println();
-                }
-            }
-
-            // Output main.
-            m_printer.Println("int main()");
+            imports.Print(m_printer);
+            auto runTimeFunctions = PrintDeclarations(scope, functions, false);
+            m_printer.Flush();
+            PrintFunctionDefinitions("// function definitions", runTimeFunctions, functions.end());
+            PrintMain(scope);
+            return;
         }
 
         m_printer.Println("{{");
@@ -233,70 +310,623 @@ export struct Translator final : Visitor {
         for (const auto& statement : scope.statements) {
             statement->Visit(*this);
         }
-
-        if (!scope.parentScope) {
-            m_printer.Println("return 0;");
-        }
         m_printer.PopIndent();
         m_printer.Println("}}");
     }
 
+    void VisitAstSliceExpression(const SliceExpression& sliceExpression) override
+    {
+        sliceExpression.arrayExpression->Visit(*this);
+        m_printer.Print(".subslice(");
+        if (sliceExpression.beginExpression) {
+            sliceExpression.beginExpression->Visit(*this);
+        } else if (sliceExpression.endExpression) {
+            m_printer.Print("0");
+        }
+        if (sliceExpression.endExpression) {
+            m_printer.Print(", ");
+            sliceExpression.endExpression->Visit(*this);
+        }
+        m_printer.Print(")");
+    }
+
+    void VisitAstSpawnExpression(const SpawnExpression& spawnExpression) override
+    {
+        // The arguments are copied into the task, as it may outlive the spawning function. A memoized
+        // function called by the task uses the memo table of the worker thread running it.
+        m_printer.Print("scc::std::spawn([=] {{ return ");
+        spawnExpression.callExpression->Visit(*this);
+        m_printer.Print("; }})");
+    }
+
     void VisitAstStringLiteralExpression(const StringLiteralExpression& stringLiteralExpression) override
     {
-        m_printer.Print("\"");
-        for (const auto ch : stringLiteralExpression.value) {
-            if (std::isprint(ch)) {
-                m_printer.Print("{}", ch);
-            } else {
-                m_printer.Print("\\{:#03o}", ch);
+        m_printer.WriteString(stringLiteralExpression.value);
+    }
+
+    // Compact case values are dispatched by a C++ switch, which clang lowers to a jump table. Sparse
+    // values are found in a sorted table by binary search first, and the switch dispatches on their
+    // position in the table, which is compact.
+    void VisitAstSwitchStatement(const SwitchStatement& switchStatement) override
+    {
+        auto values = std::vector<int64_t> {};
+        for (const auto& switchCase : switchStatement.cases) {
+            for (const auto& caseValue : switchCase.values) {
+                values.push_back(caseValue.value);
+            }
+        }
+        std::ranges::sort(values);
+
+        auto dense = IsDense(values);
+        if (dense) {
+            m_printer.Print("switch (");
+            switchStatement.conditionalExpression->Visit(*this);
+            m_printer.Println(")");
+        } else {
+            auto table = std::string {};
+            for (auto value : values) {
+                table += std::format("{}{}", table.empty() ? "" : ", ", FormatInteger(value));
+            }
+            // C++20 doesn't allow static variables in constexpr functions.
+            auto isCompileTime = m_currentFunction && m_currentFunction->constness != Constness::None;
+            m_printer.Println("{{");
+            m_printer.PushIndent();
+            m_printer.Println("{}constexpr {} scc_case_values[] {{ {} }};", isCompileTime ? "" : "static ", GetTypeName(*switchStatement.conditionalExpression->typeInfo), table);
+            m_printer.Print("switch (scc::std::find_case(scc_case_values, ");
+            switchStatement.conditionalExpression->Visit(*this);
+            m_printer.Println("))");
+        }
+
+        m_printer.Println("{{");
+        for (const auto& switchCase : switchStatement.cases) {
+            if (switchCase.values.empty()) {
+                m_printer.Println("default:");
+            }
+            for (const auto& caseValue : switchCase.values) {
+                auto label = dense ? caseValue.value : static_cast<int64_t>(std::ranges::lower_bound(values, caseValue.value) - values.begin());
+                m_printer.Println("case {}:", FormatInteger(label));
             }
+            m_printer.PushIndent();
+            VisitAstScope(switchCase.scope);
+            m_printer.Println("break;");
+            m_printer.PopIndent();
+        }
+        m_printer.Println("}}");
+
+        if (!dense) {
+            m_printer.PopIndent();
+            m_printer.Println("}}");
         }
-        m_printer.Print("\"");
     }
 
-    void VisitAstUnaryExpression(const UnaryExpression& unaryExpression) override
+    // A jump table over the range of the values is worth it if at least half of its entries are
+    // cases, and a few cases are compared one by one by clang anyway.
+    static bool IsDense(const std::vector<int64_t>& sortedValues)
     {
-        m_printer.Print("(");
+        if (sortedValues.size() <= s_maxCompareCases) {
+            return true;
+        }
+        auto range = static_cast<uint64_t>(sortedValues.back()) - static_cast<uint64_t>(sortedValues.front());
+        return range < 2 * sortedValues.size();
+    }
 
+    void VisitAstUnaryExpression(const UnaryExpression& unaryExpression) override
+    {
         assert(unaryExpression.oprand);
-        unaryExpression.oprand->Visit(*this);
+        switch (unaryExpression.op) {
+        case UnaryOp::Bracket:
+            m_printer.Print("(");
+            unaryExpression.oprand->Visit(*this);
+            m_printer.Print(")");
+            break;
 
-        m_printer.Print(")");
+        case UnaryOp::Minus:
+            m_printer.Print("-");
+            if (auto oprand = dynamic_cast<const UnaryExpression*>(unaryExpression.oprand.get()); oprand && oprand->op == UnaryOp::Minus) {
+                // Avoid printing '--', which is the decrement operator in C++.
+                m_printer.Print(" ");
+            }
+            unaryExpression.oprand->Visit(*this);
+            break;
+
+        default:
+            assert(false);
+        }
     }
 
     void VisitAstVariableDeclaration(const VariableDeclaration& variableDeclaration) override
     {
+        if (variableDeclaration.parameterMode == ParameterMode::In) {
+            m_printer.Print("const ");
+        }
         PrintTypeInfo(variableDeclaration.typeInfo);
+        switch (variableDeclaration.parameterMode) {
+        case ParameterMode::In:
+        case ParameterMode::Ref:
+            m_printer.Print("&");
+            break;
+        case ParameterMode::Move:
+            m_printer.Print("&&");
+            break;
+        default:
+            break;
+        }
         m_printer.Print(" ");
-        m_printer.Print(variableDeclaration.name);
+        m_printer.Write(variableDeclaration.name);
     }
 
     void VisitAstVariableDefinitionStatement(const VariableDefinitionStatement& variableDefinitionStatemet) override
     {
         const auto& variableDeclaration = variableDefinitionStatemet.variableDeclaration;
+        if (variableDeclaration.constness == Constness::Const && dynamic_cast<const EmbedExpression*>(variableDeclaration.initExpression.get())) {
+            // A constant refers to the embedded data instead of copying it.
+            m_printer.Print("const {}& {} {{ ", GetTypeName(variableDeclaration.typeInfo), variableDeclaration.name);
+            variableDeclaration.initExpression->Visit(*this);
+            m_printer.Println(" }};");
+            return;
+        }
+        if (variableDeclaration.constness != Constness::None) {
+            m_printer.Print("{} ", GetConstnessName(variableDeclaration.constness));
+        }
         VisitAstVariableDeclaration(variableDeclaration);
         m_printer.Print(" {{");
         if (variableDeclaration.initExpression) {
             m_printer.Print(" ");
-            variableDeclaration.initExpression->Visit(*this);
+            if (auto arrayLiteralExpression = dynamic_cast<const ArrayLiteralExpression*>(variableDeclaration.initExpression.get())) {
+                PrintArrayElements(*arrayLiteralExpression);
+            } else if (IsNarrowing(*variableDeclaration.initExpression, variableDeclaration.typeInfo)) {
+                // Brace initialization rejects the narrowing conversions scc does implicitly.
+                m_printer.Print("static_cast<{}>(", GetTypeName(variableDeclaration.typeInfo));
+                variableDeclaration.initExpression->Visit(*this);
+                m_printer.Print(")");
+            } else {
+                variableDeclaration.initExpression->Visit(*this);
+            }
             m_printer.Print(" ");
         }
         m_printer.Println("}};");
     }
 
 private:
+    // Translates functions of the compile unit translated by another translator, into a unit or a
+    // buffer of its own. The analyses of the compile unit are only read while the functions are
+    // translated.
+    Translator(std::shared_ptr<std::ostream> out, unsigned threadCount, std::shared_ptr<const PurityAnalysis> purityAnalysis, const std::unordered_map<const EmbedExpression*, std::string>& blobNames)
+        : m_printer { std::move(out) }
+        , m_threadCount { threadCount }
+        , m_purityAnalysis { std::move(purityAnalysis) }
+        , m_blobNames { blobNames }
+    {
+    }
+
+    // Generic instances which are the same function in C++, e.g. for `int` and `i32`, are only
+    // translated once.
+    static std::vector<Statement*> GetDistinctFunctions(const Scope& scope)
+    {
+        auto functions = scope.GetFunctions();
+        auto overloads = std::unordered_set<std::string> {};
+        std::erase_if(functions, [&](auto func) {
+            return !overloads.insert(GetOverloadKey(*static_cast<FunctionDefinitionStatement*>(func))).second;
+        });
+        return functions;
+    }
+
+    // Prints what the function definitions and `main` depend on. The compile-time functions come
+    // first, so the global constants can call them, and the constants come before the functions
+    // using them. Returns the run-time functions, which are left to define.
+    std::vector<Statement*>::iterator PrintDeclarations(const Scope& scope, std::vector<Statement*>& functions, bool isSplit)
+    {
+        // Output structs, they are declared in the global scope only.
+        if (!scope.GetStructTypes().empty()) {
+            m_printer.Println("// struct definitions");
+            for (const auto structType : scope.GetStructTypes()) {
+                PrintStructDefinition(*structType);
+                m_printer.Println();
+            }
+        }
+
+        // Output function forward declaration.
+        PrintEmbeddedData(scope, functions, isSplit);
+        if (!functions.empty()) {
+            m_printer.Println("// function declarations");
+            for (const auto& func : functions) {
+                const auto& functionDefinitionStatement = *static_cast<FunctionDefinitionStatement*>(func);
+                auto purity = m_purityAnalysis->GetPurity(functionDefinitionStatement.name);
+                PrintFunctionDeclaration(functionDefinitionStatement, purity);
+                if (functionDefinitionStatement.HasAttribute("memo")) {
+                    PrintFunctionDeclaration(functionDefinitionStatement, purity, s_uncachedSuffix);
+                }
+            }
+            m_printer.Println("int main();");
+            m_printer.Println();
+        }
+
+        auto runTimeFunctions = std::ranges::stable_partition(functions, [](auto func) {
+            return static_cast<FunctionDefinitionStatement*>(func)->constness != Constness::None;
+        }).begin();
+        PrintFunctionDefinitions("// compile-time function definitions", functions.begin(), runTimeFunctions);
+        if (std::ranges::any_of(scope.statements, IsGlobalConstant)) {
+            m_printer.Println("// constant definitions");
+            for (const auto& statement : scope.statements) {
+                if (IsGlobalConstant(statement)) {
+                    statement->Visit(*this);
+                }
+            }
+            m_printer.Println();
+        }
+        return runTimeFunctions;
+    }
+
+    void PrintMain(const Scope& scope)
+    {
+        m_lastUseAnalysis.emplace(scope);
+        m_printer.Println("int main()");
+        m_printer.Println("{{");
+        m_printer.PushIndent();
+        for (const auto& statement : scope.statements) {
+            if (!IsGlobalConstant(statement)) {
+                statement->Visit(*this);
+            }
+        }
+        m_printer.Println("return 0;");
+        m_printer.PopIndent();
+        m_printer.Println("}}");
+    }
+
+    // Every function goes to the unit with the fewest lines so far, the longest first, which keeps
+    // the units of about the same size. The functions keep their order within a unit.
+    static std::vector<std::vector<Statement*>> PartitionFunctions(std::vector<Statement*>::const_iterator first, std::vector<Statement*>::const_iterator last, size_t unitCount)
+    {
+        auto getLines = [&](size_t i) {
+            return (size_t)(first[i]->sourceRange.endLine - first[i]->sourceRange.startLine + 1);
+        };
+        auto order = std::vector<size_t>(last - first);
+        std::iota(order.begin(), order.end(), 0);
+        std::ranges::stable_sort(order, std::greater {}, getLines);
+
+        auto unitLines = std::vector<size_t>(unitCount);
+        auto unitIndices = std::vector<size_t>(last - first);
+        for (auto i : order) {
+            auto unit = std::ranges::min_element(unitLines) - unitLines.begin();
+            unitIndices[i] = unit;
+            unitLines[unit] += getLines(i);
+        }
+
+        auto units = std::vector<std::vector<Statement*>>(unitCount);
+        for (size_t i = 0; i < unitIndices.size(); ++i) {
+            units[unitIndices[i]].push_back(first[i]);
+        }
+        return units;
+    }
+
+    // A function is translated independently of the others, so many of them are split among
+    // threads, and printed in order afterwards. The output is the same as translating them one after
+    // the other. Every definition is written to the output once it's printed.
+    void PrintFunctionDefinitions(std::string_view comment, std::vector<Statement*>::const_iterator first, std::vector<Statement*>::const_iterator last)
+    {
+        if (first == last) {
+            return;
+        }
+        m_printer.Write(comment);
+        m_printer.Println();
+
+        auto threadCount = std::min<size_t>(m_threadCount, (last - first) / s_minFunctionsPerThread);
+        if (threadCount <= 1) {
+            for (; first != last; ++first) {
+                VisitFunctionDefinitionStatement(*static_cast<FunctionDefinitionStatement*>(*first));
+                m_printer.Println();
+                m_printer.Flush();
+            }
+            return;
+        }
+        for (const auto& definition : TranslateFunctions(first, last, threadCount)) {
+            m_printer.Append(definition);
+            m_printer.Flush();
+        }
+    }
+
+    // Every thread takes the next function which isn't translated yet, until all are.
+    std::vector<std::string> TranslateFunctions(std::vector<Statement*>::const_iterator first, std::vector<Statement*>::const_iterator last, size_t threadCount) const
+    {
+        auto definitions = std::vector<std::string>(last - first);
+        auto errors = std::vector<std::exception_ptr>(last - first);
+        auto next = std::atomic<size_t> {};
+        auto translate = [&]() {
+            auto translator = Translator { nullptr, 1, m_purityAnalysis, m_blobNames };
+            for (auto i = next++; i < definitions.size(); i = next++) {
+                try {
+                    translator.VisitFunctionDefinitionStatement(*static_cast<FunctionDefinitionStatement*>(first[i]));
+                    translator.m_printer.Println();
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+                definitions[i] = translator.m_printer.TakeText();
+            }
+        };
+
+        {
+            auto threads = std::vector<std::jthread> {};
+            for (size_t i = 1; i < threadCount; ++i) {
+                threads.emplace_back(translate);
+            }
+            translate();
+        }
+
+        // Translating one function after the other stops at the first error.
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        return definitions;
+    }
+
+    // Global `constexpr` variables are defined outside of `main`, so the functions can use them.
+    static bool IsGlobalConstant(const std::unique_ptr<Statement>& statement)
+    {
+        auto variableDefinitionStatement = dynamic_cast<const VariableDefinitionStatement*>(statement.get());
+        return variableDefinitionStatement && variableDefinitionStatement->variableDeclaration.constness == Constness::Constexpr;
+    }
+
     void PrintTypeInfo(const TypeInfo& typeInfo)
     {
-        m_printer.Print(typeInfo.fullName);
+        m_printer.Write(GetTypeName(typeInfo));
+    }
+
+    // Besides the struct itself, prints its struct of arrays as a specialization of
+    // `scc::std::soa`, with an array of the same kind for each field, and the `scc_push` appending
+    // to a vector of them.
+    void PrintStructDefinition(const TypeInfo& structType)
+    {
+        m_printer.Println("struct {}", structType.fullName);
+        m_printer.Println("{{");
+        m_printer.PushIndent();
+        for (const auto& field : structType.fields) {
+            m_printer.Println("{} {} {{}};", GetTypeName(*field.typeInfo), field.name);
+        }
+        m_printer.PopIndent();
+        m_printer.Println("}};");
+        m_printer.Println();
+
+        m_printer.Println("template <template <typename> typename scc_column>");
+        m_printer.Println("struct scc::std::soa<{}, scc_column>", structType.fullName);
+        m_printer.Println("{{");
+        m_printer.PushIndent();
+        for (const auto& field : structType.fields) {
+            m_printer.Println("scc_column<{}> {} {{}};", GetTypeName(*field.typeInfo), field.name);
+        }
+        m_printer.PopIndent();
+        m_printer.Println("}};");
+        m_printer.Println();
+
+        m_printer.Println("template <template <typename> typename scc_column>");
+        m_printer.Println("void scc_push(scc::std::soa<{0}, scc_column>& scc_soa, const {0}& scc_value)", structType.fullName);
+        m_printer.Println("{{");
+        m_printer.PushIndent();
+        for (const auto& field : structType.fields) {
+            m_printer.Println("scc::std::push(scc_soa.{0}, scc_value.{0});", field.name);
+        }
+        m_printer.PopIndent();
+        m_printer.Println("}}");
+    }
+
+    // `std::len` of a struct of arrays is the length of the array of its first field, and
+    // `std::push` appends to the array of every field.
+    bool PrintSoaFunctionCall(const FunctionCallExpression& functionCallExpression)
+    {
+        auto identifierExpression = dynamic_cast<const IdentifierExpression*>(functionCallExpression.funcExpression.get());
+        const auto& args = functionCallExpression.argsExpression;
+        if (!identifierExpression || args.empty() || !args[0]->typeInfo || !args[0]->typeInfo->isSoa) {
+            return false;
+        }
+
+        if (identifierExpression->fullName == "std::len") {
+            m_printer.Print("scc::std::len(");
+            args[0]->Visit(*this);
+            m_printer.Print(".{})", args[0]->typeInfo->elementType->fields.front().name);
+            return true;
+        } else if (identifierExpression->fullName == "std::push" && args.size() == 2) {
+            m_printer.Print("scc_push(");
+            args[0]->Visit(*this);
+            m_printer.Print(", ");
+            args[1]->Visit(*this);
+            m_printer.Print(")");
+            return true;
+        }
+        return false;
     }
 
-    void PrintFunctionHeader(const FunctionDefinitionStatement& functionDefinitionStatement)
+    // The body runs once per chunk of the iterations, with a copy of each reduction variable of its
+    // own, which shadows the shared variable, e.g.
+    //
+    //   scc::std::parallel_for<int>(0, n, [&](int scc_begin, int scc_end, scc::std::i64& total) {
+    //       for (int i = scc_begin; i < scc_end; i += 1)
+    //       ...
+    //   }, scc::std::reduce_sum(total));
+    void PrintParallelForLoop(const ForLoopStatement& forLoopStatement)
     {
+        const auto& loopVariable = *forLoopStatement.initScope.variableDeclarations.front();
+        const auto& condition = static_cast<const BinaryExpression&>(*forLoopStatement.conditionalExpression);
+        auto indexType = GetTypeName(loopVariable.typeInfo);
+
+        m_printer.Print("scc::std::parallel_for<{}>(", indexType);
+        loopVariable.initExpression->Visit(*this);
+        m_printer.Print(", ");
+        condition.rightOprand->Visit(*this);
+        m_printer.Print(", [&]({} scc_begin, {} scc_end", indexType, indexType);
+        for (const auto& reduction : forLoopStatement.reductions) {
+            m_printer.Print(", {}& {}", GetTypeName(reduction.variableDeclaration->typeInfo), reduction.variableName);
+        }
+        m_printer.Println(") {{");
+        m_printer.PushIndent();
+
+        m_printer.Print("for ({} {} = scc_begin; {} < scc_end; ", indexType, loopVariable.name, loopVariable.name);
+        forLoopStatement.iterationExpression->Visit(*this);
+        m_printer.Println(")");
+        VisitAstScope(forLoopStatement.bodyScope);
+
+        m_printer.PopIndent();
+        m_printer.Print("}}");
+        for (const auto& reduction : forLoopStatement.reductions) {
+            m_printer.Print(", scc::std::reduce_{}({})", GetReductionName(reduction.op), reduction.variableName);
+        }
+        m_printer.Println(");");
+    }
+
+    static std::string_view GetReductionName(ReductionOp op)
+    {
+        switch (op) {
+        case ReductionOp::Sum:
+            return "sum";
+        case ReductionOp::Min:
+            return "min";
+        case ReductionOp::Max:
+            return "max";
+        default:
+            assert(false);
+            return "";
+        }
+    }
+
+    void PrintArrayElements(const ArrayLiteralExpression& arrayLiteralExpression)
+    {
+        const auto& elementType = *arrayLiteralExpression.typeInfo->elementType;
+        for (size_t i = 0; i < arrayLiteralExpression.elementsExpression.size(); ++i) {
+            const auto& elementExpression = *arrayLiteralExpression.elementsExpression[i];
+            m_printer.Write(i ? ", " : "");
+            if (IsNarrowing(elementExpression, elementType)) {
+                m_printer.Print("static_cast<{}>(", GetTypeName(elementType));
+                elementExpression.Visit(*this);
+                m_printer.Print(")");
+            } else {
+                elementExpression.Visit(*this);
+            }
+        }
+    }
+
+    // Sized types are declared in `scc.std` with their exact width, as are the arrays, vectors,
+    // slices and SIMD types.
+    static std::string GetTypeName(const TypeInfo& typeInfo)
+    {
+        if (typeInfo.isSoa) {
+            auto column = typeInfo.kind == TypeKind::Array ? std::format("scc::std::fixed_column<{}>::type", typeInfo.length) : "scc::std::vector";
+            return std::format("scc::std::soa<{}, {}>", typeInfo.elementType->fullName, column);
+        } else if (typeInfo.kind == TypeKind::String) {
+            return "const char*";
+        } else if (typeInfo.kind == TypeKind::Array) {
+            return std::format("scc::std::array<{}, {}>", GetTypeName(*typeInfo.elementType), typeInfo.length);
+        } else if (typeInfo.kind == TypeKind::Vector) {
+            return std::format("scc::std::vector<{}>", GetTypeName(*typeInfo.elementType));
+        } else if (typeInfo.kind == TypeKind::Slice) {
+            return std::format("scc::std::slice<{}>", GetTypeName(*typeInfo.elementType));
+        } else if (typeInfo.kind == TypeKind::Task) {
+            return std::format("scc::std::task_handle<{}>", GetTypeName(*typeInfo.elementType));
+        } else if (typeInfo.kind == TypeKind::Simd) {
+            return std::format("scc::std::simd<{}, {}>", GetTypeName(*typeInfo.elementType), typeInfo.length);
+        } else if (typeInfo.kind == TypeKind::Mask) {
+            return std::format("scc::std::mask<{}, {}>", typeInfo.bits, typeInfo.length);
+        } else if ((typeInfo.kind == TypeKind::Integer && typeInfo.fullName != "int") || typeInfo.kind == TypeKind::Float) {
+            return "scc::std::" + typeInfo.fullName;
+        } else {
+            return typeInfo.fullName;
+        }
+    }
+
+    // Instances of generic functions, e.g. `max<f64>`, are overloads of the generic function.
+    static std::string_view GetFunctionName(std::string_view name)
+    {
+        return name.substr(0, name.find('<'));
+    }
+
+    // Instances whose type arguments are the same C++ type, e.g. `max<int>` and `max<i32>`, are the
+    // same overload, which is printed once.
+    static std::string GetOverloadKey(const FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        auto key = std::string { GetFunctionName(functionDefinitionStatement.name) };
+        for (const auto& variableDeclaration : functionDefinitionStatement.headerScope.variableDeclarations) {
+            key += ' ' + GetCanonicalTypeName(variableDeclaration->typeInfo);
+        }
+        return key;
+    }
+
+    static std::string GetCanonicalTypeName(const TypeInfo& typeInfo)
+    {
+        if (typeInfo.kind == TypeKind::Integer) {
+            return std::format("{}{}", typeInfo.isSigned ? 'i' : 'u', typeInfo.bits);
+        } else if (typeInfo.IsSequence() && !typeInfo.isSoa) {
+            return GetCanonicalTypeName(*typeInfo.elementType) + typeInfo.fullName.substr(typeInfo.fullName.rfind('['));
+        } else if (typeInfo.kind == TypeKind::Task) {
+            return std::format("task<{}>", GetCanonicalTypeName(*typeInfo.elementType));
+        }
+        return typeInfo.fullName;
+    }
+
+    // Returns true if the expression, annotated by the `TypeChecker`, has a different type which
+    // can't hold all its values. A literal whose value fits in the type is never narrowed.
+    static bool IsNarrowing(const Expression& expression, const TypeInfo& typeInfo)
+    {
+        if (typeInfo.kind == TypeKind::Simd && expression.typeInfo && expression.typeInfo->IsArithmetic()) {
+            // A scalar is broadcast to the lanes.
+            return IsNarrowing(expression, *typeInfo.elementType);
+        }
+        if (!expression.typeInfo || !typeInfo.IsArithmetic() || GetTypeName(*expression.typeInfo) == GetTypeName(typeInfo)) {
+            return false;
+        }
+
+        auto literal = &expression;
+        auto negative = false;
+        if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(&expression); unaryExpression && unaryExpression->op == UnaryOp::Minus) {
+            literal = unaryExpression->oprand.get();
+            negative = true;
+        }
+        if (dynamic_cast<const FloatLiteralExpression*>(literal)) {
+            return typeInfo.kind != TypeKind::Float;
+        }
+        auto integerLiteralExpression = dynamic_cast<const IntegerLiteralExpression*>(literal);
+        if (!integerLiteralExpression) {
+            return true;
+        }
+
+        auto value = integerLiteralExpression->value;
+        switch (typeInfo.kind) {
+        case TypeKind::Bool:
+            return negative || value > 1;
+        case TypeKind::Float:
+            // Integers are exact up to the width of the mantissa.
+            return value > (uint64_t { 1 } << (typeInfo.bits == 32 ? 24 : 53));
+        case TypeKind::Integer: {
+            auto max = typeInfo.isSigned ? (uint64_t { 1 } << (typeInfo.bits - 1)) - 1 : std::numeric_limits<uint64_t>::max() >> (64 - typeInfo.bits);
+            return negative ? !typeInfo.isSigned || value > max + 1 : value > max;
+        }
+        default:
+            return true;
+        }
+    }
+
+    void PrintFunctionDeclaration(const FunctionDefinitionStatement& functionDefinitionStatement, Purity purity, std::string_view nameSuffix = "")
+    {
+        // Let clang remove and combine the calls of functions without side effects.
+        if (functionDefinitionStatement.typeInfo.fullName != "void") {
+            if (purity == Purity::Const) {
+                m_printer.Print("[[gnu::const]] ");
+            } else if (purity == Purity::Pure) {
+                m_printer.Print("[[gnu::pure]] ");
+            }
+        }
+        PrintFunctionHeader(functionDefinitionStatement, nameSuffix);
+        m_printer.Println(";");
+    }
+
+    void PrintFunctionHeader(const FunctionDefinitionStatement& functionDefinitionStatement, std::string_view nameSuffix = "")
+    {
+        if (functionDefinitionStatement.constness != Constness::None) {
+            m_printer.Print("{} ", GetConstnessName(functionDefinitionStatement.constness));
+        }
         PrintTypeInfo(functionDefinitionStatement.typeInfo);
 
         m_printer.Print(" ");
 
-        m_printer.Print(functionDefinitionStatement.name);
+        m_printer.Print("{}{}", GetFunctionName(functionDefinitionStatement.name), nameSuffix);
 
         m_printer.Print("(");
         if (auto it = functionDefinitionStatement.headerScope.variableDeclarations.begin(); it != functionDefinitionStatement.headerScope.variableDeclarations.end()) {
@@ -309,7 +939,539 @@ private:
         m_printer.Print(")");
     }
 
+    // Variables are moved into by-value and `move` parameters at their last use. Otherwise `move`
+    // parameters, which only bind to temporaries, are given a copy of a variable.
+    void PrintArgument(const FunctionCallExpression& functionCallExpression, size_t index)
+    {
+        const auto& argExpression = *functionCallExpression.argsExpression[index];
+        auto parameter = functionCallExpression.function ? functionCallExpression.function->headerScope.variableDeclarations[index].get() : nullptr;
+        if (m_lastUseAnalysis && m_lastUseAnalysis->IsLastUse(argExpression)) {
+            m_printer.Print("static_cast<{}&&>(", GetTypeName(*argExpression.typeInfo));
+        } else if (parameter && parameter->parameterMode == ParameterMode::Move && IsVariable(argExpression)) {
+            m_printer.Print("static_cast<{}>(", GetTypeName(parameter->typeInfo));
+        } else {
+            argExpression.Visit(*this);
+            return;
+        }
+        argExpression.Visit(*this);
+        m_printer.Print(")");
+    }
+
+    // `f32x8(values, i)` calls the constructor of the SIMD type.
+    static bool IsSimdConstruction(const FunctionCallExpression& functionCallExpression)
+    {
+        auto identifierExpression = dynamic_cast<const IdentifierExpression*>(functionCallExpression.funcExpression.get());
+        const auto& typeInfo = functionCallExpression.typeInfo;
+        return identifierExpression && typeInfo && typeInfo->kind == TypeKind::Simd && identifierExpression->fullName == typeInfo->fullName;
+    }
+
+    static bool IsVariable(const Expression& expression)
+    {
+        if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(&expression); unaryExpression && unaryExpression->op == UnaryOp::Bracket) {
+            return IsVariable(*unaryExpression->oprand);
+        } else if (auto memberExpression = dynamic_cast<const MemberExpression*>(&expression)) {
+            return IsVariable(*memberExpression->objectExpression);
+        }
+        return dynamic_cast<const IdentifierExpression*>(&expression) || dynamic_cast<const IndexExpression*>(&expression);
+    }
+
+    // Returns true if both operands are calls without side effects in a function marked by the
+    // `ForkJoinParallelizer`, so they can be evaluated in parallel.
+    bool CanForkJoin(const FunctionDefinitionStatement* function, const BinaryExpression& binaryExpression) const
+    {
+        if (!function || !function->HasAttribute("fork_join") || binaryExpression.op < BinaryOp::Mul) {
+            return false;
+        }
+        auto leftCall = dynamic_cast<const FunctionCallExpression*>(binaryExpression.leftOprand.get());
+        auto rightCall = dynamic_cast<const FunctionCallExpression*>(binaryExpression.rightOprand.get());
+        return leftCall && rightCall && !HasSideEffects(*leftCall) && !HasSideEffects(*rightCall);
+    }
+
+    bool HasSideEffects(const Expression& expression) const
+    {
+        if (auto binaryExpression = dynamic_cast<const BinaryExpression*>(&expression)) {
+            return binaryExpression->op <= BinaryOp::BitOrAssignment || HasSideEffects(*binaryExpression->leftOprand) || HasSideEffects(*binaryExpression->rightOprand);
+        } else if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(&expression)) {
+            return HasSideEffects(*unaryExpression->oprand);
+        } else if (auto functionCallExpression = dynamic_cast<const FunctionCallExpression*>(&expression)) {
+            auto identifierExpression = dynamic_cast<const IdentifierExpression*>(functionCallExpression->funcExpression.get());
+            if (!identifierExpression || !m_purityAnalysis || m_purityAnalysis->GetPurity(identifierExpression->fullName) == Purity::Impure) {
+                return true;
+            }
+            return std::ranges::any_of(functionCallExpression->argsExpression, [this](const auto& argExpression) { return HasSideEffects(*argExpression); });
+        } else if (auto indexExpression = dynamic_cast<const IndexExpression*>(&expression)) {
+            return HasSideEffects(*indexExpression->arrayExpression) || HasSideEffects(*indexExpression->indexExpression);
+        } else if (auto memberExpression = dynamic_cast<const MemberExpression*>(&expression)) {
+            return HasSideEffects(*memberExpression->objectExpression);
+        } else if (auto sliceExpression = dynamic_cast<const SliceExpression*>(&expression)) {
+            return HasSideEffects(*sliceExpression->arrayExpression)
+                || (sliceExpression->beginExpression && HasSideEffects(*sliceExpression->beginExpression))
+                || (sliceExpression->endExpression && HasSideEffects(*sliceExpression->endExpression));
+        } else if (auto arrayLiteralExpression = dynamic_cast<const ArrayLiteralExpression*>(&expression)) {
+            return std::ranges::any_of(arrayLiteralExpression->elementsExpression, [this](const auto& elementExpression) { return HasSideEffects(*elementExpression); });
+        } else if (dynamic_cast<const SpawnExpression*>(&expression) || dynamic_cast<const AwaitExpression*>(&expression)) {
+            // Starting a task and waiting for one are never moved or dropped.
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    static std::string_view GetBinaryOperator(BinaryOp op)
+    {
+        switch (op) {
+        case BinaryOp::Assignment:
+            return "=";
+        case BinaryOp::MulAssignment:
+            return "*=";
+        case BinaryOp::DivAssignment:
+            return "/=";
+        case BinaryOp::ModAssignment:
+            return "%=";
+        case BinaryOp::AddAssignment:
+            return "+=";
+        case BinaryOp::SubAssignment:
+            return "-=";
+        case BinaryOp::ShiftLeftAssignment:
+            return "<<=";
+        case BinaryOp::ShiftRightAssignment:
+            return ">>=";
+        case BinaryOp::BitAndAssignment:
+            return "&=";
+        case BinaryOp::BitXorAssignment:
+            return "^=";
+        case BinaryOp::BitOrAssignment:
+            return "|=";
+
+        case BinaryOp::Mul:
+            return "*";
+        case BinaryOp::Div:
+            return "/";
+        case BinaryOp::Mod:
+            return "%";
+        case BinaryOp::Add:
+            return "+";
+        case BinaryOp::Sub:
+            return "-";
+
+        case BinaryOp::Equal:
+            return "==";
+        case BinaryOp::NotEqual:
+            return "!=";
+        case BinaryOp::Less:
+            return "<";
+        case BinaryOp::LessEqual:
+            return "<=";
+        case BinaryOp::Greater:
+            return ">";
+        case BinaryOp::GreaterEqual:
+            return ">=";
+
+        default:
+            assert(false);
+            return "";
+        }
+    }
+
+    static bool IsPrintWithLiteralFormat(const FunctionCallExpression& functionCallExpression)
+    {
+        auto identifierExpression = dynamic_cast<const IdentifierExpression*>(functionCallExpression.funcExpression.get());
+        return identifierExpression && (identifierExpression->fullName == "std::print" || identifierExpression->fullName == "std::println")
+            && !functionCallExpression.argsExpression.empty() && dynamic_cast<const StringLiteralExpression*>(functionCallExpression.argsExpression[0].get());
+    }
+
+    // Parses the format string of a call of `std::print` or `std::println`, with the newline of
+    // `std::println` appended to the text. Returns nothing if the arguments are not all used once in
+    // order, because their evaluation would change, or if a spec has nested fields, which
+    // `std::format` resolves at run time.
+    static std::optional<std::vector<FormatPiece>> GetFormatPieces(const FunctionCallExpression& functionCallExpression)
+    {
+        const auto& args = functionCallExpression.argsExpression;
+        const auto& format = static_cast<const StringLiteralExpression&>(*args[0]);
+        auto pieces = std::vector<FormatPiece> {};
+        try {
+            pieces = ParseFormatString(format.value, args.size() - 1);
+        } catch (const std::format_error& ex) {
+            throw Exception { format.sourceRange, "invalid format string: {}", ex.what() };
+        }
+
+        auto nextArg = 0;
+        for (const auto& piece : pieces) {
+            if (piece.IsField() && (piece.argIndex != nextArg++ || piece.HasNestedFields())) {
+                return std::nullopt;
+            }
+        }
+        if (nextArg != static_cast<int>(args.size()) - 1) {
+            return std::nullopt;
+        }
+
+        if (static_cast<const IdentifierExpression&>(*functionCallExpression.funcExpression).fullName == "std::println") {
+            if (pieces.empty() || pieces.back().IsField()) {
+                pieces.emplace_back();
+            }
+            pieces.back().text += '\n';
+        }
+        return pieces;
+    }
+
+    // Prints a call of `std::print` or `std::println` with the format string already parsed, as
+    // the text and arguments to write one after the other. Returns false if the call is left to
+    // `std::format`.
+    bool PrintFormattedCall(const FunctionCallExpression& functionCallExpression)
+    {
+        auto formatPieces = GetFormatPieces(functionCallExpression);
+        if (!formatPieces) {
+            return false;
+        }
+
+        const auto& args = functionCallExpression.argsExpression;
+        const auto& pieces = *formatPieces;
+        m_printer.Print("scc::std::print_parts(");
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            m_printer.Write(i ? ", " : "");
+            if (!pieces[i].IsField()) {
+                m_printer.WriteString(pieces[i].text);
+            } else if (pieces[i].spec.empty()) {
+                args[pieces[i].argIndex + 1]->Visit(*this);
+            } else {
+                m_printer.Print("scc::std::format_part({}, ", EscapeString("{:" + pieces[i].spec + "}"));
+                args[pieces[i].argIndex + 1]->Visit(*this);
+                m_printer.Print(")");
+            }
+        }
+        m_printer.Print(")");
+        return true;
+    }
+
+    struct EmbedCollector final : RecursiveVisitor {
+        std::vector<const EmbedExpression*> embedExpressions {};
+
+        void VisitAstEmbedExpression(const EmbedExpression& embedExpression) override
+        {
+            embedExpressions.push_back(&embedExpression);
+        }
+    };
+
+    static std::vector<const EmbedExpression*> CollectEmbedExpressions(const Scope& scope, const std::vector<Statement*>& functions)
+    {
+        auto collector = EmbedCollector {};
+        collector.VisitAstScope(scope);
+        for (const auto& func : functions) {
+            collector.VisitAstScope(static_cast<FunctionDefinitionStatement*>(func)->bodyScope);
+        }
+        return std::move(collector.embedExpressions);
+    }
+
+    // Finds the modules of `scc.std` which the translation refers to, taking the same decisions as
+    // printing it.
+    struct StdModuleCollector final : RecursiveVisitor {
+        explicit StdModuleCollector(const Translator& translator)
+            : translator { translator }
+        {
+        }
+
+        const Translator& translator;
+        const FunctionDefinitionStatement* currentFunction {};
+        StdImports imports {};
+
+        // Like `GetTypeName`. The fields of a struct of arrays are printed with the struct.
+        void AddType(const TypeInfo& typeInfo)
+        {
+            if (typeInfo.isSoa) {
+                imports.AddName("soa");
+            } else if (typeInfo.kind == TypeKind::Mask) {
+                imports.AddName("mask");
+            } else if ((typeInfo.kind == TypeKind::Integer && typeInfo.fullName != "int") || typeInfo.kind == TypeKind::Float) {
+                imports.AddName(typeInfo.fullName);
+            } else if (auto name = GetTemplateName(typeInfo.kind); !name.empty()) {
+                imports.AddName(name);
+                AddType(*typeInfo.elementType);
+            }
+        }
+
+        static std::string_view GetTemplateName(TypeKind kind)
+        {
+            switch (kind) {
+            case TypeKind::Array:
+                return "array";
+            case TypeKind::Vector:
+                return "vector";
+            case TypeKind::Slice:
+                return "slice";
+            case TypeKind::Task:
+                return "task_handle";
+            case TypeKind::Simd:
+                return "simd";
+            default:
+                return "";
+            }
+        }
+
+        // A struct is printed with its struct of arrays, which appends with `scc::std::push`.
+        void AddStruct(const TypeInfo& structType)
+        {
+            imports.AddName("soa");
+            for (const auto& field : structType.fields) {
+                AddType(*field.typeInfo);
+            }
+        }
+
+        void AddDeclaration(const FunctionDefinitionStatement& functionDefinitionStatement)
+        {
+            AddType(functionDefinitionStatement.typeInfo);
+            for (const auto& variableDeclaration : functionDefinitionStatement.headerScope.variableDeclarations) {
+                AddType(variableDeclaration->typeInfo);
+            }
+        }
+
+        void AddDefinition(const FunctionDefinitionStatement& functionDefinitionStatement)
+        {
+            AddDeclaration(functionDefinitionStatement);
+            if (functionDefinitionStatement.HasAttribute("memo")) {
+                imports.AddName("memo_table");
+            }
+            currentFunction = &functionDefinitionStatement;
+            VisitAstScope(functionDefinitionStatement.bodyScope);
+            currentFunction = nullptr;
+        }
+
+        void VisitAstArrayLiteralExpression(const ArrayLiteralExpression& arrayLiteralExpression) override
+        {
+            AddType(*arrayLiteralExpression.typeInfo);
+            RecursiveVisitor::VisitAstArrayLiteralExpression(arrayLiteralExpression);
+        }
+
+        void VisitAstAwaitExpression(const AwaitExpression& awaitExpression) override
+        {
+            imports.AddName("await");
+            RecursiveVisitor::VisitAstAwaitExpression(awaitExpression);
+        }
+
+        void VisitAstBinaryExpression(const BinaryExpression& binaryExpression) override
+        {
+            if (translator.CanForkJoin(currentFunction, binaryExpression)) {
+                imports.AddName("fork_join");
+            }
+            RecursiveVisitor::VisitAstBinaryExpression(binaryExpression);
+        }
+
+        void VisitAstForLoopStatement(const ForLoopStatement& forLoopStatement) override
+        {
+            if (forLoopStatement.isParallel) {
+                imports.AddName("parallel_for");
+                for (const auto& reduction : forLoopStatement.reductions) {
+                    AddType(reduction.variableDeclaration->typeInfo);
+                }
+            }
+            RecursiveVisitor::VisitAstForLoopStatement(forLoopStatement);
+        }
+
+        void VisitAstFunctionCallExpression(const FunctionCallExpression& functionCallExpression) override
+        {
+            auto isFormatted = IsPrintWithLiteralFormat(functionCallExpression) && GetFormatPieces(functionCallExpression);
+            if (isFormatted || IsSimdConstruction(functionCallExpression)) {
+                if (isFormatted) {
+                    imports.AddName("print_parts");
+                } else {
+                    AddType(*functionCallExpression.typeInfo);
+                }
+                for (const auto& argExpression : functionCallExpression.argsExpression) {
+                    argExpression->Visit(*this);
+                }
+                return;
+            }
+            RecursiveVisitor::VisitAstFunctionCallExpression(functionCallExpression);
+        }
+
+        void VisitAstIdentifierExpression(const IdentifierExpression& identifierExpression) override
+        {
+            if (identifierExpression.fullName.starts_with("std::")) {
+                imports.AddName(std::string_view { identifierExpression.fullName }.substr(5));
+            }
+        }
+
+        void VisitAstSpawnExpression(const SpawnExpression& spawnExpression) override
+        {
+            imports.AddName("spawn");
+            RecursiveVisitor::VisitAstSpawnExpression(spawnExpression);
+        }
+
+        void VisitAstSwitchStatement(const SwitchStatement& switchStatement) override
+        {
+            auto values = std::vector<int64_t> {};
+            for (const auto& switchCase : switchStatement.cases) {
+                for (const auto& caseValue : switchCase.values) {
+                    values.push_back(caseValue.value);
+                }
+            }
+            std::ranges::sort(values);
+            if (!IsDense(values)) {
+                imports.AddName("find_case");
+                AddType(*switchStatement.conditionalExpression->typeInfo);
+            }
+            RecursiveVisitor::VisitAstSwitchStatement(switchStatement);
+        }
+
+        // The elements of an array literal initializing a variable are printed without its type.
+        void VisitAstVariableDeclaration(const VariableDeclaration& variableDeclaration) override
+        {
+            AddType(variableDeclaration.typeInfo);
+            if (auto arrayLiteralExpression = dynamic_cast<const ArrayLiteralExpression*>(variableDeclaration.initExpression.get())) {
+                RecursiveVisitor::VisitAstArrayLiteralExpression(*arrayLiteralExpression);
+            } else {
+                RecursiveVisitor::VisitAstVariableDeclaration(variableDeclaration);
+            }
+        }
+    };
+
+    // The modules the declarations refer to, which is all the header of split units imports: the
+    // structs, the embedded data, the function signatures, and the compile-time functions and
+    // global constants, which are defined with them.
+    StdImports GetDeclarationImports(const Scope& scope, const std::vector<Statement*>& functions) const
+    {
+        auto collector = StdModuleCollector { *this };
+        for (const auto structType : scope.GetStructTypes()) {
+            collector.AddStruct(*structType);
+        }
+        for (const auto embedExpression : CollectEmbedExpressions(scope, functions)) {
+            collector.AddType(*embedExpression->typeInfo);
+        }
+        for (const auto& func : functions) {
+            const auto& functionDefinitionStatement = *static_cast<FunctionDefinitionStatement*>(func);
+            if (functionDefinitionStatement.constness != Constness::None) {
+                collector.AddDefinition(functionDefinitionStatement);
+            } else {
+                collector.AddDeclaration(functionDefinitionStatement);
+            }
+        }
+        for (const auto& statement : scope.statements) {
+            if (IsGlobalConstant(statement)) {
+                statement->Visit(collector);
+            }
+        }
+        return std::move(collector.imports);
+    }
+
+    // The modules the definitions of the functions refer to, and the ones of `main` if its scope is
+    // given.
+    StdImports GetDefinitionImports(std::vector<Statement*>::const_iterator first, std::vector<Statement*>::const_iterator last, const Scope* mainScope) const
+    {
+        auto collector = StdModuleCollector { *this };
+        for (; first != last; ++first) {
+            collector.AddDefinition(*static_cast<FunctionDefinitionStatement*>(*first));
+        }
+        if (mainScope) {
+            for (const auto& statement : mainScope->statements) {
+                if (!IsGlobalConstant(statement)) {
+                    statement->Visit(collector);
+                }
+            }
+        }
+        return std::move(collector.imports);
+    }
+
+    // Each embedded file and byte string is assembled into the read-only data once, and the
+    // expressions refer to it by name. Clang doesn't parse an expression per byte then, and the
+    // contents of an embedded file are copied by `.incbin` without scc reading them. Split into
+    // units, the data is only declared here, and defined by the first unit.
+    void PrintEmbeddedData(const Scope& scope, const std::vector<Statement*>& functions, bool isSplit)
+    {
+        auto embedExpressions = CollectEmbedExpressions(scope, functions);
+        if (embedExpressions.empty()) {
+            return;
+        }
+
+        m_printer.Println("// embedded data");
+        for (const auto embedExpression : embedExpressions) {
+            auto name = std::format("scc_blob_{}", m_blobNames.size());
+            if (!isSplit) {
+                PrintBlobDefinition(*embedExpression, name, false);
+            }
+            m_printer.Println("extern \"C\" const {} {};", GetTypeName(*embedExpression->typeInfo), name);
+            m_blobNames.emplace(embedExpression, std::move(name));
+        }
+        m_printer.Println();
+    }
+
+    void PrintBlobDefinitions(const std::vector<const EmbedExpression*>& embedExpressions)
+    {
+        if (embedExpressions.empty()) {
+            return;
+        }
+
+        m_printer.Println("// embedded data");
+        for (const auto embedExpression : embedExpressions) {
+            PrintBlobDefinition(*embedExpression, m_blobNames.at(embedExpression), true);
+        }
+        m_printer.Println();
+    }
+
+    // A global blob is defined in one unit, and referred to by the others.
+    void PrintBlobDefinition(const EmbedExpression& embedExpression, std::string_view name, bool isGlobal)
+    {
+        m_printer.Println("asm(\".pushsection .rodata\\n\"");
+        m_printer.PushIndent();
+        if (isGlobal) {
+            m_printer.Println("\".globl {}\\n\"", name);
+        }
+        m_printer.Println("\"{}:\\n\"", name);
+        if (embedExpression.IsFile()) {
+            m_printer.WriteString(".incbin " + EscapeString(embedExpression.file) + "\n");
+            m_printer.Println();
+        } else {
+            const auto& bytes = embedExpression.bytes;
+            for (size_t i = 0; i < bytes.size(); i += s_bytesPerLine) {
+                auto line = std::string { ".byte " };
+                for (auto j = i; j < std::min(i + s_bytesPerLine, bytes.size()); ++j) {
+                    line += std::format("{}{:#04x}", j > i ? ", " : "", (unsigned char)bytes[j]);
+                }
+                m_printer.WriteString(line + "\n");
+                m_printer.Println();
+            }
+        }
+        m_printer.Println("\".popsection\");");
+        m_printer.PopIndent();
+    }
+
+    // Prints the function which looks up the arguments in a memo table, and only calls the original
+    // function, renamed with `s_uncachedSuffix`, when they are not found. Memoized functions may be
+    // called from parallel loops and spawned tasks, so every thread has a table of its own.
+    void PrintMemoizedFunction(const FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        auto types = GetTypeName(functionDefinitionStatement.typeInfo);
+        auto args = std::string {};
+        for (const auto& variableDeclaration : functionDefinitionStatement.headerScope.variableDeclarations) {
+            types += ", " + GetTypeName(variableDeclaration->typeInfo);
+            args += (args.empty() ? "" : ", ") + variableDeclaration->name;
+        }
+
+        PrintFunctionHeader(functionDefinitionStatement);
+        m_printer.Println();
+        m_printer.Println("{{");
+        m_printer.PushIndent();
+        m_printer.Println("static thread_local auto scc_memo_table = scc::std::memo_table<{}> {{}};", types);
+        m_printer.Println("if (auto scc_result = scc_memo_table.find({}))", args);
+        m_printer.Println("{{");
+        m_printer.PushIndent();
+        m_printer.Println("return *scc_result;");
+        m_printer.PopIndent();
+        m_printer.Println("}}");
+        m_printer.Println("return scc_memo_table.insert({}{}({}){}{});", GetFunctionName(functionDefinitionStatement.name), s_uncachedSuffix, args, args.empty() ? "" : ", ", args);
+        m_printer.PopIndent();
+        m_printer.Println("}}");
+    }
+
+    static constexpr std::string_view s_uncachedSuffix { "_uncached" };
+    static constexpr size_t s_maxCompareCases { 4 };
+    static constexpr size_t s_bytesPerLine { 16 };
+    static constexpr size_t s_minFunctionsPerThread { 16 };
+
     Printer m_printer;
+    unsigned m_threadCount {};
+    std::shared_ptr<const PurityAnalysis> m_purityAnalysis {};
+    std::optional<LastUseAnalysis> m_lastUseAnalysis {};
+    const FunctionDefinitionStatement* m_currentFunction {};
+    std::unordered_map<const EmbedExpression*, std::string> m_blobNames {};
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,1080 @@
+module;
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+import scc.ast;
+
+export module scc.compiler:type_checker;
+import :exception;
+import :parser;
+
+namespace scc::compiler {
+
+using namespace ast;
+
+// Annotates every expression with its type, and reports the expressions whose operands have
+// incompatible types.
+//
+// The types follow the generated C++: an integer literal is `int` if it fits, otherwise `i64`, and a
+// floating point literal is `f64`, or `f32` with the 'f' suffix. Arithmetic operands go through the
+// usual arithmetic conversions, where types narrower than `int` are promoted to `int` first. Any
+// arithmetic type converts implicitly to any other, and to the SIMD types, whose lanes are all set
+// to it.
+//
+// Arrays and vectors convert to slices of the same element type, as long as the slice can refer to
+// their storage, i.e. they are not temporaries. An array literal takes the type of the array or
+// vector it initializes, otherwise it is an array of the common type of its elements.
+//
+// The elements of a `@soa` array or vector are spread over one array per field, so they can only be
+// used through their fields, and such collections can't be sliced.
+//
+// A call of a generic function instantiates it with the type arguments deduced from the arguments.
+// The instance is parsed from the source of the generic function, added to the global scope as
+// e.g. `max<f64>`, so later calls with the same type arguments reuse it, and checked right away.
+//
+// `const` and `constexpr` variables can't be assigned. A `constexpr` variable is initialized by a
+// constant expression, of literals, other `constexpr` variables and calls of `constexpr` and
+// `consteval` functions. Global `constexpr` variables are visible in the functions too, except in
+// the compile-time functions, which only depend on their arguments. Compile-time functions can't
+// call other functions, or use vectors, which live on the heap. `consteval` functions can only be
+// called in constant expressions and other `consteval` functions.
+//
+// The iterations of a `parallel for` loop can't write to the variables declared outside the loop,
+// except the variables of its reductions, which must be arithmetic, and the elements indexed by the
+// loop variable. They can't return either.
+export struct TypeChecker final {
+    void CheckCompileUnit(Scope& scope)
+    {
+        m_globalScope = &scope;
+        m_void = scope.QueryTypeInfo("void");
+        m_bool = scope.QueryTypeInfo("bool");
+        m_int = scope.QueryTypeInfo("int");
+        m_i64 = scope.QueryTypeInfo("i64");
+        m_u8 = scope.QueryTypeInfo("u8");
+        m_u64 = scope.QueryTypeInfo("u64");
+        m_f32 = scope.QueryTypeInfo("f32");
+        m_f64 = scope.QueryTypeInfo("f64");
+        m_string = scope.QueryTypeInfo("string");
+
+        for (const auto& variableDeclaration : scope.variableDeclarations) {
+            if (variableDeclaration->constness == Constness::Constexpr) {
+                m_constants[variableDeclaration->name] = variableDeclaration.get();
+            }
+        }
+
+        for (auto func : scope.GetFunctions()) {
+            CheckFunction(*static_cast<FunctionDefinitionStatement*>(func));
+        }
+
+        // The global statements are the body of 'main'.
+        m_function = nullptr;
+        CheckScope(scope);
+    }
+
+private:
+    static constexpr int MaxInstantiationDepth = 64;
+
+    // Functions of `scc.std` on SIMD values and masks.
+    static inline const std::unordered_set<std::string> s_simdFunctions { "std::store", "std::reduce_add", "std::reduce_min", "std::reduce_max", "std::select", "std::any", "std::all", "std::count", "std::shift_up" };
+
+    void CheckFunction(FunctionDefinitionStatement& functionDefinitionStatement)
+    {
+        m_function = &functionDefinitionStatement;
+        if (IsCompileTimeFunction()) {
+            CheckCompileTimeType(functionDefinitionStatement.typeInfo, functionDefinitionStatement.sourceRange);
+        }
+        m_variables.emplace_back();
+        for (const auto& variableDeclaration : functionDefinitionStatement.headerScope.variableDeclarations) {
+            if (IsCompileTimeFunction()) {
+                CheckCompileTimeType(variableDeclaration->typeInfo, variableDeclaration->sourceRange);
+                if (variableDeclaration->parameterMode == ParameterMode::Ref) {
+                    throw Exception { variableDeclaration->sourceRange, "{} function '{}' is not constant-evaluable, it has the 'ref' parameter '{}'", GetConstnessName(m_function->constness), m_function->name, variableDeclaration->name };
+                }
+            }
+            m_variables.back()[variableDeclaration->name] = variableDeclaration.get();
+        }
+        CheckScope(functionDefinitionStatement.bodyScope);
+        m_variables.pop_back();
+    }
+
+    void CheckScope(Scope& scope)
+    {
+        m_variables.emplace_back();
+        for (const auto& statement : scope.statements) {
+            CheckStatement(*statement);
+        }
+        m_variables.pop_back();
+    }
+
+    void CheckStatement(Statement& statement)
+    {
+        if (auto variableDefinitionStatement = dynamic_cast<VariableDefinitionStatement*>(&statement)) {
+            auto& variableDeclaration = variableDefinitionStatement->variableDeclaration;
+            if (variableDeclaration.typeInfo.kind == TypeKind::Void) {
+                throw Exception { variableDeclaration.sourceRange, "variable has incomplete type 'void'" };
+            }
+            if (IsCompileTimeFunction()) {
+                CheckCompileTimeType(variableDeclaration.typeInfo, variableDeclaration.sourceRange);
+            }
+            if (variableDeclaration.constness == Constness::Constexpr) {
+                CheckConstantDefinition(variableDeclaration);
+            } else if (variableDeclaration.initExpression) {
+                CheckInitExpression(variableDeclaration);
+            }
+            m_variables.back()[variableDeclaration.name] = &variableDeclaration;
+        } else if (auto expressionStatement = dynamic_cast<ExpressionStatement*>(&statement)) {
+            CheckExpression(*expressionStatement->expression);
+        } else if (auto returnStatement = dynamic_cast<ReturnStatement*>(&statement)) {
+            CheckReturnStatement(*returnStatement);
+        } else if (auto conditionalStatement = dynamic_cast<ConditionalStatement*>(&statement)) {
+            CheckCondition(*conditionalStatement->conditionalExpression);
+            CheckScope(conditionalStatement->trueScope);
+            CheckScope(conditionalStatement->falseScope);
+        } else if (auto switchStatement = dynamic_cast<SwitchStatement*>(&statement)) {
+            CheckSwitchStatement(*switchStatement);
+        } else if (auto forLoopStatement = dynamic_cast<ForLoopStatement*>(&statement)) {
+            if (forLoopStatement->isParallel) {
+                CheckReductions(*forLoopStatement);
+            }
+
+            // The init scope is still in effect for condition, iteration and body.
+            auto parallelLoop = m_parallelLoop;
+            auto parallelLoopLevel = m_parallelLoopLevel;
+            m_variables.emplace_back();
+            for (const auto& initStatement : forLoopStatement->initScope.statements) {
+                CheckStatement(*initStatement);
+            }
+            if (forLoopStatement->conditionalExpression) {
+                CheckCondition(*forLoopStatement->conditionalExpression);
+            }
+            if (forLoopStatement->iterationExpression) {
+                CheckExpression(*forLoopStatement->iterationExpression);
+            }
+            if (forLoopStatement->isParallel) {
+                m_parallelLoop = forLoopStatement;
+                m_parallelLoopLevel = m_variables.size() - 1;
+            }
+            CheckScope(forLoopStatement->bodyScope);
+            m_variables.pop_back();
+            m_parallelLoop = parallelLoop;
+            m_parallelLoopLevel = parallelLoopLevel;
+        }
+    }
+
+    void CheckReductions(ForLoopStatement& forLoopStatement)
+    {
+        for (auto& reduction : forLoopStatement.reductions) {
+            auto variableDeclaration = QueryVariable(reduction.variableName);
+            if (!variableDeclaration) {
+                throw Exception { reduction.sourceRange, "use of undeclared identifier '{}'", reduction.variableName };
+            }
+            if (variableDeclaration->constness != Constness::None) {
+                throw Exception { reduction.sourceRange, "cannot reduce into the {} variable '{}'", GetConstnessName(variableDeclaration->constness), reduction.variableName };
+            }
+            if (!variableDeclaration->typeInfo.IsArithmetic() || variableDeclaration->typeInfo.kind == TypeKind::Bool) {
+                throw Exception { reduction.sourceRange, "cannot reduce into the variable '{}' of non-arithmetic type '{}'", reduction.variableName, variableDeclaration->typeInfo.fullName };
+            }
+            if (std::ranges::count(forLoopStatement.reductions, reduction.variableName, &Reduction::variableName) > 1) {
+                throw Exception { reduction.sourceRange, "variable '{}' appears in more than one reduction", reduction.variableName };
+            }
+            // The reduction of a nested parallel loop writes to the variable once the loop is done.
+            CheckParallelWrite(reduction.variableName, reduction.sourceRange);
+            reduction.variableDeclaration = variableDeclaration;
+        }
+    }
+
+    // The iterations of a parallel loop run in any order and at the same time, so they can only write
+    // to their own variables, to the reduction variables, and to the elements of shared arrays,
+    // vectors and slices at the loop variable, which no other iteration writes.
+    void CheckParallelWrite(const Expression& expression) const
+    {
+        if (!m_parallelLoop) {
+            return;
+        }
+
+        const auto& loopVariable = *m_parallelLoop->initScope.variableDeclarations.front();
+        if (auto identifierExpression = dynamic_cast<const IdentifierExpression*>(&expression)) {
+            CheckParallelWrite(identifierExpression->fullName, expression.sourceRange);
+        } else if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(&expression); unaryExpression && unaryExpression->op == UnaryOp::Bracket) {
+            CheckParallelWrite(*unaryExpression->oprand);
+        } else if (auto memberExpression = dynamic_cast<const MemberExpression*>(&expression)) {
+            CheckParallelWrite(*memberExpression->objectExpression);
+        } else if (auto indexExpression = dynamic_cast<const IndexExpression*>(&expression)) {
+            auto index = dynamic_cast<const IdentifierExpression*>(indexExpression->indexExpression.get());
+            if (index && QueryVariable(index->fullName) == &loopVariable) {
+                return;
+            }
+            // The elements of a slice belong to another variable, which may be shared.
+            if (indexExpression->arrayExpression->typeInfo->kind == TypeKind::Slice) {
+                throw Exception { expression.sourceRange, "parallel for loop writes to an element of a slice at an index other than the loop variable '{}'", loopVariable.name };
+            }
+            CheckParallelWrite(*indexExpression->arrayExpression);
+        }
+    }
+
+    void CheckParallelWrite(const std::string& name, const SourceRange& sourceRange) const
+    {
+        if (!m_parallelLoop) {
+            return;
+        }
+
+        auto variableDeclaration = QueryVariable(name);
+        if (variableDeclaration == m_parallelLoop->initScope.variableDeclarations.front().get()) {
+            throw Exception { sourceRange, "cannot modify the loop variable '{}' of a parallel for loop", name };
+        }
+        auto isReduction = std::ranges::any_of(m_parallelLoop->reductions, [&](const auto& reduction) { return reduction.variableDeclaration == variableDeclaration; });
+        if (IsSharedVariable(name) && !isReduction) {
+            throw Exception { sourceRange, "parallel for loop writes to the shared variable '{}' outside a reduction", name };
+        }
+    }
+
+    // Returns whether the variable is declared outside the parallel loop, so all iterations share it.
+    bool IsSharedVariable(const std::string& name) const
+    {
+        for (auto level = m_parallelLoopLevel; level < m_variables.size(); ++level) {
+            if (m_variables[level].contains(name)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void CheckInitExpression(VariableDeclaration& variableDeclaration)
+    {
+        auto& type = CheckExpression(*variableDeclaration.initExpression);
+        if (!CheckConversion(*variableDeclaration.initExpression, variableDeclaration.typeInfo)) {
+            throw Exception { variableDeclaration.initExpression->sourceRange, "cannot initialize a variable of type '{}' with a value of type '{}'", variableDeclaration.typeInfo.fullName, type.fullName };
+        }
+    }
+
+    // Vectors, tasks and SIMD values can't be constants, and slices of constants would make them
+    // writable.
+    void CheckConstantDefinition(VariableDeclaration& variableDeclaration)
+    {
+        const auto& type = variableDeclaration.typeInfo;
+        if (ContainsType(type, TypeKind::Vector) || ContainsType(type, TypeKind::Slice) || ContainsType(type, TypeKind::Task) || ContainsType(type, TypeKind::Simd) || ContainsType(type, TypeKind::Mask) || type.isSoa) {
+            throw Exception { variableDeclaration.sourceRange, "constexpr variable '{}' can't have type '{}'", variableDeclaration.name, type.fullName };
+        }
+
+        assert(variableDeclaration.initExpression);
+        m_isConstantExpression = true;
+        CheckInitExpression(variableDeclaration);
+        m_isConstantExpression = false;
+        if (!IsConstantExpression(*variableDeclaration.initExpression)) {
+            throw Exception { variableDeclaration.initExpression->sourceRange, "constexpr variable '{}' must be initialized by a constant expression", variableDeclaration.name };
+        }
+    }
+
+    // Only the functions which are declared to run at compile time, and the constants they're given,
+    // can be evaluated by the C++ compiler.
+    bool IsConstantExpression(const Expression& expression) const
+    {
+        if (dynamic_cast<const IntegerLiteralExpression*>(&expression) || dynamic_cast<const FloatLiteralExpression*>(&expression) || dynamic_cast<const StringLiteralExpression*>(&expression)) {
+            return true;
+        } else if (auto identifierExpression = dynamic_cast<const IdentifierExpression*>(&expression)) {
+            auto variableDeclaration = QueryVariable(identifierExpression->fullName);
+            return variableDeclaration && variableDeclaration->constness == Constness::Constexpr;
+        } else if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(&expression)) {
+            return IsConstantExpression(*unaryExpression->oprand);
+        } else if (auto binaryExpression = dynamic_cast<const BinaryExpression*>(&expression)) {
+            // Assignment operators come first in `BinaryOp`.
+            return binaryExpression->op > BinaryOp::BitOrAssignment && IsConstantExpression(*binaryExpression->leftOprand) && IsConstantExpression(*binaryExpression->rightOprand);
+        } else if (auto functionCallExpression = dynamic_cast<const FunctionCallExpression*>(&expression)) {
+            auto identifierExpression = dynamic_cast<const IdentifierExpression*>(functionCallExpression->funcExpression.get());
+            return identifierExpression && IsCompileTimeCallee(identifierExpression->fullName)
+                && std::ranges::all_of(functionCallExpression->argsExpression, [this](const auto& argExpression) { return IsConstantExpression(*argExpression); });
+        } else if (auto indexExpression = dynamic_cast<const IndexExpression*>(&expression)) {
+            return IsConstantExpression(*indexExpression->arrayExpression) && IsConstantExpression(*indexExpression->indexExpression);
+        } else if (auto memberExpression = dynamic_cast<const MemberExpression*>(&expression)) {
+            return IsConstantExpression(*memberExpression->objectExpression);
+        } else if (auto arrayLiteralExpression = dynamic_cast<const ArrayLiteralExpression*>(&expression)) {
+            return std::ranges::all_of(arrayLiteralExpression->elementsExpression, [this](const auto& elementExpression) { return IsConstantExpression(*elementExpression); });
+        }
+        return false;
+    }
+
+    // `std::len` of arrays and slices is evaluated at compile time too.
+    bool IsCompileTimeCallee(const std::string& name) const
+    {
+        auto function = static_cast<const FunctionDefinitionStatement*>(m_globalScope->QueryFunction(name));
+        return name == "std::len" || (function && function->constness != Constness::None);
+    }
+
+    bool IsCompileTimeFunction() const
+    {
+        return m_function && m_function->constness != Constness::None;
+    }
+
+    void CheckCompileTimeType(const TypeInfo& type, const SourceRange& sourceRange) const
+    {
+        if (ContainsType(type, TypeKind::Vector)) {
+            throw Exception { sourceRange, "{} function '{}' is not constant-evaluable, it uses the vector type '{}'", GetConstnessName(m_function->constness), m_function->name, type.fullName };
+        }
+        if (ContainsType(type, TypeKind::Task)) {
+            throw Exception { sourceRange, "{} function '{}' is not constant-evaluable, it uses the task type '{}'", GetConstnessName(m_function->constness), m_function->name, type.fullName };
+        }
+        if (ContainsType(type, TypeKind::Simd) || ContainsType(type, TypeKind::Mask)) {
+            throw Exception { sourceRange, "{} function '{}' is not constant-evaluable, it uses the SIMD type '{}'", GetConstnessName(m_function->constness), m_function->name, type.fullName };
+        }
+    }
+
+    static bool ContainsType(const TypeInfo& type, TypeKind kind)
+    {
+        if (type.kind == kind) {
+            return true;
+        } else if (type.elementType) {
+            return ContainsType(*type.elementType, kind);
+        }
+        return std::ranges::any_of(type.fields, [kind](const auto& field) { return ContainsType(*field.typeInfo, kind); });
+    }
+
+    // Returns the `const` or `constexpr` variable the expression writes to. Slices are never constant,
+    // their elements belong to another variable.
+    const VariableDeclaration* GetConstVariable(const Expression& expression) const
+    {
+        if (auto identifierExpression = dynamic_cast<const IdentifierExpression*>(&expression)) {
+            auto variableDeclaration = QueryVariable(identifierExpression->fullName);
+            return variableDeclaration && variableDeclaration->constness != Constness::None ? variableDeclaration : nullptr;
+        } else if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(&expression); unaryExpression && unaryExpression->op == UnaryOp::Bracket) {
+            return GetConstVariable(*unaryExpression->oprand);
+        } else if (auto memberExpression = dynamic_cast<const MemberExpression*>(&expression)) {
+            return GetConstVariable(*memberExpression->objectExpression);
+        } else if (auto indexExpression = dynamic_cast<const IndexExpression*>(&expression); indexExpression && indexExpression->arrayExpression->typeInfo->kind != TypeKind::Slice) {
+            return GetConstVariable(*indexExpression->arrayExpression);
+        }
+        return nullptr;
+    }
+
+    void CheckReturnStatement(ReturnStatement& returnStatement)
+    {
+        if (m_parallelLoop) {
+            throw Exception { returnStatement.sourceRange, "cannot return from a parallel for loop" };
+        }
+        auto& returnType = m_function ? m_function->typeInfo : *m_int;
+        const auto& name = m_function ? m_function->name : "main";
+        if (!returnStatement.expression) {
+            if (returnType.kind != TypeKind::Void) {
+                throw Exception { returnStatement.sourceRange, "non-void function '{}' should return a value", name };
+            }
+            return;
+        }
+
+        auto& type = CheckExpression(*returnStatement.expression);
+        if (returnType.kind == TypeKind::Void) {
+            if (type.kind != TypeKind::Void) {
+                throw Exception { returnStatement.expression->sourceRange, "void function '{}' should not return a value", name };
+            }
+        } else if (!CheckConversion(*returnStatement.expression, returnType)) {
+            throw Exception { returnStatement.expression->sourceRange, "cannot return a value of type '{}' from function '{}' returning '{}'", type.fullName, name, returnType.fullName };
+        }
+    }
+
+    // The condition of a switch statement is an integer, and every case value is a value of its type,
+    // which appears only once.
+    void CheckSwitchStatement(SwitchStatement& switchStatement)
+    {
+        auto& type = CheckExpression(*switchStatement.conditionalExpression);
+        if (type.kind != TypeKind::Integer) {
+            throw Exception { switchStatement.conditionalExpression->sourceRange, "switch condition has non-integer type '{}'", type.fullName };
+        }
+
+        auto values = std::unordered_set<int64_t> {};
+        for (auto& switchCase : switchStatement.cases) {
+            for (const auto& caseValue : switchCase.values) {
+                if (!IsInRange(caseValue.value, type)) {
+                    throw Exception { caseValue.sourceRange, "case value '{}' is out of range of type '{}'", caseValue.value, type.fullName };
+                }
+                if (!values.insert(caseValue.value).second) {
+                    throw Exception { caseValue.sourceRange, "duplicate case value '{}'", caseValue.value };
+                }
+            }
+            CheckScope(switchCase.scope);
+        }
+    }
+
+    static bool IsInRange(int64_t value, const TypeInfo& type)
+    {
+        if (type.bits == 64) {
+            return type.isSigned || value >= 0;
+        }
+        auto min = type.isSigned ? -(int64_t { 1 } << (type.bits - 1)) : 0;
+        auto max = type.isSigned ? (int64_t { 1 } << (type.bits - 1)) - 1 : (int64_t { 1 } << type.bits) - 1;
+        return value >= min && value <= max;
+    }
+
+    void CheckCondition(Expression& expression)
+    {
+        auto& type = CheckExpression(expression);
+        if (!type.IsArithmetic()) {
+            throw Exception { expression.sourceRange, "value of type '{}' is not contextually convertible to 'bool'", type.fullName };
+        }
+    }
+
+    TypeInfo& CheckExpression(Expression& expression)
+    {
+        expression.typeInfo = &GetExpressionType(expression);
+        return *expression.typeInfo;
+    }
+
+    TypeInfo& GetExpressionType(Expression& expression)
+    {
+        if (auto integerLiteralExpression = dynamic_cast<IntegerLiteralExpression*>(&expression)) {
+            if (integerLiteralExpression->value <= std::numeric_limits<int32_t>::max()) {
+                return *m_int;
+            }
+            return integerLiteralExpression->value <= std::numeric_limits<int64_t>::max() ? *m_i64 : *m_u64;
+        } else if (auto floatLiteralExpression = dynamic_cast<FloatLiteralExpression*>(&expression)) {
+            return floatLiteralExpression->isSinglePrecision ? *m_f32 : *m_f64;
+        } else if (dynamic_cast<StringLiteralExpression*>(&expression)) {
+            return *m_string;
+        } else if (auto identifierExpression = dynamic_cast<IdentifierExpression*>(&expression)) {
+            auto variableDeclaration = QueryVariable(identifierExpression->fullName);
+            if (!variableDeclaration && IsCompileTimeFunction() && m_constants.contains(identifierExpression->fullName)) {
+                throw Exception { identifierExpression->sourceRange, "{} function '{}' is not constant-evaluable, it uses the global constant '{}'", GetConstnessName(m_function->constness), m_function->name, identifierExpression->fullName };
+            }
+            if (!variableDeclaration) {
+                throw Exception { identifierExpression->sourceRange, "use of undeclared identifier '{}'", identifierExpression->fullName };
+            }
+            return variableDeclaration->typeInfo;
+        } else if (auto unaryExpression = dynamic_cast<UnaryExpression*>(&expression)) {
+            auto& type = CheckExpression(*unaryExpression->oprand);
+            if (unaryExpression->op == UnaryOp::Bracket || type.kind == TypeKind::Simd) {
+                return type;
+            }
+            if (!type.IsArithmetic()) {
+                throw Exception { unaryExpression->sourceRange, "invalid argument type '{}' to unary expression", type.fullName };
+            }
+            return Promote(type);
+        } else if (auto binaryExpression = dynamic_cast<BinaryExpression*>(&expression)) {
+            return GetBinaryExpressionType(*binaryExpression);
+        } else if (auto functionCallExpression = dynamic_cast<FunctionCallExpression*>(&expression)) {
+            return GetFunctionCallExpressionType(*functionCallExpression);
+        } else if (auto indexExpression = dynamic_cast<IndexExpression*>(&expression)) {
+            return GetIndexExpressionType(*indexExpression, /*isFieldAccess=*/false);
+        } else if (auto memberExpression = dynamic_cast<MemberExpression*>(&expression)) {
+            return GetMemberExpressionType(*memberExpression);
+        } else if (auto sliceExpression = dynamic_cast<SliceExpression*>(&expression)) {
+            auto& type = CheckSequence(*sliceExpression->arrayExpression);
+            if (type.isSoa) {
+                throw Exception { sliceExpression->sourceRange, "cannot slice the struct of arrays '{}'", type.fullName };
+            }
+            if (!IsAddressable(*sliceExpression->arrayExpression)) {
+                throw Exception { sliceExpression->arrayExpression->sourceRange, "cannot slice a temporary value of type '{}'", type.fullName };
+            }
+            if (auto variableDeclaration = GetConstVariable(*sliceExpression->arrayExpression)) {
+                throw Exception { sliceExpression->arrayExpression->sourceRange, "cannot slice the {} variable '{}'", GetConstnessName(variableDeclaration->constness), variableDeclaration->name };
+            }
+            if (sliceExpression->beginExpression) {
+                CheckIndex(*sliceExpression->beginExpression);
+            }
+            if (sliceExpression->endExpression) {
+                CheckIndex(*sliceExpression->endExpression);
+            }
+            return GetSequenceType(*type.elementType, "[:]");
+        } else if (auto arrayLiteralExpression = dynamic_cast<ArrayLiteralExpression*>(&expression)) {
+            return GetArrayLiteralExpressionType(*arrayLiteralExpression);
+        } else if (auto embedExpression = dynamic_cast<EmbedExpression*>(&expression)) {
+            // The blob is linked into the program, it isn't there at compile time.
+            if (IsCompileTimeFunction()) {
+                throw Exception { embedExpression->sourceRange, "{} function '{}' is not constant-evaluable, it embeds data", GetConstnessName(m_function->constness), m_function->name };
+            }
+            return GetSequenceType(*m_u8, std::format("[{}]", embedExpression->size));
+        } else if (auto spawnExpression = dynamic_cast<SpawnExpression*>(&expression)) {
+            if (IsCompileTimeFunction()) {
+                throw Exception { spawnExpression->sourceRange, "{} function '{}' is not constant-evaluable, it spawns a task", GetConstnessName(m_function->constness), m_function->name };
+            }
+            auto& resultType = CheckExpression(*spawnExpression->callExpression);
+            return *m_globalScope->QueryTypeInfo(std::format("task<{}>", resultType.fullName));
+        } else if (auto awaitExpression = dynamic_cast<AwaitExpression*>(&expression)) {
+            auto& type = CheckExpression(*awaitExpression->oprand);
+            if (type.kind != TypeKind::Task) {
+                throw Exception { awaitExpression->sourceRange, "cannot await a value of type '{}'", type.fullName };
+            }
+            return *type.elementType;
+        } else {
+            assert(false);
+            return *m_void;
+        }
+    }
+
+    TypeInfo& GetIndexExpressionType(IndexExpression& indexExpression, bool isFieldAccess)
+    {
+        auto& type = CheckSequence(*indexExpression.arrayExpression);
+        CheckIndex(*indexExpression.indexExpression);
+        if (type.isSoa && !isFieldAccess) {
+            throw Exception { indexExpression.sourceRange, "an element of the struct of arrays '{}' can only be used through its fields", type.fullName };
+        }
+        return *type.elementType;
+    }
+
+    TypeInfo& GetMemberExpressionType(MemberExpression& memberExpression)
+    {
+        auto& objectExpression = *memberExpression.objectExpression;
+        if (auto indexExpression = dynamic_cast<IndexExpression*>(&objectExpression)) {
+            indexExpression->typeInfo = &GetIndexExpressionType(*indexExpression, /*isFieldAccess=*/true);
+        } else {
+            CheckExpression(objectExpression);
+        }
+
+        const auto& type = *objectExpression.typeInfo;
+        if (type.kind != TypeKind::Struct) {
+            throw Exception { memberExpression.sourceRange, "member reference base type '{}' is not a struct", type.fullName };
+        }
+        auto field = type.QueryField(memberExpression.memberName);
+        if (!field) {
+            throw Exception { memberExpression.sourceRange, "no member named '{}' in '{}'", memberExpression.memberName, type.fullName };
+        }
+        return *field->typeInfo;
+    }
+
+    TypeInfo& GetBinaryExpressionType(BinaryExpression& binaryExpression)
+    {
+        auto& left = CheckExpression(*binaryExpression.leftOprand);
+        auto& right = CheckExpression(*binaryExpression.rightOprand);
+
+        // Assignment operators come first in `BinaryOp`.
+        if (binaryExpression.op <= BinaryOp::BitOrAssignment) {
+            if (auto variableDeclaration = GetConstVariable(*binaryExpression.leftOprand)) {
+                throw Exception { binaryExpression.leftOprand->sourceRange, "cannot assign to variable '{}' with {}-qualified type '{}'", variableDeclaration->name, GetConstnessName(variableDeclaration->constness), variableDeclaration->typeInfo.fullName };
+            }
+            CheckParallelWrite(*binaryExpression.leftOprand);
+        }
+        if (binaryExpression.op != BinaryOp::Assignment && (left.kind == TypeKind::Simd || right.kind == TypeKind::Simd)) {
+            return GetSimdBinaryExpressionType(binaryExpression, left, right);
+        }
+
+        switch (binaryExpression.op) {
+        case BinaryOp::Assignment:
+            if (!CheckConversion(*binaryExpression.rightOprand, left)) {
+                throw Exception { binaryExpression.rightOprand->sourceRange, "assigning to '{}' from incompatible type '{}'", left.fullName, right.fullName };
+            }
+            return left;
+
+        case BinaryOp::MulAssignment:
+        case BinaryOp::DivAssignment:
+        case BinaryOp::AddAssignment:
+        case BinaryOp::SubAssignment:
+            CheckOperands(binaryExpression, left.IsArithmetic() && right.IsArithmetic());
+            return left;
+
+        case BinaryOp::ModAssignment:
+        case BinaryOp::ShiftLeftAssignment:
+        case BinaryOp::ShiftRightAssignment:
+        case BinaryOp::BitAndAssignment:
+        case BinaryOp::BitXorAssignment:
+        case BinaryOp::BitOrAssignment:
+            CheckOperands(binaryExpression, left.IsIntegral() && right.IsIntegral());
+            return left;
+
+        case BinaryOp::Mul:
+        case BinaryOp::Div:
+        case BinaryOp::Add:
+        case BinaryOp::Sub:
+            CheckOperands(binaryExpression, left.IsArithmetic() && right.IsArithmetic());
+            return GetCommonType(left, right);
+
+        case BinaryOp::Mod:
+            CheckOperands(binaryExpression, left.IsIntegral() && right.IsIntegral());
+            return GetCommonType(left, right);
+
+        default:
+            CheckOperands(binaryExpression, left.IsArithmetic() && right.IsArithmetic());
+            return *m_bool;
+        }
+    }
+
+    // The operators of SIMD types apply to every lane. The other operand is a value of the same type,
+    // or a scalar, which is broadcast to all lanes. Comparisons result in a mask of the lanes.
+    TypeInfo& GetSimdBinaryExpressionType(const BinaryExpression& binaryExpression, TypeInfo& left, TypeInfo& right)
+    {
+        auto& type = left.kind == TypeKind::Simd ? left : right;
+        auto& other = left.kind == TypeKind::Simd ? right : left;
+        CheckOperands(binaryExpression, &other == &type || other.IsArithmetic());
+
+        switch (binaryExpression.op) {
+        case BinaryOp::MulAssignment:
+        case BinaryOp::DivAssignment:
+        case BinaryOp::AddAssignment:
+        case BinaryOp::SubAssignment:
+            CheckOperands(binaryExpression, left.kind == TypeKind::Simd);
+            return left;
+
+        case BinaryOp::ModAssignment:
+        case BinaryOp::ShiftLeftAssignment:
+        case BinaryOp::ShiftRightAssignment:
+        case BinaryOp::BitAndAssignment:
+        case BinaryOp::BitXorAssignment:
+        case BinaryOp::BitOrAssignment:
+            CheckOperands(binaryExpression, left.kind == TypeKind::Simd && left.elementType->kind == TypeKind::Integer);
+            return left;
+
+        case BinaryOp::Mul:
+        case BinaryOp::Div:
+        case BinaryOp::Add:
+        case BinaryOp::Sub:
+            return type;
+
+        case BinaryOp::Mod:
+            CheckOperands(binaryExpression, type.elementType->kind == TypeKind::Integer);
+            return type;
+
+        default:
+            return *m_globalScope->QueryTypeInfo(std::format("mask{}x{}", type.elementType->bits, type.length));
+        }
+    }
+
+    void CheckOperands(const BinaryExpression& binaryExpression, bool valid)
+    {
+        if (!valid) {
+            throw Exception { binaryExpression.sourceRange, "invalid operands to binary expression ('{}' and '{}')", binaryExpression.leftOprand->typeInfo->fullName, binaryExpression.rightOprand->typeInfo->fullName };
+        }
+    }
+
+    TypeInfo& GetFunctionCallExpressionType(FunctionCallExpression& functionCallExpression)
+    {
+        for (const auto& argExpression : functionCallExpression.argsExpression) {
+            CheckExpression(*argExpression);
+        }
+
+        // Functions which are not defined in the compile unit, e.g. from `scc.std`, return nothing.
+        auto identifierExpression = dynamic_cast<IdentifierExpression*>(functionCallExpression.funcExpression.get());
+        auto function = identifierExpression ? static_cast<FunctionDefinitionStatement*>(m_globalScope->QueryFunction(identifierExpression->fullName)) : nullptr;
+        if (!function && identifierExpression) {
+            if (auto genericFunction = m_globalScope->QueryGenericFunction(identifierExpression->fullName)) {
+                function = &InstantiateGenericFunction(functionCallExpression, *identifierExpression, *genericFunction);
+            }
+        }
+        if (IsCompileTimeFunction() && (!identifierExpression || !IsCompileTimeCallee(identifierExpression->fullName))) {
+            throw Exception { functionCallExpression.sourceRange, "{} function '{}' is not constant-evaluable, it calls '{}', which is not a compile-time function", GetConstnessName(m_function->constness), m_function->name, identifierExpression ? identifierExpression->fullName : "" };
+        }
+        if (function && function->constness == Constness::Consteval && !m_isConstantExpression && (!m_function || m_function->constness != Constness::Consteval)) {
+            throw Exception { functionCallExpression.sourceRange, "call to consteval function '{}' is not a constant expression", function->name };
+        }
+        if (!function) {
+            if (identifierExpression && (identifierExpression->fullName == "std::len" || identifierExpression->fullName == "std::push")) {
+                return GetSequenceFunctionCallExpressionType(functionCallExpression, identifierExpression->fullName);
+            }
+            if (identifierExpression && s_simdFunctions.contains(identifierExpression->fullName)) {
+                return GetSimdFunctionCallExpressionType(functionCallExpression, identifierExpression->fullName);
+            }
+            if (auto typeInfo = identifierExpression ? m_globalScope->QueryTypeInfo(identifierExpression->fullName) : nullptr; typeInfo && typeInfo->kind == TypeKind::Simd) {
+                return GetSimdConstructionType(functionCallExpression, *typeInfo);
+            }
+            return *m_void;
+        }
+
+        const auto& parameters = function->headerScope.variableDeclarations;
+        if (parameters.size() != functionCallExpression.argsExpression.size()) {
+            throw Exception { functionCallExpression.sourceRange, "no matching function for call to '{}', expected {} arguments but {} were given", function->name, parameters.size(), functionCallExpression.argsExpression.size() };
+        }
+        for (size_t i = 0; i < parameters.size(); ++i) {
+            auto& argExpression = *functionCallExpression.argsExpression[i];
+            if (parameters[i]->parameterMode == ParameterMode::Ref) {
+                CheckRefArgument(argExpression, *parameters[i]);
+            } else if (!CheckConversion(argExpression, parameters[i]->typeInfo)) {
+                throw Exception { argExpression.sourceRange, "cannot initialize a parameter of type '{}' with a value of type '{}'", parameters[i]->typeInfo.fullName, argExpression.typeInfo->fullName };
+            }
+        }
+        functionCallExpression.function = function;
+        return function->typeInfo;
+    }
+
+    // A `ref` parameter refers to the argument, so the argument must be a variable, or an element or
+    // a field of one, of exactly the parameter type, which the callee may write.
+    void CheckRefArgument(const Expression& argExpression, const VariableDeclaration& parameter)
+    {
+        if (!IsVariable(argExpression)) {
+            throw Exception { argExpression.sourceRange, "cannot pass a temporary value to the 'ref' parameter '{}'", parameter.name };
+        }
+        if (argExpression.typeInfo != &parameter.typeInfo) {
+            throw Exception { argExpression.sourceRange, "cannot pass a value of type '{}' to the 'ref' parameter '{}' of type '{}'", argExpression.typeInfo->fullName, parameter.name, parameter.typeInfo.fullName };
+        }
+        if (auto variableDeclaration = GetConstVariable(argExpression)) {
+            throw Exception { argExpression.sourceRange, "cannot pass the {} variable '{}' to the 'ref' parameter '{}'", GetConstnessName(variableDeclaration->constness), variableDeclaration->name, parameter.name };
+        }
+        CheckParallelWrite(argExpression);
+    }
+
+    // Returns the instance of the generic function for the types of the arguments, and makes the call
+    // refer to it.
+    FunctionDefinitionStatement& InstantiateGenericFunction(FunctionCallExpression& functionCallExpression, IdentifierExpression& identifierExpression, const GenericFunctionDefinition& genericFunction)
+    {
+        const auto& args = functionCallExpression.argsExpression;
+        if (genericFunction.parameterTypes.size() != args.size()) {
+            throw Exception { functionCallExpression.sourceRange, "no matching function for call to '{}', expected {} arguments but {} were given", genericFunction.name, genericFunction.parameterTypes.size(), args.size() };
+        }
+
+        auto typeArguments = std::unordered_map<std::string, TypeInfo*> {};
+        for (size_t i = 0; i < args.size(); ++i) {
+            DeduceTypeArguments(genericFunction, genericFunction.parameterTypes[i], *args[i], typeArguments);
+        }
+
+        auto instanceName = genericFunction.name + '<';
+        auto typeNames = std::unordered_map<std::string, std::string> {};
+        for (const auto& typeParameter : genericFunction.typeParameters) {
+            auto it = typeArguments.find(typeParameter);
+            if (it == typeArguments.end()) {
+                throw Exception { functionCallExpression.sourceRange, "couldn't infer type parameter '{}' of '{}'", typeParameter, genericFunction.name };
+            }
+            instanceName += std::format("{}{}", typeNames.empty() ? "" : ", ", it->second->fullName);
+            typeNames[typeParameter] = it->second->fullName;
+        }
+        instanceName += '>';
+        identifierExpression.fullName = instanceName;
+
+        if (auto function = m_globalScope->QueryFunction(instanceName)) {
+            return *static_cast<FunctionDefinitionStatement*>(function);
+        }
+        if (m_instantiationDepth == MaxInstantiationDepth) {
+            throw Exception { functionCallExpression.sourceRange, "instantiation of '{}' exceeds the maximum depth of {}", instanceName, MaxInstantiationDepth };
+        }
+
+        // The instance is added before its body is checked, so it may call itself.
+        auto& function = Parser { std::move(typeNames) }.ParseGenericFunctionInstance(*m_globalScope, genericFunction, instanceName);
+        auto caller = m_function;
+        auto variables = std::move(m_variables);
+        auto isConstantExpression = std::exchange(m_isConstantExpression, false);
+        auto parallelLoop = std::exchange(m_parallelLoop, nullptr);
+        m_variables.clear();
+        ++m_instantiationDepth;
+        CheckFunction(function);
+        --m_instantiationDepth;
+        m_function = caller;
+        m_variables = std::move(variables);
+        m_isConstantExpression = isConstantExpression;
+        m_parallelLoop = parallelLoop;
+        return function;
+    }
+
+    // Binds the type parameters in `parameterType` by matching it against the type of the argument,
+    // e.g. `T[:]` against `f64[4]` binds `T` to `f64`. Arguments which don't match are reported
+    // when they are converted to the parameter type of the instance.
+    static void DeduceTypeArguments(const GenericFunctionDefinition& genericFunction, std::string_view parameterType, const Expression& argExpression, std::unordered_map<std::string, TypeInfo*>& typeArguments)
+    {
+        auto type = argExpression.typeInfo;
+        if (parameterType.starts_with("@soa ") != type->isSoa) {
+            return;
+        }
+        if (type->isSoa) {
+            parameterType.remove_prefix(5);
+        }
+
+        for (auto outermost = true; parameterType.ends_with(']'); outermost = false) {
+            auto pos = parameterType.rfind('[');
+            auto size = parameterType.substr(pos + 1, parameterType.size() - pos - 2);
+            if (size == ":") {
+                // Arrays and vectors convert to slices of the same element type.
+                if (type->kind != TypeKind::Slice && !(outermost && (type->kind == TypeKind::Array || type->kind == TypeKind::Vector))) {
+                    return;
+                }
+            } else if (size.empty()) {
+                if (type->kind != TypeKind::Vector) {
+                    return;
+                }
+            } else if (type->kind != TypeKind::Array || std::to_string(type->length) != size) {
+                return;
+            }
+            type = type->elementType;
+            parameterType = parameterType.substr(0, pos);
+        }
+
+        const auto& typeParameters = genericFunction.typeParameters;
+        auto typeParameter = std::string { parameterType };
+        if (std::find(typeParameters.begin(), typeParameters.end(), typeParameter) == typeParameters.end()) {
+            return;
+        }
+        auto [it, inserted] = typeArguments.emplace(typeParameter, type);
+        if (!inserted && it->second != type) {
+            throw Exception { argExpression.sourceRange, "deduced conflicting types for parameter '{}' ('{}' vs. '{}')", typeParameter, it->second->fullName, type->fullName };
+        }
+    }
+
+    // `std::len(sequence)` returns the number of elements, and `std::push(vector, value)` appends
+    // an element to a vector.
+    TypeInfo& GetSequenceFunctionCallExpressionType(FunctionCallExpression& functionCallExpression, const std::string& name)
+    {
+        auto& args = functionCallExpression.argsExpression;
+        auto expectedArgs = name == "std::len" ? 1 : 2;
+        if ((int)args.size() != expectedArgs) {
+            throw Exception { functionCallExpression.sourceRange, "no matching function for call to '{}', expected {} arguments but {} were given", name, expectedArgs, args.size() };
+        }
+
+        auto& type = *args[0]->typeInfo;
+        if (name == "std::len") {
+            if (!type.IsSequence()) {
+                throw Exception { args[0]->sourceRange, "no matching function for call to '{}' with a value of type '{}'", name, type.fullName };
+            }
+            return *m_i64;
+        }
+
+        if (type.kind != TypeKind::Vector || !IsAddressable(*args[0])) {
+            throw Exception { args[0]->sourceRange, "no matching function for call to '{}' with a value of type '{}'", name, type.fullName };
+        }
+        if (auto variableDeclaration = GetConstVariable(*args[0])) {
+            throw Exception { args[0]->sourceRange, "cannot push to the {} variable '{}'", GetConstnessName(variableDeclaration->constness), variableDeclaration->name };
+        }
+        CheckParallelWrite(*args[0]);
+        if (!CheckConversion(*args[1], *type.elementType)) {
+            throw Exception { args[1]->sourceRange, "cannot push a value of type '{}' to a vector of type '{}'", args[1]->typeInfo->fullName, type.fullName };
+        }
+        return *m_void;
+    }
+
+    // `f32x8(value)` broadcasts a scalar to all lanes, and `f32x8(values, index)` loads the lanes from
+    // `values[index:index + 8]` of an array, a vector or a slice of the lane type.
+    TypeInfo& GetSimdConstructionType(FunctionCallExpression& functionCallExpression, TypeInfo& type)
+    {
+        auto& args = functionCallExpression.argsExpression;
+        if (args.size() == 1) {
+            if (!CheckConversion(*args[0], type)) {
+                throw Exception { args[0]->sourceRange, "cannot initialize a value of type '{}' with a value of type '{}'", type.fullName, args[0]->typeInfo->fullName };
+            }
+            return type;
+        }
+        if (args.size() != 2) {
+            throw Exception { functionCallExpression.sourceRange, "no matching function for call to '{}', expected 1 or 2 arguments but {} were given", type.fullName, args.size() };
+        }
+
+        auto& valuesType = *args[0]->typeInfo;
+        if (!valuesType.IsSequence() || valuesType.isSoa || !IsSameScalarType(*valuesType.elementType, *type.elementType)) {
+            throw Exception { args[0]->sourceRange, "cannot load a value of type '{}' from a value of type '{}'", type.fullName, valuesType.fullName };
+        }
+        CheckLaneIndex(*args[1]);
+        return type;
+    }
+
+    // `std::store(values, index, value)` stores the lanes to `values[index:index + N]`, the
+    // reductions return a lane, `std::select(condition, if_true, if_false)` picks the lanes of either
+    // value, `std::any`, `std::all` and `std::count` test the lanes of a mask, and
+    // `std::shift_up(value, n)` moves the lanes up.
+    TypeInfo& GetSimdFunctionCallExpressionType(FunctionCallExpression& functionCallExpression, const std::string& name)
+    {
+        auto& args = functionCallExpression.argsExpression;
+        auto expectedArgs = name == "std::store" || name == "std::select" ? 3 : name == "std::shift_up" ? 2 : 1;
+        if ((int)args.size() != expectedArgs) {
+            throw Exception { functionCallExpression.sourceRange, "no matching function for call to '{}', expected {} arguments but {} were given", name, expectedArgs, args.size() };
+        }
+
+        auto& arg = name == "std::store" ? *args[2] : *args[0];
+        auto& type = *arg.typeInfo;
+        auto takesMask = name == "std::select" || name == "std::any" || name == "std::all" || name == "std::count";
+        if (type.kind != (takesMask ? TypeKind::Mask : TypeKind::Simd)) {
+            throw Exception { arg.sourceRange, "no matching function for call to '{}' with a value of type '{}'", name, type.fullName };
+        }
+
+        if (name == "std::any" || name == "std::all") {
+            return *m_bool;
+        } else if (name == "std::count") {
+            return *m_i64;
+        } else if (name == "std::shift_up") {
+            CheckLaneIndex(*args[1]);
+            return type;
+        } else if (name == "std::select") {
+            auto& valueType = *args[1]->typeInfo;
+            if (valueType.kind != TypeKind::Simd || valueType.length != type.length || valueType.elementType->bits != type.bits) {
+                throw Exception { args[1]->sourceRange, "no matching function for call to '{}' with a value of type '{}' for a mask of type '{}'", name, valueType.fullName, type.fullName };
+            }
+            if (!CheckConversion(*args[2], valueType)) {
+                throw Exception { args[2]->sourceRange, "no matching function for call to '{}' with values of types '{}' and '{}'", name, valueType.fullName, args[2]->typeInfo->fullName };
+            }
+            return valueType;
+        } else if (name == "std::store") {
+            auto& valuesType = *args[0]->typeInfo;
+            if (!valuesType.IsSequence() || valuesType.isSoa || !IsSameScalarType(*valuesType.elementType, *type.elementType) || !IsAddressable(*args[0])) {
+                throw Exception { args[0]->sourceRange, "cannot store a value of type '{}' to a value of type '{}'", type.fullName, valuesType.fullName };
+            }
+            if (auto variableDeclaration = GetConstVariable(*args[0])) {
+                throw Exception { args[0]->sourceRange, "cannot store to the {} variable '{}'", GetConstnessName(variableDeclaration->constness), variableDeclaration->name };
+            }
+            CheckParallelWrite(*args[0]);
+            CheckLaneIndex(*args[1]);
+            return *m_void;
+        }
+        return *type.elementType;
+    }
+
+    void CheckLaneIndex(const Expression& expression) const
+    {
+        if (expression.typeInfo->kind != TypeKind::Integer) {
+            throw Exception { expression.sourceRange, "index of type '{}' is not an integer", expression.typeInfo->fullName };
+        }
+    }
+
+    // `int` and `i32` are the same type in C++.
+    static bool IsSameScalarType(const TypeInfo& left, const TypeInfo& right)
+    {
+        return left.kind == right.kind && left.bits == right.bits && left.isSigned == right.isSigned && left.IsArithmetic();
+    }
+
+    TypeInfo& GetArrayLiteralExpressionType(ArrayLiteralExpression& arrayLiteralExpression)
+    {
+        auto elementType = static_cast<TypeInfo*>(nullptr);
+        for (const auto& elementExpression : arrayLiteralExpression.elementsExpression) {
+            auto& type = CheckExpression(*elementExpression);
+            if (!elementType) {
+                elementType = &type;
+            } else if (elementType->IsArithmetic() && type.IsArithmetic()) {
+                elementType = &GetCommonType(*elementType, type);
+            } else if (elementType != &type) {
+                throw Exception { elementExpression->sourceRange, "array element of type '{}' doesn't match the previous elements of type '{}'", type.fullName, elementType->fullName };
+            }
+        }
+        if (elementType->kind == TypeKind::Void) {
+            throw Exception { arrayLiteralExpression.sourceRange, "array element has incomplete type 'void'" };
+        }
+        return GetSequenceType(*elementType, std::format("[{}]", arrayLiteralExpression.elementsExpression.size()));
+    }
+
+    TypeInfo& CheckSequence(Expression& expression)
+    {
+        auto& type = CheckExpression(expression);
+        if (!type.IsSequence()) {
+            throw Exception { expression.sourceRange, "subscripted value of type '{}' is not an array, vector or slice", type.fullName };
+        }
+        return type;
+    }
+
+    void CheckIndex(Expression& expression)
+    {
+        auto& type = CheckExpression(expression);
+        if (type.kind != TypeKind::Integer) {
+            throw Exception { expression.sourceRange, "array subscript of type '{}' is not an integer", type.fullName };
+        }
+    }
+
+    // Returns true if the value of the checked expression can be converted to `to`. An array
+    // literal takes the type of the array or vector it initializes.
+    bool CheckConversion(Expression& expression, TypeInfo& to)
+    {
+        auto& from = *expression.typeInfo;
+        if (auto arrayLiteralExpression = dynamic_cast<ArrayLiteralExpression*>(&expression)) {
+            const auto& elements = arrayLiteralExpression->elementsExpression;
+            if (!to.isSoa && ((to.kind == TypeKind::Array && to.length == elements.size()) || to.kind == TypeKind::Vector)) {
+                for (const auto& elementExpression : elements) {
+                    if (!CheckConversion(*elementExpression, *to.elementType)) {
+                        return false;
+                    }
+                }
+                expression.typeInfo = &to;
+                return true;
+            }
+        }
+        if (to.kind == TypeKind::Slice && (from.kind == TypeKind::Array || from.kind == TypeKind::Vector)) {
+            return !from.isSoa && from.elementType == to.elementType && IsAddressable(expression) && !GetConstVariable(expression);
+        }
+        return IsConvertible(from, to);
+    }
+
+    // Returns true if the expression is a variable, or an element or a field of one.
+    static bool IsVariable(const Expression& expression)
+    {
+        if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(&expression); unaryExpression && unaryExpression->op == UnaryOp::Bracket) {
+            return IsVariable(*unaryExpression->oprand);
+        } else if (auto memberExpression = dynamic_cast<const MemberExpression*>(&expression)) {
+            return IsVariable(*memberExpression->objectExpression);
+        }
+        return dynamic_cast<const IdentifierExpression*>(&expression) || dynamic_cast<const IndexExpression*>(&expression);
+    }
+
+    // Slices may only refer to variables and their elements, temporaries are gone before the slice
+    // is used. A slice of a slice refers to the same elements.
+    static bool IsAddressable(const Expression& expression)
+    {
+        if (expression.typeInfo && expression.typeInfo->kind == TypeKind::Slice) {
+            return true;
+        } else if (auto unaryExpression = dynamic_cast<const UnaryExpression*>(&expression); unaryExpression && unaryExpression->op == UnaryOp::Bracket) {
+            return IsAddressable(*unaryExpression->oprand);
+        } else if (auto memberExpression = dynamic_cast<const MemberExpression*>(&expression)) {
+            return IsAddressable(*memberExpression->objectExpression);
+        }
+        return dynamic_cast<const IdentifierExpression*>(&expression) || dynamic_cast<const IndexExpression*>(&expression);
+    }
+
+    TypeInfo& GetSequenceType(TypeInfo& elementType, const std::string& suffix)
+    {
+        return *m_globalScope->QueryTypeInfo(elementType.fullName + suffix);
+    }
+
+    static bool IsConvertible(const TypeInfo& from, const TypeInfo& to)
+    {
+        return &from == &to || (from.IsArithmetic() && (to.IsArithmetic() || to.kind == TypeKind::Simd)) || (from.kind == TypeKind::String && to.kind == TypeKind::String);
+    }
+
+    // Integral promotion: `bool` and integers narrower than `int` become `int`.
+    TypeInfo& Promote(TypeInfo& type) const
+    {
+        return type.IsIntegral() && type.bits < m_int->bits ? *m_int : type;
+    }
+
+    // Usual arithmetic conversions.
+    TypeInfo& GetCommonType(TypeInfo& left, TypeInfo& right) const
+    {
+        if (left.kind == TypeKind::Float || right.kind == TypeKind::Float) {
+            if (left.kind != right.kind) {
+                return left.kind == TypeKind::Float ? left : right;
+            }
+            return left.bits >= right.bits ? left : right;
+        }
+
+        auto& l = Promote(left);
+        auto& r = Promote(right);
+        if (l.isSigned == r.isSigned) {
+            return l.bits >= r.bits ? l : r;
+        }
+        auto& unsignedType = l.isSigned ? r : l;
+        auto& signedType = l.isSigned ? l : r;
+        return unsignedType.bits >= signedType.bits ? unsignedType : signedType;
+    }
+
+    VariableDeclaration* QueryVariable(const std::string& name) const
+    {
+        for (auto it = m_variables.rbegin(); it != m_variables.rend(); ++it) {
+            if (auto variable = it->find(name); variable != it->end()) {
+                return variable->second;
+            }
+        }
+
+        // The global constants are defined before the functions using them.
+        if (m_function && !IsCompileTimeFunction()) {
+            if (auto constant = m_constants.find(name); constant != m_constants.end()) {
+                return constant->second;
+            }
+        }
+        return nullptr;
+    }
+
+    Scope* m_globalScope {};
+    FunctionDefinitionStatement* m_function {};
+    std::vector<std::unordered_map<std::string, VariableDeclaration*>> m_variables {};
+    int m_instantiationDepth {};
+    std::unordered_map<std::string, VariableDeclaration*> m_constants {};
+
+    // Set while the initializer of a `constexpr` variable is checked.
+    bool m_isConstantExpression {};
+
+    // The innermost parallel loop being checked, its variables start at `m_parallelLoopLevel`.
+    const ForLoopStatement* m_parallelLoop {};
+    size_t m_parallelLoopLevel {};
+
+    TypeInfo* m_void {};
+    TypeInfo* m_bool {};
+    TypeInfo* m_int {};
+    TypeInfo* m_i64 {};
+    TypeInfo* m_u8 {};
+    TypeInfo* m_u64 {};
+    TypeInfo* m_f32 {};
+    TypeInfo* m_f64 {};
+    TypeInfo* m_string {};
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+module;
+
+#include <algorithm>
+#include <cassert>
+#include <list>
+#include <memory>
+#include <vector>
+
+export module scc.ir:ir_basic_block;
+import :ir_instruction;
+
+namespace scc::ir {
+
+export struct BasicBlock final {
+    std::list<std::unique_ptr<Instruction>> instructions {};
+    std::vector<BasicBlock*> predecessors {};
+    int id {};
+
+    Instruction* GetTerminator() const
+    {
+        if (instructions.empty() || !instructions.back()->IsTerminator()) {
+            return nullptr;
+        }
+        return instructions.back().get();
+    }
+
+    std::vector<BasicBlock*> GetSuccessors() const
+    {
+        auto terminator = GetTerminator();
+        return terminator ? terminator->blocks : std::vector<BasicBlock*> {};
+    }
+
+    // Appends the instruction at the end of the block.
+    Instruction* Append(std::unique_ptr<Instruction> instruction)
+    {
+        assert(!GetTerminator());
+        instruction->parent = this;
+        instructions.push_back(std::move(instruction));
+        return instructions.back().get();
+    }
+
+    // Inserts the instruction before the terminator of the block.
+    Instruction* InsertBeforeTerminator(std::unique_ptr<Instruction> instruction)
+    {
+        auto it = GetTerminator() ? std::prev(instructions.end()) : instructions.end();
+        instruction->parent = this;
+        return instructions.insert(it, std::move(instruction))->get();
+    }
+
+    // Inserts the phi instruction at the beginning of the block.
+    Instruction* InsertPhi(std::unique_ptr<Instruction> phi)
+    {
+        assert(phi->opcode == Opcode::Phi);
+        phi->parent = this;
+        instructions.push_front(std::move(phi));
+        return instructions.front().get();
+    }
+
+    // Removes the instruction from the block and returns it.
+    std::unique_ptr<Instruction> Remove(Instruction* instruction)
+    {
+        auto it = std::ranges::find_if(instructions, [instruction](const auto& p) { return p.get() == instruction; });
+        assert(it != instructions.end());
+        auto removed = std::move(*it);
+        instructions.erase(it);
+        removed->parent = nullptr;
+        return removed;
+    }
+};
+
+}
\ No newline at end of file
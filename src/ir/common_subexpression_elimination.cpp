@@ -0,0 +1,86 @@
+module;
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <vector>
+
+export module scc.ir:ir_common_subexpression_elimination;
+import :ir_basic_block;
+import :ir_dominator_tree;
+import :ir_function;
+import :ir_instruction;
+import :ir_pass_manager;
+
+namespace scc::ir {
+
+// Replaces a pure instruction by an equivalent instruction which dominates it, walking the
+// dominator tree with a scoped table of available expressions.
+export struct CommonSubexpressionElimination final : Pass {
+    std::string_view GetName() const override
+    {
+        return "common-subexpression-elimination";
+    }
+
+    void Run(Function& function) override
+    {
+        function.UpdatePredecessors();
+        auto dominatorTree = DominatorTree { function };
+        m_function = &function;
+        m_dominatorTree = &dominatorTree;
+        Visit(function.GetEntryBlock());
+        m_expressions.clear();
+    }
+
+private:
+    using Key = std::vector<uintptr_t>;
+
+    void Visit(BasicBlock* block)
+    {
+        auto added = std::vector<Key> {};
+        for (auto it = block->instructions.begin(); it != block->instructions.end();) {
+            auto instruction = it->get();
+            if (!instruction->IsPure() || instruction->opcode == Opcode::Phi) {
+                ++it;
+                continue;
+            }
+
+            auto key = GetKey(*instruction);
+            if (auto existing = m_expressions.find(key); existing != m_expressions.end()) {
+                m_function->ReplaceAllUses(instruction, existing->second);
+                it = block->instructions.erase(it);
+            } else {
+                m_expressions.emplace(key, instruction);
+                added.push_back(std::move(key));
+                ++it;
+            }
+        }
+
+        for (auto child : m_dominatorTree->GetChildren(block)) {
+            Visit(child);
+        }
+
+        for (const auto& key : added) {
+            m_expressions.erase(key);
+        }
+    }
+
+    static Key GetKey(const Instruction& instruction)
+    {
+        auto key = Key { (uintptr_t)instruction.opcode, (uintptr_t)instruction.type };
+        for (auto operand : instruction.operands) {
+            key.push_back((uintptr_t)operand);
+        }
+        if (instruction.IsCommutative()) {
+            std::sort(key.begin() + 2, key.end());
+        }
+        return key;
+    }
+
+    Function* m_function {};
+    const DominatorTree* m_dominatorTree {};
+    std::map<Key, Instruction*> m_expressions {};
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+module;
+
+#include <list>
+#include <string_view>
+#include <unordered_set>
+
+export module scc.ir:ir_dead_code_elimination;
+import :ir_function;
+import :ir_instruction;
+import :ir_pass_manager;
+import :ir_value;
+
+namespace scc::ir {
+
+// Removes pure instructions whose value is never used. Local variables are SSA values in the IR,
+// so this also removes dead stores to them.
+export struct DeadCodeElimination final : Pass {
+    std::string_view GetName() const override
+    {
+        return "dead-code-elimination";
+    }
+
+    void Run(Function& function) override
+    {
+        for (auto changed = true; changed;) {
+            changed = false;
+
+            auto used = std::unordered_set<const Value*> {};
+            for (const auto& block : function.blocks) {
+                for (const auto& instruction : block->instructions) {
+                    for (auto operand : instruction->operands) {
+                        // A phi only used by itself is dead.
+                        if (operand != instruction.get()) {
+                            used.insert(operand);
+                        }
+                    }
+                }
+            }
+
+            for (const auto& block : function.blocks) {
+                changed |= std::erase_if(block->instructions, [&used](const auto& instruction) {
+                    return instruction->IsPure() && !used.contains(instruction.get());
+                }) > 0;
+            }
+        }
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+module;
+
+#include <cassert>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+export module scc.ir:ir_dominator_tree;
+import :ir_basic_block;
+import :ir_function;
+
+namespace scc::ir {
+
+// Dominator tree of a function, computed with the iterative algorithm from Cooper, Harvey and
+// Kennedy, "A Simple, Fast Dominance Algorithm". Predecessors of the blocks must be up to date.
+export struct DominatorTree final {
+    explicit DominatorTree(const Function& function)
+    {
+        ComputeReversePostOrder(function.GetEntryBlock());
+
+        auto entry = function.GetEntryBlock();
+        m_immediateDominators[entry] = entry;
+
+        for (auto changed = true; changed;) {
+            changed = false;
+            for (auto block : m_reversePostOrder) {
+                if (block == entry) {
+                    continue;
+                }
+
+                BasicBlock* newImmediateDominator {};
+                for (auto predecessor : block->predecessors) {
+                    if (!m_immediateDominators.contains(predecessor)) {
+                        continue;
+                    }
+                    newImmediateDominator = newImmediateDominator ? Intersect(predecessor, newImmediateDominator) : predecessor;
+                }
+                assert(newImmediateDominator);
+
+                if (m_immediateDominators[block] != newImmediateDominator) {
+                    m_immediateDominators[block] = newImmediateDominator;
+                    changed = true;
+                }
+            }
+        }
+
+        for (auto block : m_reversePostOrder) {
+            if (block != entry) {
+                m_children[m_immediateDominators[block]].push_back(block);
+            }
+        }
+    }
+
+    // Returns the immediate dominator of the block, or nullptr for the entry block.
+    BasicBlock* GetImmediateDominator(BasicBlock* block) const
+    {
+        auto immediateDominator = m_immediateDominators.at(block);
+        return immediateDominator == block ? nullptr : immediateDominator;
+    }
+
+    bool Dominates(BasicBlock* dominator, BasicBlock* block) const
+    {
+        for (; block; block = GetImmediateDominator(block)) {
+            if (block == dominator) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const std::vector<BasicBlock*>& GetChildren(BasicBlock* block) const
+    {
+        static const std::vector<BasicBlock*> empty {};
+        auto it = m_children.find(block);
+        return it == m_children.end() ? empty : it->second;
+    }
+
+    const std::vector<BasicBlock*>& GetReversePostOrder() const
+    {
+        return m_reversePostOrder;
+    }
+
+private:
+    void ComputeReversePostOrder(BasicBlock* entry)
+    {
+        auto visited = std::unordered_set<BasicBlock*> {};
+        auto postOrder = std::vector<BasicBlock*> {};
+        auto visit = std::function<void(BasicBlock*)> {};
+        visit = [&](BasicBlock* block) {
+            if (!visited.insert(block).second) {
+                return;
+            }
+            for (auto successor : block->GetSuccessors()) {
+                visit(successor);
+            }
+            postOrder.push_back(block);
+        };
+        visit(entry);
+
+        m_reversePostOrder.assign(postOrder.rbegin(), postOrder.rend());
+        for (size_t i = 0; i < m_reversePostOrder.size(); ++i) {
+            m_postOrderNumbers[m_reversePostOrder[i]] = (int)(m_reversePostOrder.size() - i);
+        }
+    }
+
+    BasicBlock* Intersect(BasicBlock* a, BasicBlock* b) const
+    {
+        while (a != b) {
+            while (m_postOrderNumbers.at(a) < m_postOrderNumbers.at(b)) {
+                a = m_immediateDominators.at(a);
+            }
+            while (m_postOrderNumbers.at(b) < m_postOrderNumbers.at(a)) {
+                b = m_immediateDominators.at(b);
+            }
+        }
+        return a;
+    }
+
+    std::vector<BasicBlock*> m_reversePostOrder {};
+    std::unordered_map<BasicBlock*, int> m_postOrderNumbers {};
+    std::unordered_map<BasicBlock*, BasicBlock*> m_immediateDominators {};
+    std::unordered_map<BasicBlock*, std::vector<BasicBlock*>> m_children {};
+};
+
+}
\ No newline at end of file
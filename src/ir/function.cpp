@@ -0,0 +1,162 @@
+module;
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+export module scc.ir:ir_function;
+import :ir_basic_block;
+import :ir_instruction;
+import :ir_type;
+import :ir_value;
+
+namespace scc::ir {
+
+export struct Function final {
+    std::string name {};
+    Type returnType {};
+    std::vector<std::unique_ptr<Argument>> arguments {};
+
+    // The first block is the entry block.
+    std::vector<std::unique_ptr<BasicBlock>> blocks {};
+
+    Function(std::string name, Type returnType)
+        : name { std::move(name) }
+        , returnType { returnType }
+    {
+    }
+
+    BasicBlock* CreateBlock()
+    {
+        blocks.push_back(std::make_unique<BasicBlock>());
+        blocks.back()->id = m_nextBlockId++;
+        return blocks.back().get();
+    }
+
+    BasicBlock* GetEntryBlock() const
+    {
+        assert(!blocks.empty());
+        return blocks.front().get();
+    }
+
+    Constant* GetConstant(Type type, int64_t value)
+    {
+        auto& constant = m_constants[{ type, value }];
+        if (!constant) {
+            constant = std::make_unique<Constant>(type, value);
+        }
+        return constant.get();
+    }
+
+    StringConstant* GetStringConstant(std::string value)
+    {
+        auto& constant = m_stringConstants[value];
+        if (!constant) {
+            constant = std::make_unique<StringConstant>(std::move(value));
+        }
+        return constant.get();
+    }
+
+    // Recomputes the predecessors of all blocks from their terminators.
+    void UpdatePredecessors()
+    {
+        for (const auto& block : blocks) {
+            block->predecessors.clear();
+        }
+        for (const auto& block : blocks) {
+            for (auto successor : block->GetSuccessors()) {
+                if (std::ranges::find(successor->predecessors, block.get()) == successor->predecessors.end()) {
+                    successor->predecessors.push_back(block.get());
+                }
+            }
+        }
+    }
+
+    void ReplaceAllUses(Value* from, Value* to)
+    {
+        for (const auto& block : blocks) {
+            for (const auto& instruction : block->instructions) {
+                std::ranges::replace(instruction->operands, from, to);
+            }
+        }
+    }
+
+    bool HasUses(const Value* value) const
+    {
+        for (const auto& block : blocks) {
+            for (const auto& instruction : block->instructions) {
+                if (std::ranges::find(instruction->operands, value) != instruction->operands.end()) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Removes the blocks which can't be reached from the entry block, and the phi operands
+    // coming from them.
+    void RemoveUnreachableBlocks()
+    {
+        auto reachable = std::unordered_set<BasicBlock*> {};
+        auto pending = std::vector<BasicBlock*> { GetEntryBlock() };
+        while (!pending.empty()) {
+            auto block = pending.back();
+            pending.pop_back();
+            if (reachable.insert(block).second) {
+                auto successors = block->GetSuccessors();
+                pending.insert(pending.end(), successors.begin(), successors.end());
+            }
+        }
+
+        for (const auto& block : blocks) {
+            if (!reachable.contains(block.get())) {
+                continue;
+            }
+            for (const auto& instruction : block->instructions) {
+                if (instruction->opcode != Opcode::Phi) {
+                    continue;
+                }
+                for (size_t i = instruction->blocks.size(); i-- > 0;) {
+                    if (!reachable.contains(instruction->blocks[i])) {
+                        instruction->blocks.erase(instruction->blocks.begin() + i);
+                        instruction->operands.erase(instruction->operands.begin() + i);
+                    }
+                }
+            }
+        }
+
+        std::erase_if(blocks, [&reachable](const auto& block) { return !reachable.contains(block.get()); });
+        UpdatePredecessors();
+    }
+
+    // Assigns sequential ids to blocks and instructions, used when printing the function.
+    void Renumber()
+    {
+        auto blockId = 0;
+        auto instructionId = 0;
+        for (const auto& block : blocks) {
+            block->id = blockId++;
+            for (const auto& instruction : block->instructions) {
+                instruction->id = instructionId++;
+            }
+        }
+        m_nextBlockId = blockId;
+    }
+
+private:
+    int m_nextBlockId {};
+    std::map<std::pair<Type, int64_t>, std::unique_ptr<Constant>> m_constants {};
+    std::map<std::string, std::unique_ptr<StringConstant>> m_stringConstants {};
+};
+
+export struct Program final {
+    std::vector<std::unique_ptr<Function>> functions {};
+};
+
+}
\ No newline at end of file
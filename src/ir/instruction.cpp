@@ -0,0 +1,181 @@
+module;
+
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module scc.ir:ir_instruction;
+import :ir_type;
+import :ir_value;
+
+namespace scc::ir {
+
+export struct BasicBlock;
+
+export enum class Opcode {
+    Neg,
+    Mul,
+    Div,
+    Mod,
+    Add,
+    Sub,
+    ShiftLeft,
+    ShiftRight,
+    BitAnd,
+    BitXor,
+    BitOr,
+
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+
+    Convert,
+    Call,
+    Phi,
+
+    Branch,
+    CondBranch,
+    Return,
+};
+
+export struct Instruction final : Value {
+    Opcode opcode {};
+    std::vector<Value*> operands {};
+
+    // Targets of a branch, or the incoming block of each operand of a phi.
+    std::vector<BasicBlock*> blocks {};
+
+    // Name of the called function.
+    std::string callee {};
+
+    // Arithmetic is done with two's complement wrap-around instead of undefined overflow. Set on
+    // instructions which are executed speculatively, or which compute a value the source never did.
+    bool wraps {};
+
+    BasicBlock* parent {};
+    int id {};
+
+    Instruction(Opcode opcode, Type type, std::vector<Value*> operands = {}, std::vector<BasicBlock*> blocks = {})
+        : Value { type }
+        , opcode { opcode }
+        , operands { std::move(operands) }
+        , blocks { std::move(blocks) }
+    {
+    }
+
+    bool IsTerminator() const
+    {
+        return opcode == Opcode::Branch || opcode == Opcode::CondBranch || opcode == Opcode::Return;
+    }
+
+    // Returns true if the instruction has no side effect, so it can be removed when unused and
+    // replaced by an equivalent instruction.
+    bool IsPure() const
+    {
+        return opcode < Opcode::Call || opcode == Opcode::Phi;
+    }
+
+    // Returns true if executing the instruction can never trap or be undefined, once `wraps` is
+    // set, so it can be executed even when the program wouldn't.
+    bool IsSafeToSpeculate() const
+    {
+        if (opcode >= Opcode::Call) {
+            return false;
+        }
+
+        switch (opcode) {
+        case Opcode::Div:
+        case Opcode::Mod: {
+            auto divisor = dynamic_cast<const Constant*>(operands[1]);
+            return divisor && divisor->value != 0 && divisor->value != -1;
+        }
+
+        case Opcode::ShiftLeft:
+        case Opcode::ShiftRight: {
+            auto shift = dynamic_cast<const Constant*>(operands[1]);
+            return shift && shift->value >= 0 && shift->value < (operands[0]->type == Type::Long ? 64 : 32);
+        }
+
+        default:
+            return true;
+        }
+    }
+
+    bool IsCommutative() const
+    {
+        switch (opcode) {
+        case Opcode::Mul:
+        case Opcode::Add:
+        case Opcode::BitAnd:
+        case Opcode::BitXor:
+        case Opcode::BitOr:
+        case Opcode::Equal:
+        case Opcode::NotEqual:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+export std::string_view GetOpcodeName(Opcode opcode)
+{
+    switch (opcode) {
+    case Opcode::Neg:
+        return "neg";
+    case Opcode::Mul:
+        return "mul";
+    case Opcode::Div:
+        return "div";
+    case Opcode::Mod:
+        return "mod";
+    case Opcode::Add:
+        return "add";
+    case Opcode::Sub:
+        return "sub";
+    case Opcode::ShiftLeft:
+        return "shl";
+    case Opcode::ShiftRight:
+        return "shr";
+    case Opcode::BitAnd:
+        return "and";
+    case Opcode::BitXor:
+        return "xor";
+    case Opcode::BitOr:
+        return "or";
+    case Opcode::Equal:
+        return "eq";
+    case Opcode::NotEqual:
+        return "ne";
+    case Opcode::Less:
+        return "lt";
+    case Opcode::LessEqual:
+        return "le";
+    case Opcode::Greater:
+        return "gt";
+    case Opcode::GreaterEqual:
+        return "ge";
+    case Opcode::Convert:
+        return "convert";
+    case Opcode::Call:
+        return "call";
+    case Opcode::Phi:
+        return "phi";
+    case Opcode::Branch:
+        return "br";
+    case Opcode::CondBranch:
+        return "condbr";
+    case Opcode::Return:
+        return "ret";
+    default:
+        assert(false);
+        return "";
+    }
+}
+
+}
\ No newline at end of file
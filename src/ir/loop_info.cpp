@@ -0,0 +1,89 @@
+module;
+
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+export module scc.ir:ir_loop_info;
+import :ir_basic_block;
+import :ir_dominator_tree;
+import :ir_function;
+
+namespace scc::ir {
+
+export struct Loop final {
+    BasicBlock* header {};
+    std::unordered_set<BasicBlock*> blocks {};
+    std::vector<BasicBlock*> latches {};
+
+    // The only predecessor of the header outside the loop, if it has no other successor.
+    BasicBlock* preheader {};
+
+    bool Contains(const BasicBlock* block) const
+    {
+        return blocks.contains(const_cast<BasicBlock*>(block));
+    }
+};
+
+// Natural loops of a function, found from the back edges of the dominator tree. Loops are ordered
+// from innermost to outermost.
+export struct LoopInfo final {
+    LoopInfo(const Function& function, const DominatorTree& dominatorTree)
+    {
+        for (auto header : dominatorTree.GetReversePostOrder()) {
+            auto loop = std::unique_ptr<Loop> {};
+            for (auto predecessor : header->predecessors) {
+                if (!dominatorTree.Dominates(header, predecessor)) {
+                    continue;
+                }
+                if (!loop) {
+                    loop = std::make_unique<Loop>();
+                    loop->header = header;
+                    loop->blocks.insert(header);
+                }
+                loop->latches.push_back(predecessor);
+                CollectLoopBlocks(*loop, predecessor);
+            }
+            if (!loop) {
+                continue;
+            }
+
+            for (auto predecessor : header->predecessors) {
+                if (loop->Contains(predecessor)) {
+                    continue;
+                }
+                if (loop->preheader || predecessor->GetSuccessors().size() != 1) {
+                    loop->preheader = nullptr;
+                    break;
+                }
+                loop->preheader = predecessor;
+            }
+            m_loops.push_back(std::move(loop));
+        }
+
+        std::ranges::stable_sort(m_loops, {}, [](const auto& loop) { return loop->blocks.size(); });
+    }
+
+    const std::vector<std::unique_ptr<Loop>>& GetLoops() const
+    {
+        return m_loops;
+    }
+
+private:
+    static void CollectLoopBlocks(Loop& loop, BasicBlock* latch)
+    {
+        auto pending = std::vector<BasicBlock*> { latch };
+        while (!pending.empty()) {
+            auto block = pending.back();
+            pending.pop_back();
+            if (loop.blocks.insert(block).second) {
+                pending.insert(pending.end(), block->predecessors.begin(), block->predecessors.end());
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Loop>> m_loops {};
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+module;
+
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+export module scc.ir:ir_loop_invariant_code_motion;
+import :ir_basic_block;
+import :ir_dominator_tree;
+import :ir_function;
+import :ir_instruction;
+import :ir_loop_info;
+import :ir_pass_manager;
+import :ir_value;
+
+namespace scc::ir {
+
+// Hoists pure instructions whose operands are all defined outside of a loop into the preheader of
+// the loop, innermost loops first so invariants can move out of a whole loop nest.
+//
+// A hoisted instruction runs even if the loop body never would, so only instructions which can't
+// trap are hoisted, and their arithmetic is made wrapping to not introduce undefined overflow.
+export struct LoopInvariantCodeMotion final : Pass {
+    std::string_view GetName() const override
+    {
+        return "loop-invariant-code-motion";
+    }
+
+    void Run(Function& function) override
+    {
+        function.UpdatePredecessors();
+        auto dominatorTree = DominatorTree { function };
+        auto loopInfo = LoopInfo { function, dominatorTree };
+
+        for (const auto& loop : loopInfo.GetLoops()) {
+            if (loop->preheader) {
+                HoistInvariants(*loop, dominatorTree);
+            }
+        }
+    }
+
+private:
+    static void HoistInvariants(Loop& loop, const DominatorTree& dominatorTree)
+    {
+        auto hoisted = std::unordered_set<const Value*> {};
+        auto isInvariant = [&](const Value* value) {
+            auto instruction = dynamic_cast<const Instruction*>(value);
+            return !instruction || hoisted.contains(instruction) || !loop.Contains(instruction->parent);
+        };
+
+        for (auto changed = true; changed;) {
+            changed = false;
+            for (auto block : dominatorTree.GetReversePostOrder()) {
+                if (!loop.Contains(block)) {
+                    continue;
+                }
+
+                auto candidates = std::vector<Instruction*> {};
+                for (const auto& instruction : block->instructions) {
+                    if (instruction->opcode == Opcode::Phi || !instruction->IsSafeToSpeculate()) {
+                        continue;
+                    }
+                    auto invariant = true;
+                    for (auto operand : instruction->operands) {
+                        invariant = invariant && isInvariant(operand);
+                    }
+                    if (invariant) {
+                        candidates.push_back(instruction.get());
+                        hoisted.insert(instruction.get());
+                    }
+                }
+
+                for (auto instruction : candidates) {
+                    auto moved = block->Remove(instruction);
+                    moved->wraps = true;
+                    loop.preheader->InsertBeforeTerminator(std::move(moved));
+                    changed = true;
+                }
+            }
+        }
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+module;
+
+export module scc.ir;
+export import :ir_basic_block;
+export import :ir_common_subexpression_elimination;
+export import :ir_dead_code_elimination;
+export import :ir_dominator_tree;
+export import :ir_function;
+export import :ir_instruction;
+export import :ir_loop_info;
+export import :ir_loop_invariant_code_motion;
+export import :ir_pass_manager;
+export import :ir_strength_reduction;
+export import :ir_type;
+export import :ir_value;
\ No newline at end of file
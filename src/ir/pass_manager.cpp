@@ -0,0 +1,61 @@
+module;
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module scc.ir:ir_pass_manager;
+import :ir_function;
+
+namespace scc::ir {
+
+export struct Pass {
+    virtual ~Pass() = default;
+
+    virtual std::string_view GetName() const = 0;
+    virtual void Run(Function& function) = 0;
+};
+
+export struct PassTiming {
+    std::string name {};
+    std::chrono::nanoseconds duration {};
+};
+
+// Runs a sequence of passes over every function of a program, and records how long each pass
+// takes in total.
+export struct PassManager final {
+    void AddPass(std::unique_ptr<Pass> pass)
+    {
+        m_timings.push_back(PassTiming { .name = std::string { pass->GetName() } });
+        m_passes.push_back(std::move(pass));
+    }
+
+    void Run(Program& program)
+    {
+        for (size_t i = 0; i < m_passes.size(); ++i) {
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& function : program.functions) {
+                m_passes[i]->Run(*function);
+            }
+            m_timings[i].duration += std::chrono::steady_clock::now() - start;
+        }
+
+        // Passes leave the ids of new instructions unset.
+        for (const auto& function : program.functions) {
+            function->Renumber();
+        }
+    }
+
+    const std::vector<PassTiming>& GetTimings() const
+    {
+        return m_timings;
+    }
+
+private:
+    std::vector<std::unique_ptr<Pass>> m_passes {};
+    std::vector<PassTiming> m_timings {};
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+module;
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+export module scc.ir:ir_strength_reduction;
+import :ir_basic_block;
+import :ir_dominator_tree;
+import :ir_function;
+import :ir_instruction;
+import :ir_loop_info;
+import :ir_pass_manager;
+import :ir_type;
+import :ir_value;
+
+namespace scc::ir {
+
+// Replaces the multiplication of a basic induction variable by a constant inside a loop with a new
+// induction variable which is incremented by the scaled step on every iteration:
+//
+//     i = phi(init, i + step)         i = phi(init, i + step)
+//     x = i * k                 =>    x = phi(init * k, x + step * k)
+//
+// The new induction variable wraps on overflow, so it never introduces undefined behavior the
+// original program didn't have, e.g. computing `init * k` when the loop body never runs.
+export struct StrengthReduction final : Pass {
+    std::string_view GetName() const override
+    {
+        return "strength-reduction";
+    }
+
+    void Run(Function& function) override
+    {
+        function.UpdatePredecessors();
+        auto dominatorTree = DominatorTree { function };
+        auto loopInfo = LoopInfo { function, dominatorTree };
+
+        for (const auto& loop : loopInfo.GetLoops()) {
+            if (loop->preheader && loop->latches.size() == 1) {
+                ReduceLoop(function, *loop);
+            }
+        }
+    }
+
+private:
+    struct InductionVariable {
+        Instruction* phi {};
+        Value* init {};
+        int64_t step {};
+    };
+
+    static void ReduceLoop(Function& function, const Loop& loop)
+    {
+        for (const auto& inductionVariable : FindInductionVariables(loop)) {
+            auto candidates = std::vector<std::pair<Instruction*, Constant*>> {};
+            for (const auto& block : function.blocks) {
+                if (!loop.Contains(block.get())) {
+                    continue;
+                }
+                for (const auto& instruction : block->instructions) {
+                    if (auto factor = GetScaleFactor(*instruction, inductionVariable.phi)) {
+                        candidates.emplace_back(instruction.get(), factor);
+                    }
+                }
+            }
+
+            for (auto [multiplication, factor] : candidates) {
+                auto type = multiplication->type;
+                int64_t scaledStep {};
+                if (__builtin_mul_overflow(inductionVariable.step, factor->value, &scaledStep) || !IsInRange(scaledStep, type)) {
+                    continue;
+                }
+
+                auto init = std::make_unique<Instruction>(Opcode::Mul, type, std::vector<Value*> { inductionVariable.init, factor });
+                init->wraps = true;
+                auto initValue = loop.preheader->InsertBeforeTerminator(std::move(init));
+
+                auto phi = loop.header->InsertPhi(std::make_unique<Instruction>(Opcode::Phi, type));
+
+                auto next = std::make_unique<Instruction>(Opcode::Add, type, std::vector<Value*> { phi, function.GetConstant(type, scaledStep) });
+                next->wraps = true;
+                auto nextValue = loop.latches.front()->InsertBeforeTerminator(std::move(next));
+
+                phi->operands = { initValue, nextValue };
+                phi->blocks = { loop.preheader, loop.latches.front() };
+
+                function.ReplaceAllUses(multiplication, phi);
+                multiplication->parent->Remove(multiplication);
+            }
+        }
+    }
+
+    static std::vector<InductionVariable> FindInductionVariables(const Loop& loop)
+    {
+        auto inductionVariables = std::vector<InductionVariable> {};
+        for (const auto& instruction : loop.header->instructions) {
+            if (instruction->opcode != Opcode::Phi) {
+                break;
+            }
+            if (instruction->operands.size() != 2 || (instruction->type != Type::Int && instruction->type != Type::Long)) {
+                continue;
+            }
+
+            auto phi = instruction.get();
+            auto latchIndex = phi->blocks[0] == loop.latches.front() ? 0 : 1;
+            if (phi->blocks[latchIndex] != loop.latches.front() || phi->blocks[1 - latchIndex] != loop.preheader) {
+                continue;
+            }
+
+            auto next = dynamic_cast<Instruction*>(phi->operands[latchIndex]);
+            if (!next || next->type != phi->type || (next->opcode != Opcode::Add && next->opcode != Opcode::Sub)) {
+                continue;
+            }
+
+            auto step = std::optional<int64_t> {};
+            if (next->operands[0] == phi) {
+                if (auto constant = dynamic_cast<Constant*>(next->operands[1])) {
+                    step = next->opcode == Opcode::Add ? constant->value : -constant->value;
+                }
+            } else if (next->operands[1] == phi && next->opcode == Opcode::Add) {
+                if (auto constant = dynamic_cast<Constant*>(next->operands[0])) {
+                    step = constant->value;
+                }
+            }
+            if (step) {
+                inductionVariables.push_back(InductionVariable { .phi = phi, .init = phi->operands[1 - latchIndex], .step = *step });
+            }
+        }
+        return inductionVariables;
+    }
+
+    // Returns the constant factor if the instruction multiplies the induction variable by it.
+    static Constant* GetScaleFactor(const Instruction& instruction, const Instruction* phi)
+    {
+        if (instruction.opcode != Opcode::Mul || instruction.type != phi->type) {
+            return nullptr;
+        }
+        if (instruction.operands[0] == phi) {
+            return dynamic_cast<Constant*>(instruction.operands[1]);
+        } else if (instruction.operands[1] == phi) {
+            return dynamic_cast<Constant*>(instruction.operands[0]);
+        } else {
+            return nullptr;
+        }
+    }
+
+    static bool IsInRange(int64_t value, Type type)
+    {
+        if (type == Type::Int) {
+            return value >= std::numeric_limits<int32_t>::min() && value <= std::numeric_limits<int32_t>::max();
+        }
+        return true;
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+module;
+
+#include <cassert>
+#include <string_view>
+
+export module scc.ir:ir_type;
+
+namespace scc::ir {
+
+export enum class Type {
+    Void,
+    Bool,
+    Int,
+    Long,
+    String,
+};
+
+export std::string_view GetTypeName(Type type)
+{
+    switch (type) {
+    case Type::Void:
+        return "void";
+    case Type::Bool:
+        return "bool";
+    case Type::Int:
+        return "int";
+    case Type::Long:
+        return "long";
+    case Type::String:
+        return "string";
+    default:
+        assert(false);
+        return "";
+    }
+}
+
+}
\ No newline at end of file
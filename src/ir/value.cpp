@@ -0,0 +1,52 @@
+module;
+
+#include <cstdint>
+#include <string>
+
+export module scc.ir:ir_value;
+import :ir_type;
+
+namespace scc::ir {
+
+export struct Value {
+    Type type {};
+
+    explicit Value(Type type)
+        : type { type }
+    {
+    }
+
+    virtual ~Value() = default;
+};
+
+export struct Constant final : Value {
+    int64_t value {};
+
+    Constant(Type type, int64_t value)
+        : Value { type }
+        , value { value }
+    {
+    }
+};
+
+export struct StringConstant final : Value {
+    std::string value {};
+
+    explicit StringConstant(std::string value)
+        : Value { Type::String }
+        , value { std::move(value) }
+    {
+    }
+};
+
+export struct Argument final : Value {
+    std::string name {};
+
+    Argument(Type type, std::string name)
+        : Value { type }
+        , name { std::move(name) }
+    {
+    }
+};
+
+}
\ No newline at end of file
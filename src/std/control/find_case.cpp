@@ -0,0 +1,21 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+export module scc.std.find_case;
+
+namespace scc::std {
+
+// Returns the position of `value` in the sorted case values of a sparse switch statement, or -1 if
+// it's none of them. The positions are compact, so the statement dispatches on them with a jump
+// table after the binary search.
+export template <class T, ::std::size_t N>
+constexpr int find_case(const T (&values)[N], ::std::type_identity_t<T> value)
+{
+    auto it = ::std::lower_bound(values, values + N, value);
+    return it != values + N && *it == value ? static_cast<int>(it - values) : -1;
+}
+
+}
\ No newline at end of file
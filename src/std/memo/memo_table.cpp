@@ -0,0 +1,98 @@
+module;
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+export module scc.std.memo_table;
+
+namespace scc::std {
+
+// Caches the results of a function by its integer arguments. Entries are stored inline in a flat
+// array with a power of two size and found by linear probing, so a lookup hashes the arguments once
+// and usually touches a single cache line. The table is pre-sized for `capacity` entries and
+// doubles when it is half full.
+export template <class Result, class... Args>
+class memo_table final {
+public:
+    explicit memo_table(::std::size_t capacity = 1024)
+    {
+        auto size = ::std::size_t { 16 };
+        while (size < capacity * 2) {
+            size *= 2;
+        }
+        m_entries.resize(size);
+    }
+
+    const Result* find(Args... args) const
+    {
+        auto key = key_type { static_cast<::std::int64_t>(args)... };
+        auto& entry = m_entries[find_slot(m_entries, key)];
+        return entry.used ? &entry.value : nullptr;
+    }
+
+    const Result& insert(Result value, Args... args)
+    {
+        if ((m_size + 1) * 2 > m_entries.size()) {
+            grow();
+        }
+
+        auto key = key_type { static_cast<::std::int64_t>(args)... };
+        auto& entry = m_entries[find_slot(m_entries, key)];
+        if (!entry.used) {
+            entry.key = key;
+            entry.used = true;
+            ++m_size;
+        }
+        entry.value = ::std::move(value);
+        return entry.value;
+    }
+
+private:
+    using key_type = ::std::array<::std::int64_t, sizeof...(Args)>;
+
+    struct entry_type {
+        key_type key {};
+        Result value {};
+        bool used {};
+    };
+
+    static ::std::uint64_t hash(const key_type& key)
+    {
+        // Mix every argument in with the multiplier and shift of splitmix64.
+        auto h = ::std::uint64_t { 0x9e3779b97f4a7c15 };
+        for (auto k : key) {
+            h ^= static_cast<::std::uint64_t>(k);
+            h *= 0xbf58476d1ce4e5b9;
+            h ^= h >> 31;
+        }
+        return h;
+    }
+
+    static ::std::size_t find_slot(const ::std::vector<entry_type>& entries, const key_type& key)
+    {
+        auto mask = entries.size() - 1;
+        auto i = hash(key) & mask;
+        while (entries[i].used && entries[i].key != key) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void grow()
+    {
+        auto entries = ::std::vector<entry_type>(m_entries.size() * 2);
+        for (auto& entry : m_entries) {
+            if (entry.used) {
+                entries[find_slot(entries, entry.key)] = ::std::move(entry);
+            }
+        }
+        m_entries = ::std::move(entries);
+    }
+
+    ::std::vector<entry_type> m_entries {};
+    ::std::size_t m_size {};
+};
+
+}
\ No newline at end of file
@@ -1,4 +1,13 @@
 module;
 
 export module scc.std;
-export import :println;
\ No newline at end of file
+export import scc.std.find_case;
+export import scc.std.fork_join;
+export import scc.std.memo_table;
+export import scc.std.parallel_for;
+export import scc.std.print_parts;
+export import scc.std.println;
+export import scc.std.sequence;
+export import scc.std.simd;
+export import scc.std.spawn;
+export import scc.std.types;
\ No newline at end of file
@@ -0,0 +1,317 @@
+module;
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+export module scc.std.fork_join;
+
+namespace scc::std {
+
+// A forked or spawned unit of work. A forked task lives in the frame of the forking function, which
+// waits until it's done before returning, a spawned one in the frame of its coroutine.
+export struct task {
+    void (*run)(task* self) {};
+    int depth {};
+    ::std::atomic<bool> done {};
+};
+
+// Work-stealing scheduler. Every worker pushes and pops the tasks it forks at the back of its own
+// deque, and idle workers steal from the front of the others' deques, where the oldest and usually
+// largest tasks are. The thread which first forks is worker 0, `SCC_NUM_THREADS - 1` more threads
+// are started for the other workers. Tasks submitted by other threads go to a shared injection queue,
+// which workers check after their deques.
+export class task_scheduler final {
+public:
+    static task_scheduler& instance()
+    {
+        static task_scheduler scheduler {};
+        return scheduler;
+    }
+
+    ~task_scheduler()
+    {
+        {
+            auto lock = ::std::lock_guard { m_sleepMutex };
+            m_stopping = true;
+        }
+        m_wakeup.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    // Forking deeper than the cutoff only adds overhead, as there are already enough tasks to keep
+    // every worker busy, so the caller runs both sides sequentially.
+    bool can_fork() const
+    {
+        return s_workerIndex >= 0 && s_depth < m_cutoffDepth;
+    }
+
+    int depth() const
+    {
+        return s_depth;
+    }
+
+    int thread_count() const
+    {
+        return static_cast<int>(m_workers.size());
+    }
+
+    void push(task* t)
+    {
+        auto& worker = *m_workers[s_workerIndex];
+        {
+            auto lock = ::std::lock_guard { worker.mutex };
+            worker.tasks.push_back(t);
+        }
+        wake_one();
+    }
+
+    // Pushes the task if the current thread is a worker, otherwise queues it for any worker.
+    void submit(task* t)
+    {
+        if (s_workerIndex >= 0) {
+            push(t);
+            return;
+        }
+        {
+            auto lock = ::std::lock_guard { m_injectionMutex };
+            m_injected.push_back(t);
+        }
+        wake_one();
+    }
+
+    // Removes the task if it is still at the back of the current worker's deque, i.e. it was not
+    // stolen.
+    bool pop(task* t)
+    {
+        auto& worker = *m_workers[s_workerIndex];
+        auto lock = ::std::lock_guard { worker.mutex };
+        if (worker.tasks.empty() || worker.tasks.back() != t) {
+            return false;
+        }
+        worker.tasks.pop_back();
+        m_pending.fetch_sub(1, ::std::memory_order_relaxed);
+        return true;
+    }
+
+    void execute(task* t)
+    {
+        auto depth = s_depth;
+        s_depth = t->depth;
+        t->run(t);
+        s_depth = depth;
+        t->done.store(true, ::std::memory_order_release);
+    }
+
+    // Runs tasks stolen from other workers until the task, which was stolen itself, is done.
+    void wait(task* t)
+    {
+        while (!t->done.load(::std::memory_order_acquire)) {
+            if (auto stolen = steal(s_workerIndex)) {
+                execute(stolen);
+            } else {
+                ::std::this_thread::yield();
+            }
+        }
+    }
+
+    // Waits for a submitted task. Unlike a forked one it may be anywhere in the queue of the current
+    // thread, so it's taken out and run inline if no one started it yet, otherwise the thread helps
+    // with other tasks until it's done.
+    void join(task* t)
+    {
+        if (t->done.load(::std::memory_order_acquire)) {
+            return;
+        }
+        if (take(t)) {
+            execute(t);
+            return;
+        }
+        wait(t);
+    }
+
+private:
+    struct worker {
+        ::std::mutex mutex {};
+        ::std::deque<task*> tasks {};
+    };
+
+    task_scheduler()
+    {
+        auto threadCount = static_cast<int>(::std::thread::hardware_concurrency());
+        if (auto env = ::std::getenv("SCC_NUM_THREADS")) {
+            threadCount = ::std::atoi(env);
+        }
+        threadCount = ::std::max(threadCount, 1);
+
+        // Around 16 tasks per worker balance the load without flooding the deques. `SCC_FORK_DEPTH`
+        // sets another depth, to compare with.
+        m_cutoffDepth = threadCount == 1 ? 0 : ::std::bit_width(static_cast<unsigned>(threadCount - 1)) + 4;
+        if (auto env = ::std::getenv("SCC_FORK_DEPTH")) {
+            m_cutoffDepth = ::std::max(::std::atoi(env), 0);
+        }
+
+        for (auto i = 0; i < threadCount; ++i) {
+            m_workers.push_back(::std::make_unique<worker>());
+        }
+        s_workerIndex = 0;
+        for (auto i = 1; i < threadCount; ++i) {
+            m_threads.emplace_back([this, i] { run_worker(i); });
+        }
+    }
+
+    void run_worker(int index)
+    {
+        s_workerIndex = index;
+        while (true) {
+            if (auto t = steal(index)) {
+                execute(t);
+                continue;
+            }
+
+            // Parks the thread. The sleeper count is raised before checking for pending tasks and a
+            // pusher raises the pending count before checking for sleepers, both sequentially
+            // consistent, so at least one of them sees the other and no wakeup is lost, while
+            // pushes with no one asleep skip the lock and the notification.
+            auto lock = ::std::unique_lock { m_sleepMutex };
+            m_sleeping.fetch_add(1, ::std::memory_order_seq_cst);
+            m_wakeup.wait(lock, [this] { return m_stopping || m_pending.load(::std::memory_order_seq_cst) > 0; });
+            m_sleeping.fetch_sub(1, ::std::memory_order_relaxed);
+            if (m_stopping) {
+                return;
+            }
+        }
+    }
+
+    void wake_one()
+    {
+        m_pending.fetch_add(1, ::std::memory_order_seq_cst);
+        if (m_sleeping.load(::std::memory_order_seq_cst) > 0) {
+            {
+                auto lock = ::std::lock_guard { m_sleepMutex };
+            }
+            m_wakeup.notify_one();
+        }
+    }
+
+    // Removes the task from wherever it is in the current thread's queue.
+    bool take(task* t)
+    {
+        auto& mutex = s_workerIndex >= 0 ? m_workers[s_workerIndex]->mutex : m_injectionMutex;
+        auto& tasks = s_workerIndex >= 0 ? m_workers[s_workerIndex]->tasks : m_injected;
+        auto lock = ::std::lock_guard { mutex };
+        auto it = ::std::find(tasks.rbegin(), tasks.rend(), t);
+        if (it == tasks.rend()) {
+            return false;
+        }
+        tasks.erase(::std::next(it).base());
+        m_pending.fetch_sub(1, ::std::memory_order_relaxed);
+        return true;
+    }
+
+    // Threads which aren't workers steal with index -1, so every worker is a victim. A worker comes
+    // last and takes from the back of its own deque, where spawned tasks it didn't join are left.
+    task* steal(int thief)
+    {
+        for (::std::size_t i = 1; i <= m_workers.size(); ++i) {
+            auto victimIndex = (thief + i) % m_workers.size();
+            auto& victim = *m_workers[victimIndex];
+            auto lock = ::std::lock_guard { victim.mutex };
+            if (!victim.tasks.empty()) {
+                auto t = victim.tasks.front();
+                if (static_cast<int>(victimIndex) == thief) {
+                    t = victim.tasks.back();
+                    victim.tasks.pop_back();
+                } else {
+                    victim.tasks.pop_front();
+                }
+                m_pending.fetch_sub(1, ::std::memory_order_relaxed);
+                return t;
+            }
+        }
+
+        auto lock = ::std::lock_guard { m_injectionMutex };
+        if (m_injected.empty()) {
+            return nullptr;
+        }
+        auto t = m_injected.front();
+        m_injected.pop_front();
+        m_pending.fetch_sub(1, ::std::memory_order_relaxed);
+        return t;
+    }
+
+    static thread_local int s_workerIndex;
+    static thread_local int s_depth;
+
+    int m_cutoffDepth {};
+    ::std::vector<::std::unique_ptr<worker>> m_workers {};
+    ::std::vector<::std::thread> m_threads {};
+    ::std::mutex m_injectionMutex {};
+    ::std::deque<task*> m_injected {};
+    ::std::atomic<int> m_pending {};
+    ::std::atomic<int> m_sleeping {};
+    ::std::mutex m_sleepMutex {};
+    ::std::condition_variable m_wakeup {};
+    bool m_stopping {};
+};
+
+thread_local int task_scheduler::s_workerIndex { -1 };
+thread_local int task_scheduler::s_depth {};
+
+template <class Function>
+struct function_task final : task {
+    Function& function;
+    ::std::optional<::std::invoke_result_t<Function&>> result {};
+
+    explicit function_task(Function& function)
+        : function { function }
+    {
+        run = [](task* self) {
+            auto functionTask = static_cast<function_task*>(self);
+            functionTask->result.emplace(functionTask->function());
+        };
+    }
+};
+
+// Evaluates `left()` and `right()` in parallel and returns `combine(left(), right())`. The right side
+// is offered to other workers while the calling thread evaluates the left side, and is evaluated by
+// the calling thread too if no one stole it meanwhile.
+export template <class Left, class Right, class Combine>
+auto fork_join(Left&& left, Right&& right, Combine&& combine)
+{
+    auto& scheduler = task_scheduler::instance();
+    if (!scheduler.can_fork()) {
+        auto leftResult = left();
+        return combine(::std::move(leftResult), right());
+    }
+
+    auto rightTask = function_task<Right> { right };
+    rightTask.depth = scheduler.depth() + 1;
+    scheduler.push(&rightTask);
+
+    auto leftTask = function_task<Left> { left };
+    leftTask.depth = scheduler.depth() + 1;
+    scheduler.execute(&leftTask);
+
+    if (scheduler.pop(&rightTask)) {
+        scheduler.execute(&rightTask);
+    } else {
+        scheduler.wait(&rightTask);
+    }
+    return combine(::std::move(*leftTask.result), ::std::move(*rightTask.result));
+}
+
+}
\ No newline at end of file
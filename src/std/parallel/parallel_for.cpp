@@ -0,0 +1,158 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <utility>
+
+export module scc.std.parallel_for;
+import scc.std.fork_join;
+
+namespace scc::std {
+
+// The reductions of a parallel for loop. Every chunk reduces into a value of its own, which starts at
+// the identity of the operation, the values of the chunks are combined in chunk order, and then
+// combined into the target.
+export template <class T>
+struct sum_reduction final {
+    using value_type = T;
+
+    T& target;
+
+    static constexpr T identity()
+    {
+        return T {};
+    }
+
+    static constexpr T combine(T left, T right)
+    {
+        return static_cast<T>(left + right);
+    }
+};
+
+export template <class T>
+struct min_reduction final {
+    using value_type = T;
+
+    T& target;
+
+    static constexpr T identity()
+    {
+        return ::std::numeric_limits<T>::has_infinity ? ::std::numeric_limits<T>::infinity() : ::std::numeric_limits<T>::max();
+    }
+
+    static constexpr T combine(T left, T right)
+    {
+        return right < left ? right : left;
+    }
+};
+
+export template <class T>
+struct max_reduction final {
+    using value_type = T;
+
+    T& target;
+
+    static constexpr T identity()
+    {
+        return ::std::numeric_limits<T>::has_infinity ? -::std::numeric_limits<T>::infinity() : ::std::numeric_limits<T>::lowest();
+    }
+
+    static constexpr T combine(T left, T right)
+    {
+        return left < right ? right : left;
+    }
+};
+
+export template <class T>
+sum_reduction<T> reduce_sum(T& target)
+{
+    return { target };
+}
+
+export template <class T>
+min_reduction<T> reduce_min(T& target)
+{
+    return { target };
+}
+
+export template <class T>
+max_reduction<T> reduce_max(T& target)
+{
+    return { target };
+}
+
+// The iterations `[begin, end)` split into `count` chunks of `size` iterations, the last one may be
+// shorter. The offsets are computed in unsigned arithmetic, so they can't overflow whatever the
+// index type.
+template <class Index>
+struct chunked_range final {
+    Index begin {};
+    Index end {};
+    unsigned long long size {};
+    ::std::size_t count {};
+
+    Index chunk_begin(::std::size_t chunk) const
+    {
+        return static_cast<Index>(static_cast<unsigned long long>(begin) + chunk * size);
+    }
+
+    Index chunk_end(::std::size_t chunk) const
+    {
+        return chunk + 1 == count ? end : chunk_begin(chunk + 1);
+    }
+};
+
+template <::std::size_t... Indices, class... Reductions>
+::std::tuple<typename Reductions::value_type...> combine_partials(const ::std::tuple<typename Reductions::value_type...>& left,
+    const ::std::tuple<typename Reductions::value_type...>& right, ::std::index_sequence<Indices...>, const Reductions&... reductions)
+{
+    return { reductions.combine(::std::get<Indices>(left), ::std::get<Indices>(right))... };
+}
+
+// Runs the chunks `[first, last)` by halves, so idle workers steal the largest halves left.
+template <class Index, class Body, class... Reductions>
+::std::tuple<typename Reductions::value_type...> run_chunks(const chunked_range<Index>& range, ::std::size_t first, ::std::size_t last, Body& body, const Reductions&... reductions)
+{
+    if (last - first == 1) {
+        auto partials = ::std::tuple<typename Reductions::value_type...> { reductions.identity()... };
+        ::std::apply([&](auto&... values) { body(range.chunk_begin(first), range.chunk_end(first), values...); }, partials);
+        return partials;
+    }
+
+    auto middle = first + (last - first) / 2;
+    return fork_join(
+        [&] { return run_chunks(range, first, middle, body, reductions...); },
+        [&] { return run_chunks(range, middle, last, body, reductions...); },
+        [&](const auto& left, const auto& right) { return combine_partials(left, right, ::std::index_sequence_for<Reductions...> {}, reductions...); });
+}
+
+// Calls `body(chunkBegin, chunkEnd, partials&...)` for chunks of the iterations `[begin, end)` on
+// the workers of the `task_scheduler`, whose number is set by `SCC_NUM_THREADS`. There are a few
+// chunks per worker, enough to balance iterations of uneven cost without paying for a task per
+// iteration. `partials` are the values of the chunk for the reductions, which are combined into
+// their targets once all chunks are done.
+export template <class Index, class Body, class... Reductions>
+void parallel_for(Index begin, Index end, Body&& body, Reductions... reductions)
+{
+    if (!(begin < end)) {
+        return;
+    }
+
+    constexpr auto chunksPerWorker = 8ull;
+    auto& scheduler = task_scheduler::instance();
+    auto iterations = static_cast<unsigned long long>(end) - static_cast<unsigned long long>(begin);
+    auto chunks = ::std::min(iterations, scheduler.thread_count() == 1 ? 1ull : scheduler.thread_count() * chunksPerWorker);
+
+    auto range = chunked_range<Index> { begin, end };
+    range.size = iterations / chunks + (iterations % chunks != 0);
+    range.count = static_cast<::std::size_t>(iterations / range.size + (iterations % range.size != 0));
+
+    auto partials = run_chunks(range, 0, range.count, body, reductions...);
+    [&]<::std::size_t... Indices>(::std::index_sequence<Indices...>) {
+        ((reductions.target = reductions.combine(reductions.target, ::std::get<Indices>(partials))), ...);
+    }(::std::index_sequence_for<Reductions...> {});
+}
+
+}
\ No newline at end of file
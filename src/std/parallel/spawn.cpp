@@ -0,0 +1,174 @@
+module;
+
+#include <atomic>
+#include <coroutine>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+export module scc.std.spawn;
+import scc.std.fork_join;
+
+namespace scc::std {
+
+export template <class T>
+class task_handle;
+
+template <class T>
+struct task_result {
+    ::std::optional<T> value {};
+
+    template <class U>
+    void return_value(U&& result)
+    {
+        value.emplace(::std::forward<U>(result));
+    }
+};
+
+template <>
+struct task_result<void> {
+    void return_void()
+    {
+    }
+};
+
+// The promise of a spawned call. It is the scheduler task too, whose run resumes the coroutine. The
+// coroutine is submitted when it first suspends and stays suspended at its end, so the frame, and the
+// result with it, lives until the last handle is gone.
+template <class T>
+struct task_promise final : task, task_result<T> {
+    ::std::atomic<int> references { 1 };
+
+    task_promise()
+    {
+        run = [](task* self) {
+            ::std::coroutine_handle<task_promise>::from_promise(*static_cast<task_promise*>(self)).resume();
+        };
+    }
+
+    struct submit final {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(::std::coroutine_handle<task_promise> coroutine) const noexcept
+        {
+            auto& scheduler = task_scheduler::instance();
+            coroutine.promise().depth = scheduler.depth();
+            scheduler.submit(&coroutine.promise());
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    task_handle<T> get_return_object()
+    {
+        return task_handle<T> { ::std::coroutine_handle<task_promise>::from_promise(*this) };
+    }
+
+    submit initial_suspend() noexcept
+    {
+        return {};
+    }
+
+    ::std::suspend_always final_suspend() noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception()
+    {
+        ::std::terminate();
+    }
+};
+
+// A spawned call. Handles share the task, so it can be awaited through any copy, and the last one
+// to go away waits for it if no one did.
+export template <class T>
+class task_handle final {
+public:
+    using promise_type = task_promise<T>;
+
+    task_handle() = default;
+
+    explicit task_handle(::std::coroutine_handle<promise_type> coroutine)
+        : m_coroutine { coroutine }
+    {
+    }
+
+    task_handle(const task_handle& other)
+        : m_coroutine { other.m_coroutine }
+    {
+        if (m_coroutine) {
+            m_coroutine.promise().references.fetch_add(1, ::std::memory_order_relaxed);
+        }
+    }
+
+    task_handle(task_handle&& other) noexcept
+        : m_coroutine { ::std::exchange(other.m_coroutine, nullptr) }
+    {
+    }
+
+    task_handle& operator=(task_handle other) noexcept
+    {
+        ::std::swap(m_coroutine, other.m_coroutine);
+        return *this;
+    }
+
+    ~task_handle()
+    {
+        if (m_coroutine && m_coroutine.promise().references.fetch_sub(1, ::std::memory_order_acq_rel) == 1) {
+            task_scheduler::instance().join(&m_coroutine.promise());
+            m_coroutine.destroy();
+        }
+    }
+
+    decltype(auto) get() const
+    {
+        if (!m_coroutine) [[unlikely]] {
+            ::std::fputs("await of a task which was never spawned\n", stderr);
+            ::std::abort();
+        }
+        task_scheduler::instance().join(&m_coroutine.promise());
+        if constexpr (!::std::is_void_v<T>) {
+            return static_cast<const T&>(*m_coroutine.promise().value);
+        }
+    }
+
+private:
+    ::std::coroutine_handle<promise_type> m_coroutine {};
+};
+
+template <class Function>
+task_handle<::std::invoke_result_t<Function&>> run_spawned(Function function)
+{
+    if constexpr (::std::is_void_v<::std::invoke_result_t<Function&>>) {
+        function();
+        co_return;
+    } else {
+        co_return function();
+    }
+}
+
+// Runs `function()` as a task of the scheduler. Awaiting it from a function which isn't a task itself
+// can't suspend, so the awaiting thread runs the task inline if no worker started it yet, or helps
+// with other tasks until it's done.
+export template <class Function>
+auto spawn(Function function)
+{
+    return run_spawned(::std::move(function));
+}
+
+export template <class T>
+T await(const task_handle<T>& handle)
+{
+    return handle.get();
+}
+
+}
\ No newline at end of file
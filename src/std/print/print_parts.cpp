@@ -0,0 +1,76 @@
+module;
+
+#include <charconv>
+#include <concepts>
+#include <cstdio>
+#include <format>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+export module scc.std.print_parts;
+
+namespace scc::std {
+
+// A replacement field with a format spec, its format string is checked when the program is
+// compiled.
+template <class T>
+struct formatted_part {
+    ::std::format_string<const T&> fmt;
+    const T& value;
+};
+
+export template <class T>
+formatted_part<T> format_part(::std::format_string<const T&> fmt, const T& value)
+{
+    return { fmt, value };
+}
+
+// Appends a value the way `{}` formats it.
+template <class T>
+void append_part(::std::string& out, const T& value)
+{
+    ::std::format_to(::std::back_inserter(out), "{}", value);
+}
+
+template <::std::integral T>
+void append_part(::std::string& out, const T& value)
+{
+    char buffer[32];
+    auto result = ::std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+template <class T>
+void append_part(::std::string& out, const formatted_part<T>& part)
+{
+    ::std::format_to(::std::back_inserter(out), part.fmt, part.value);
+}
+
+void append_part(::std::string& out, const char* value)
+{
+    out += value;
+}
+
+void append_part(::std::string& out, char value)
+{
+    out += value;
+}
+
+void append_part(::std::string& out, bool value)
+{
+    out += value ? "true" : "false";
+}
+
+// Prints the parts of a format string which the compiler has already parsed: the text between the
+// replacement fields, and the arguments in between. Nothing is parsed at run time.
+export template <class... Parts>
+void print_parts(const Parts&... parts)
+{
+    static thread_local ::std::string buffer {};
+    buffer.clear();
+    (append_part(buffer, parts), ...);
+    fwrite(buffer.data(), 1, buffer.size(), stdout);
+}
+
+}
\ No newline at end of file
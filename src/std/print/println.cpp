@@ -2,7 +2,7 @@ module;
 
 #include <format>
 
-export module scc.std:println;
+export module scc.std.println;
 
 namespace scc::std {
 
@@ -17,6 +17,13 @@ export void println()
     printf("\n");
 }
 
+// Writes output which the compiler has already formatted, e.g. when evaluating the program ahead
+// of time.
+export void write(const ::std::string_view& output)
+{
+    fwrite(output.data(), 1, output.size(), stdout);
+}
+
 export template <class... Args>
 void print(const ::std::string_view& fmt, Args&&... args)
 {
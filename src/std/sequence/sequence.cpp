@@ -0,0 +1,256 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+export module scc.std.sequence;
+import scc.std.types;
+
+namespace scc::std {
+
+// Reports an index out of bounds and terminates. Kept out of line, so the checks inlined into the
+// loops stay small.
+[[noreturn, gnu::cold, gnu::noinline]] void index_out_of_bounds(i64 index, i64 length)
+{
+    ::std::fprintf(stderr, "index out of bounds: the length is %lld but the index is %lld\n", (long long)length, (long long)index);
+    ::std::abort();
+}
+
+[[noreturn, gnu::cold, gnu::noinline]] void slice_out_of_bounds(i64 begin, i64 end, i64 length)
+{
+    ::std::fprintf(stderr, "slice out of bounds: the length is %lld but the slice is [%lld:%lld]\n", (long long)length, (long long)begin, (long long)end);
+    ::std::abort();
+}
+
+// The checks can run at compile time, where an index out of bounds fails the compilation.
+constexpr void check_index(i64 index, i64 length)
+{
+    // A negative index wraps to a large unsigned value, so one comparison checks both bounds.
+    if ((u64)index >= (u64)length) [[unlikely]] {
+        index_out_of_bounds(index, length);
+    }
+}
+
+// Exported for the SIMD loads, which check the lanes they read the same way.
+export constexpr void check_slice(i64 begin, i64 end, i64 length)
+{
+    if (begin < 0 || begin > end || end > length) [[unlikely]] {
+        slice_out_of_bounds(begin, end, length);
+    }
+}
+
+export template <class T>
+class slice;
+
+// `T[N]`, the elements are stored inline. It is an aggregate, so `array<int, 3> a { 1, 2, 3 }`
+// initializes the elements.
+export template <class T, ::std::size_t N>
+struct array {
+    T elements[N];
+
+    constexpr T* data() { return elements; }
+    constexpr const T* data() const { return elements; }
+    constexpr i64 size() const { return N; }
+
+    constexpr T& operator[](i64 index)
+    {
+        check_index(index, N);
+        return elements[index];
+    }
+
+    constexpr const T& operator[](i64 index) const
+    {
+        check_index(index, N);
+        return elements[index];
+    }
+
+    constexpr slice<T> subslice() { return { elements, size() }; }
+    constexpr slice<T> subslice(i64 begin) { return subslice(begin, N); }
+    constexpr slice<T> subslice(i64 begin, i64 end)
+    {
+        check_slice(begin, end, N);
+        return { elements + begin, end - begin };
+    }
+};
+
+// `T[]`, the elements are stored contiguously on the heap, and the capacity doubles when an element
+// is pushed to a full vector. Copies are deep, like the arrays.
+export template <class T>
+class vector final {
+public:
+    vector() = default;
+
+    vector(::std::initializer_list<T> elements)
+    {
+        reserve(elements.size());
+        for (const auto& element : elements) {
+            m_data[m_length++] = element;
+        }
+    }
+
+    vector(const vector& other)
+    {
+        reserve(other.m_length);
+        ::std::copy_n(other.m_data.get(), other.m_length, m_data.get());
+        m_length = other.m_length;
+    }
+
+    vector(vector&& other) noexcept
+    {
+        swap(other);
+    }
+
+    vector& operator=(vector other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    T* data() { return m_data.get(); }
+    const T* data() const { return m_data.get(); }
+    i64 size() const { return m_length; }
+
+    T& operator[](i64 index)
+    {
+        check_index(index, m_length);
+        return m_data[index];
+    }
+
+    const T& operator[](i64 index) const
+    {
+        check_index(index, m_length);
+        return m_data[index];
+    }
+
+    slice<T> subslice() { return { m_data.get(), m_length }; }
+    slice<T> subslice(i64 begin) { return subslice(begin, m_length); }
+    slice<T> subslice(i64 begin, i64 end)
+    {
+        check_slice(begin, end, m_length);
+        return { m_data.get() + begin, end - begin };
+    }
+
+    void push(T value)
+    {
+        if (m_length == m_capacity) [[unlikely]] {
+            reserve(::std::max<i64>(m_capacity * 2, 8));
+        }
+        m_data[m_length++] = ::std::move(value);
+    }
+
+private:
+    void reserve(i64 capacity)
+    {
+        if (capacity <= m_capacity) {
+            return;
+        }
+        auto data = ::std::make_unique<T[]>(capacity);
+        ::std::move(m_data.get(), m_data.get() + m_length, data.get());
+        m_data = ::std::move(data);
+        m_capacity = capacity;
+    }
+
+    void swap(vector& other) noexcept
+    {
+        ::std::swap(m_data, other.m_data);
+        ::std::swap(m_length, other.m_length);
+        ::std::swap(m_capacity, other.m_capacity);
+    }
+
+    ::std::unique_ptr<T[]> m_data {};
+    i64 m_length {};
+    i64 m_capacity {};
+};
+
+// `T[:]`, a view of consecutive elements of an array or a vector. The elements are shared, writing
+// an element of a slice writes the element it views.
+export template <class T>
+class slice final {
+public:
+    slice() = default;
+
+    constexpr slice(T* data, i64 length)
+        : m_data { data }
+        , m_length { length }
+    {
+    }
+
+    template <::std::size_t N>
+    constexpr slice(array<T, N>& elements)
+        : slice { elements.subslice() }
+    {
+    }
+
+    slice(vector<T>& elements)
+        : slice { elements.subslice() }
+    {
+    }
+
+    constexpr T* data() const { return m_data; }
+    constexpr i64 size() const { return m_length; }
+
+    constexpr T& operator[](i64 index) const
+    {
+        check_index(index, m_length);
+        return m_data[index];
+    }
+
+    constexpr slice subslice() const { return *this; }
+    constexpr slice subslice(i64 begin) const { return subslice(begin, m_length); }
+    constexpr slice subslice(i64 begin, i64 end) const
+    {
+        check_slice(begin, end, m_length);
+        return { m_data + begin, end - begin };
+    }
+
+private:
+    T* m_data {};
+    i64 m_length {};
+};
+
+// `std::len(sequence)`
+export template <class T, ::std::size_t N>
+constexpr i64 len(const array<T, N>& elements)
+{
+    return elements.size();
+}
+
+export template <class T>
+i64 len(const vector<T>& elements)
+{
+    return elements.size();
+}
+
+export template <class T>
+constexpr i64 len(const slice<T>& elements)
+{
+    return elements.size();
+}
+
+// `std::push(vector, value)`, the value converts to the element type like an assignment does.
+export template <class T>
+void push(vector<T>& elements, ::std::type_identity_t<T> value)
+{
+    elements.push(::std::move(value));
+}
+
+
+// The struct of arrays of the struct `T`, which stores every field in a `column` of its own, e.g. a
+// `vector`. The compiler specializes it for each struct.
+export template <class T, template <class> class column>
+struct soa;
+
+// The columns of a struct of arrays of a fixed length.
+export template <::std::size_t N>
+struct fixed_column final {
+    template <class T>
+    using type = array<T, N>;
+};
+
+}
\ No newline at end of file
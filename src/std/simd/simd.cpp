@@ -0,0 +1,301 @@
+module;
+
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+export module scc.std.simd;
+import scc.std.sequence;
+import scc.std.types;
+
+namespace scc::std {
+
+template <int Bits>
+struct mask_lane;
+
+template <>
+struct mask_lane<8> {
+    using type = i8;
+};
+
+template <>
+struct mask_lane<16> {
+    using type = i16;
+};
+
+template <>
+struct mask_lane<32> {
+    using type = i32;
+};
+
+template <>
+struct mask_lane<64> {
+    using type = i64;
+};
+
+// `mask32x8`, which lanes of a comparison are true. All bits of a true lane are set, like in the
+// result of comparing vectors of the clang and GCC vector extensions.
+export template <int Bits, int N>
+struct mask final {
+    using lane = typename mask_lane<Bits>::type;
+    typedef lane lanes_type __attribute__((vector_size(sizeof(lane) * N)));
+
+    lanes_type lanes;
+};
+
+// `f32x8`, `N` lanes of `T`. The lanes are a vector of the vector extensions, so the compiler picks
+// the instructions of the target, e.g. SSE2, AVX2 or AVX-512, and splits the vectors which are wider
+// than its registers. A scalar converts to a value with all lanes set to it.
+export template <class T, int N>
+struct simd final {
+    using mask_type = mask<sizeof(T) * 8, N>;
+    typedef T lanes_type __attribute__((vector_size(sizeof(T) * N)));
+
+    lanes_type lanes;
+
+    simd() = default;
+
+    simd(T value)
+    {
+        for (int i = 0; i < N; ++i) {
+            lanes[i] = value;
+        }
+    }
+
+    // Loads the lanes from `values[index:index + N]`.
+    template <::std::size_t M>
+    simd(const array<T, M>& values, i64 index)
+        : simd { load(values.data(), values.size(), index) }
+    {
+    }
+
+    simd(const vector<T>& values, i64 index)
+        : simd { load(values.data(), values.size(), index) }
+    {
+    }
+
+    simd(slice<T> values, i64 index)
+        : simd { load(values.data(), values.size(), index) }
+    {
+    }
+
+    simd& operator+=(simd other)
+    {
+        lanes += other.lanes;
+        return *this;
+    }
+
+    simd& operator-=(simd other)
+    {
+        lanes -= other.lanes;
+        return *this;
+    }
+
+    simd& operator*=(simd other)
+    {
+        lanes *= other.lanes;
+        return *this;
+    }
+
+    simd& operator/=(simd other)
+    {
+        lanes /= other.lanes;
+        return *this;
+    }
+
+    simd& operator%=(simd other)
+        requires ::std::integral<T>
+    {
+        lanes %= other.lanes;
+        return *this;
+    }
+
+    simd& operator<<=(simd other)
+        requires ::std::integral<T>
+    {
+        lanes <<= other.lanes;
+        return *this;
+    }
+
+    simd& operator>>=(simd other)
+        requires ::std::integral<T>
+    {
+        lanes >>= other.lanes;
+        return *this;
+    }
+
+    simd& operator&=(simd other)
+        requires ::std::integral<T>
+    {
+        lanes &= other.lanes;
+        return *this;
+    }
+
+    simd& operator^=(simd other)
+        requires ::std::integral<T>
+    {
+        lanes ^= other.lanes;
+        return *this;
+    }
+
+    simd& operator|=(simd other)
+        requires ::std::integral<T>
+    {
+        lanes |= other.lanes;
+        return *this;
+    }
+
+    // The operators are hidden friends, so a scalar operand converts to `simd` on either side.
+    friend simd operator+(simd left, simd right) { return left += right; }
+    friend simd operator-(simd left, simd right) { return left -= right; }
+    friend simd operator*(simd left, simd right) { return left *= right; }
+    friend simd operator/(simd left, simd right) { return left /= right; }
+
+    friend simd operator%(simd left, simd right)
+        requires ::std::integral<T>
+    {
+        return left %= right;
+    }
+
+    friend simd operator-(simd value)
+    {
+        value.lanes = -value.lanes;
+        return value;
+    }
+
+    friend mask_type operator==(simd left, simd right) { return { (typename mask_type::lanes_type)(left.lanes == right.lanes) }; }
+    friend mask_type operator!=(simd left, simd right) { return { (typename mask_type::lanes_type)(left.lanes != right.lanes) }; }
+    friend mask_type operator<(simd left, simd right) { return { (typename mask_type::lanes_type)(left.lanes < right.lanes) }; }
+    friend mask_type operator<=(simd left, simd right) { return { (typename mask_type::lanes_type)(left.lanes <= right.lanes) }; }
+    friend mask_type operator>(simd left, simd right) { return { (typename mask_type::lanes_type)(left.lanes > right.lanes) }; }
+    friend mask_type operator>=(simd left, simd right) { return { (typename mask_type::lanes_type)(left.lanes >= right.lanes) }; }
+
+private:
+    static simd load(const T* data, i64 length, i64 index)
+    {
+        check_slice(index, index + N, length);
+        auto result = simd {};
+        ::std::memcpy(&result.lanes, data + index, sizeof(result.lanes));
+        return result;
+    }
+};
+
+template <class T, int N>
+void store_lanes(T* data, i64 length, i64 index, simd<T, N> value)
+{
+    check_slice(index, index + N, length);
+    ::std::memcpy(data + index, &value.lanes, sizeof(value.lanes));
+}
+
+// `std::store(values, index, value)` stores the lanes to `values[index:index + N]`.
+export template <class T, int N, ::std::size_t M>
+void store(array<T, M>& values, i64 index, simd<T, N> value)
+{
+    store_lanes(values.data(), values.size(), index, value);
+}
+
+export template <class T, int N>
+void store(vector<T>& values, i64 index, simd<T, N> value)
+{
+    store_lanes(values.data(), values.size(), index, value);
+}
+
+export template <class T, int N>
+void store(slice<T> values, i64 index, simd<T, N> value)
+{
+    store_lanes(values.data(), values.size(), index, value);
+}
+
+// `std::reduce_add(value)` and the other horizontal reductions combine the lanes of a value. The
+// loops are unrolled and turned into shuffles by the compiler.
+export template <class T, int N>
+T reduce_add(simd<T, N> value)
+{
+    auto result = T {};
+    for (int i = 0; i < N; ++i) {
+        result += value.lanes[i];
+    }
+    return result;
+}
+
+export template <class T, int N>
+T reduce_min(simd<T, N> value)
+{
+    T result = value.lanes[0];
+    for (int i = 1; i < N; ++i) {
+        result = value.lanes[i] < result ? value.lanes[i] : result;
+    }
+    return result;
+}
+
+export template <class T, int N>
+T reduce_max(simd<T, N> value)
+{
+    T result = value.lanes[0];
+    for (int i = 1; i < N; ++i) {
+        result = value.lanes[i] > result ? value.lanes[i] : result;
+    }
+    return result;
+}
+
+// `std::select(condition, if_true, if_false)` takes the lanes of `if_true` where the condition is
+// true and of `if_false` elsewhere, which may be a scalar.
+export template <class T, int N>
+simd<T, N> select(mask<sizeof(T) * 8, N> condition, simd<T, N> if_true, ::std::type_identity_t<simd<T, N>> if_false)
+{
+    auto result = simd<T, N> {};
+    for (int i = 0; i < N; ++i) {
+        result.lanes[i] = condition.lanes[i] ? if_true.lanes[i] : if_false.lanes[i];
+    }
+    return result;
+}
+
+// `std::any(condition)`, `std::all(condition)` and `std::count(condition)` test the lanes of a
+// mask.
+export template <int Bits, int N>
+bool any(mask<Bits, N> condition)
+{
+    auto result = false;
+    for (int i = 0; i < N; ++i) {
+        result |= condition.lanes[i] != 0;
+    }
+    return result;
+}
+
+export template <int Bits, int N>
+bool all(mask<Bits, N> condition)
+{
+    auto result = true;
+    for (int i = 0; i < N; ++i) {
+        result &= condition.lanes[i] != 0;
+    }
+    return result;
+}
+
+export template <int Bits, int N>
+i64 count(mask<Bits, N> condition)
+{
+    auto result = i64 {};
+    for (int i = 0; i < N; ++i) {
+        result += condition.lanes[i] != 0;
+    }
+    return result;
+}
+
+// `std::shift_up(value, n)` moves the lanes `n` lanes up, and the lowest `n` lanes become 0. Adding
+// a value shifted by 1, 2, 4, ... lanes to itself sums up the lanes below each lane.
+export template <class T, int N>
+simd<T, N> shift_up(simd<T, N> value, i64 n)
+{
+    if (n <= 0) {
+        return value;
+    }
+    auto result = simd<T, N> {};
+    for (i64 i = n; i < N; ++i) {
+        result.lanes[i] = value.lanes[i - n];
+    }
+    return result;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+module;
+
+#include <cstdint>
+
+export module scc.std.types;
+
+namespace scc::std {
+
+// The sized types of scc, with exactly the width their name says.
+export using i8 = ::std::int8_t;
+export using i16 = ::std::int16_t;
+export using i32 = ::std::int32_t;
+export using i64 = ::std::int64_t;
+export using u8 = ::std::uint8_t;
+export using u16 = ::std::uint16_t;
+export using u32 = ::std::uint32_t;
+export using u64 = ::std::uint64_t;
+export using f32 = float;
+export using f64 = double;
+
+static_assert(sizeof(f32) == 4 && sizeof(f64) == 8);
+
+}
\ No newline at end of file
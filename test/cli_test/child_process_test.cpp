@@ -0,0 +1,52 @@
+#include "test/test.h"
+#include <format>
+#include <sys/wait.h>
+
+import scc.cli;
+
+class ChildProcessTest : public testing::Test {
+protected:
+    std::filesystem::path m_outputFile { std::filesystem::temp_directory_path() / std::format("scc_child_process_test_{}", getpid()) };
+
+    ~ChildProcessTest()
+    {
+        std::filesystem::remove(m_outputFile);
+    }
+};
+
+TEST_F(ChildProcessTest, ReadsInput)
+{
+    scc::cli::ChildProcess process { std::format("cat > {}", m_outputFile.string()) };
+    *process.GetInput() << "int main()\n{\n}\n";
+    process.GetInput()->flush();
+    ASSERT_EQ(process.Wait(), 0);
+    ASSERT_EQ(ReadFileAsString(m_outputFile), "int main()\n{\n}\n");
+}
+
+TEST_F(ChildProcessTest, ExitStatus)
+{
+    scc::cli::ChildProcess process { "cat > /dev/null; exit 3" };
+    *process.GetInput() << "text";
+    auto status = process.Wait();
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 3);
+}
+
+TEST_F(ChildProcessTest, ExitBeforeReading)
+{
+    scc::cli::ChildProcess process { "exit 0" };
+    auto text = std::string(1024 * 1024, 'x');
+    *process.GetInput() << text;
+    ASSERT_EQ(process.Wait(), 0);
+}
+
+TEST_F(ChildProcessTest, ConcurrentProcesses)
+{
+    scc::cli::ChildProcess first { std::format("cat > {}", m_outputFile.string()) };
+    scc::cli::ChildProcess second { "cat > /dev/null" };
+    *first.GetInput() << "first";
+    first.GetInput()->flush();
+    ASSERT_EQ(first.Wait(), 0);
+    ASSERT_EQ(second.Wait(), 0);
+    ASSERT_EQ(ReadFileAsString(m_outputFile), "first");
+}
\ No newline at end of file
@@ -22,6 +22,10 @@ protected:
         m_commandlineProcessor.RegisterOption("only-long", "only long option", [this] {
             m_isOnlyLongOptionOn = true;
         });
+
+        m_commandlineProcessor.RegisterOption('j', "jobs", "N", "number of jobs", [this](const std::string& value) {
+            m_jobs = value;
+        });
     }
 
     void SetCommandLine(const std::vector<const char*>& args)
@@ -34,6 +38,7 @@ protected:
     bool m_isVersionOptionOn {};
     bool m_isOnlyShortOptionOn {};
     bool m_isOnlyLongOptionOn {};
+    std::string m_jobs {};
 };
 
 TEST_F(CommandlineProcessorTest, TestSingleShortOptions)
@@ -200,4 +205,32 @@ TEST_F(CommandlineProcessorTest, TestUnknownOptions)
     ASSERT_THROW_MSG(SetCommandLine({ "--abc", "-h" }), std::runtime_error, "unknown option: --abc");
     ASSERT_THROW_MSG(SetCommandLine({ "--abc", "--help" }), std::runtime_error, "unknown option: --abc");
     ASSERT_THROW_MSG(SetCommandLine({ "--help", "--abc" }), std::runtime_error, "unknown option: --abc");
+}
+
+TEST_F(CommandlineProcessorTest, TestValueOptions)
+{
+    SetCommandLine({ "-j", "4", "a" });
+    ASSERT_EQ(m_jobs, "4");
+    ASSERT_EQ(m_commandlineProcessor.GetArgs().size(), 1);
+    ASSERT_EQ(m_commandlineProcessor.GetArgs()[0], "a");
+
+    SetCommandLine({ "-hj8", "a" });
+    ASSERT_TRUE(m_isHelpOptionOn);
+    ASSERT_EQ(m_jobs, "8");
+    ASSERT_EQ(m_commandlineProcessor.GetArgs().size(), 1);
+
+    SetCommandLine({ "--jobs", "2" });
+    ASSERT_EQ(m_jobs, "2");
+    ASSERT_TRUE(m_commandlineProcessor.GetArgs().empty());
+
+    SetCommandLine({ "--jobs=16", "-v" });
+    ASSERT_EQ(m_jobs, "16");
+    ASSERT_TRUE(m_isVersionOptionOn);
+}
+
+TEST_F(CommandlineProcessorTest, TestInvalidValues)
+{
+    ASSERT_THROW_MSG(SetCommandLine({ "-j" }), std::runtime_error, "missing value for option: -j");
+    ASSERT_THROW_MSG(SetCommandLine({ "--jobs" }), std::runtime_error, "missing value for option: --jobs");
+    ASSERT_THROW_MSG(SetCommandLine({ "--help=1" }), std::runtime_error, "unexpected value for option: --help");
 }
\ No newline at end of file
@@ -35,13 +35,13 @@ protected:
         });
     }
 
-    void RunTest(std::string testId)
+    void RunTest(std::string testId, std::string options = "")
     {
         auto inputFile = s_testDataFolder / testId / (testId + ".scc");
         auto expectedOutputFile = s_testDataFolder / testId / (testId + ".result");
         auto outputFile = s_testDataFolder / testId / ".scc" / "a.output";
         std::filesystem::create_directories(outputFile.parent_path());
-        std::system(std::format("{} {} > {} 2>&1", s_sccExePath.c_str(), inputFile.c_str(), outputFile.c_str()).c_str());
+        std::system(std::format("{} {} {} > {} 2>&1", s_sccExePath.c_str(), options, inputFile.c_str(), outputFile.c_str()).c_str());
 
         auto actual = ReadFileAsString(outputFile);
         auto expected = ReadFileAsString(expectedOutputFile);
@@ -58,6 +58,11 @@ TEST_F(MainTest, HelloWorld)
     RunTest("hello_world");
 }
 
+TEST_F(MainTest, DeepTailRecursion)
+{
+    RunTest("deep_tail_recursion");
+}
+
 TEST_F(MainTest, FahrenheitCelsiusTable)
 {
     RunTest("fahrenheit_celsius_table");
@@ -66,4 +71,89 @@ TEST_F(MainTest, FahrenheitCelsiusTable)
 TEST_F(MainTest, FibonacciSequence)
 {
     RunTest("fibonacci_sequence");
+}
+
+TEST_F(MainTest, MemoizedFibonacci)
+{
+    RunTest("memoized_fibonacci");
+}
+
+TEST_F(MainTest, SizedTypes)
+{
+    RunTest("sized_types");
+}
+
+TEST_F(MainTest, PrecomputedFibonacciSequence)
+{
+    RunTest("fibonacci_sequence", "--precompute");
+}
+
+TEST_F(MainTest, ParallelFibonacci)
+{
+    RunTest("parallel_fibonacci", "--fork-join");
+}
+
+TEST_F(MainTest, Arrays)
+{
+    RunTest("arrays");
+}
+
+TEST_F(MainTest, Structs)
+{
+    RunTest("structs");
+}
+
+TEST_F(MainTest, Generics)
+{
+    RunTest("generics");
+}
+
+TEST_F(MainTest, Constants)
+{
+    RunTest("constants");
+}
+
+TEST_F(MainTest, ParallelFor)
+{
+    RunTest("parallel_for");
+}
+
+TEST_F(MainTest, SpawnFibonacci)
+{
+    RunTest("spawn_fibonacci");
+}
+
+TEST_F(MainTest, ParameterModes)
+{
+    RunTest("parameter_modes");
+}
+
+TEST_F(MainTest, SwitchDispatch)
+{
+    RunTest("switch_dispatch");
+}
+
+TEST_F(MainTest, EmbeddedData)
+{
+    RunTest("embedded_data");
+}
+
+TEST_F(MainTest, SimdKernels)
+{
+    RunTest("simd_kernels");
+}
+
+TEST_F(MainTest, SaveTemps)
+{
+    auto translatedFile = s_testDataFolder / "hello_world" / ".scc" / "hello_world.scc.cpp";
+    std::filesystem::remove(translatedFile);
+    RunTest("hello_world", "--save-temps");
+    ASSERT_TRUE(std::filesystem::exists(translatedFile));
+}
+
+// The units are read by concurrent clang++ processes through pipes.
+TEST_F(MainTest, SplitUnits)
+{
+    RunTest("switch_dispatch", "-j 3");
+    RunTest("embedded_data", "-j 2");
 }
\ No newline at end of file
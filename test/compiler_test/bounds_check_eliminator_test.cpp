@@ -0,0 +1,104 @@
+#include "test/test.h"
+
+#include <sstream>
+#include <vector>
+
+import scc.ast;
+import scc.compiler;
+
+using namespace scc::ast;
+using namespace scc::compiler;
+
+class BoundsCheckEliminatorTest : public testing::Test {
+protected:
+    Scope Eliminate(std::string content)
+    {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(std::move(content)) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        TypeChecker {}.CheckCompileUnit(scope);
+        BoundsCheckEliminator {}.EliminateCompileUnit(scope);
+        return std::move(scope);
+    }
+
+    // Returns whether each index expression of the global statements is checked, in source order.
+    static std::vector<bool> GetChecks(const Scope& scope)
+    {
+        struct Collector final : RecursiveVisitor {
+            std::vector<bool> checks {};
+
+            void VisitAstIndexExpression(const IndexExpression& indexExpression) override
+            {
+                checks.push_back(indexExpression.checked);
+                RecursiveVisitor::VisitAstIndexExpression(indexExpression);
+            }
+        };
+
+        auto collector = Collector {};
+        collector.VisitAstScope(scope);
+        return collector.checks;
+    }
+};
+
+TEST_F(BoundsCheckEliminatorTest, CanonicalLoop)
+{
+    auto scope = Eliminate(R"(
+i64[] a = [1, 2, 3];
+i64[4] b;
+i64 sum = 0;
+for (int i = 0; i < std::len(a); i += 1) {
+    sum += a[i] + b[i];
+}
+for (i64 i = 1; i < 4; i = i + 1) {
+    b[i] = b[i - 1] + a[i];
+}
+)");
+    ASSERT_EQ(GetChecks(scope), (std::vector<bool> { false, true, false, true, true }));
+}
+
+TEST_F(BoundsCheckEliminatorTest, NestedLoop)
+{
+    auto scope = Eliminate(R"(
+i64[3][] m = [[1, 2, 3], [4, 5, 6]];
+i64 sum = 0;
+for (int i = 0; i < std::len(m); i += 1) {
+    i64[:] row = m[i];
+    for (int j = 0; j < std::len(row); j += 1) {
+        sum += row[j] * m[i][j];
+    }
+}
+)");
+    ASSERT_EQ(GetChecks(scope), (std::vector<bool> { false, false, true, false }));
+}
+
+TEST_F(BoundsCheckEliminatorTest, KeepsChecks)
+{
+    auto scope = Eliminate(R"(
+i64[] a = [1, 2, 3];
+i64[2] b;
+for (int i = 0; i < std::len(a); i += 2) {
+    a[i] = 0;
+}
+for (int i = 0; i < std::len(a); i += 1) {
+    i = i + a[i];
+}
+for (int i = 0; i < std::len(a); i += 1) {
+    std::push(a, a[i]);
+}
+for (i8 i = 0; i < std::len(a); i += 1) {
+    a[i] = 0;
+}
+for (int i = 0; i < 3; i += 1) {
+    b[i] = 0;
+}
+for (int i = 0; i <= std::len(a); i += 1) {
+    a[i] = 0;
+}
+void skip(ref int n) { n += 1; }
+for (int i = 0; i < std::len(a); i += 1) {
+    skip(i);
+    a[i] = 0;
+}
+)");
+    ASSERT_EQ(GetChecks(scope), (std::vector<bool> { true, true, true, true, true, true, true }));
+}
\ No newline at end of file
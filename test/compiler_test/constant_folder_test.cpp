@@ -0,0 +1,66 @@
+#include "test/test.h"
+
+#include <filesystem>
+#include <sstream>
+
+import scc.ast;
+import scc.compiler;
+
+using namespace scc::ast;
+using namespace scc::compiler;
+
+class ConstantFolderTest : public testing::Test {
+protected:
+    static std::filesystem::path s_testFolder;
+
+    std::string FoldAndTranslate(const std::filesystem::path& path)
+    {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(ReadFileAsString(path)) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        ConstantFolder {}.FoldCompileUnit(scope);
+
+        auto output = std::make_shared<std::ostringstream>();
+        Translator { output }.VisitAstScope(scope);
+        return output->str();
+    }
+
+    void RunTest(std::string testFileId)
+    {
+        auto actual = FoldAndTranslate(s_testFolder / (testFileId + ".scc"));
+        auto expected = ReadFileAsString(s_testFolder / (testFileId + ".expected"));
+        ASSERT_EQ(actual, expected);
+    }
+};
+
+std::filesystem::path ConstantFolderTest::s_testFolder { []() {
+    char result[PATH_MAX];
+    auto count = readlink("/proc/self/exe", result, PATH_MAX);
+    result[count] = '\0';
+    for (auto path = std::filesystem::path { result }; !path.empty() && path != path.parent_path(); path = path.parent_path()) {
+        if (auto samplePath = path / "test" / "compiler_test" / "constant_folder_test_data"; std::filesystem::exists(samplePath)) {
+            return samplePath;
+        }
+    }
+    throw std::runtime_error { "Can't find 'test/compiler_test/constant_folder_test_data' directory." };
+}() };
+
+TEST_F(ConstantFolderTest, Arithmetic)
+{
+    RunTest("arithmetic");
+}
+
+TEST_F(ConstantFolderTest, Propagation)
+{
+    RunTest("propagation");
+}
+
+TEST_F(ConstantFolderTest, Conditional)
+{
+    RunTest("conditional");
+}
+
+TEST_F(ConstantFolderTest, Brackets)
+{
+    RunTest("brackets");
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "test/test.h"
+
+#include <memory>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+import scc.ast;
+import scc.compiler;
+
+using namespace scc::ast;
+using namespace scc::compiler;
+
+class DeadFunctionEliminatorTest : public testing::Test {
+protected:
+    Scope Eliminate(std::string content)
+    {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(std::move(content)) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        DeadFunctionEliminator {}.EliminateCompileUnit(scope);
+        return std::move(scope);
+    }
+};
+
+TEST_F(DeadFunctionEliminatorTest, ReachableFromGlobalStatements)
+{
+    auto scope = Eliminate(R"(
+std::println("{}", square(3));
+
+int square(int x) {
+    return multiply(x, x);
+}
+
+int multiply(int x, int y) {
+    return x * y;
+}
+
+int unused(int x) {
+    return square(x) + 1;
+}
+)");
+    ASSERT_NE(scope.QueryFunction("square"), nullptr);
+    ASSERT_NE(scope.QueryFunction("multiply"), nullptr);
+    ASSERT_EQ(scope.QueryFunction("unused"), nullptr);
+    ASSERT_EQ(scope.GetFunctions().size(), 2);
+}
+
+TEST_F(DeadFunctionEliminatorTest, ReachableFromMain)
+{
+    auto scope = Eliminate(R"(
+int fib(int n) {
+    if (n < 2) {
+        return n;
+    }
+    return fib(n - 1) + fib(n - 2);
+}
+
+int helper() {
+    return 1;
+}
+
+int main() {
+    std::println("{}", fib(10));
+    return 0;
+}
+)");
+    ASSERT_NE(scope.QueryFunction("main"), nullptr);
+    ASSERT_NE(scope.QueryFunction("fib"), nullptr);
+    ASSERT_EQ(scope.QueryFunction("helper"), nullptr);
+}
+
+TEST_F(DeadFunctionEliminatorTest, ReachableFromMainAndGlobalStatements)
+{
+    Scope scope {};
+    Lexer lexer { std::make_shared<std::istringstream>(R"(
+int main() {
+    return 0;
+}
+
+int helper() {
+    return 1;
+}
+
+int unused() {
+    return 2;
+}
+)") };
+    Parser {}.ParseCompileUnit(scope, lexer);
+
+    // The parser rejects global statements next to 'main', the passes may still add them.
+    auto sourceRange = SourceRange { 1, 1 };
+    auto call = std::make_unique<FunctionCallExpression>(sourceRange, std::make_unique<IdentifierExpression>(sourceRange, "helper"), std::vector<std::unique_ptr<Expression>> {});
+    scope.statements.push_back(std::make_unique<ExpressionStatement>(sourceRange, std::move(call)));
+
+    DeadFunctionEliminator {}.EliminateCompileUnit(scope);
+    ASSERT_NE(scope.QueryFunction("main"), nullptr);
+    ASSERT_NE(scope.QueryFunction("helper"), nullptr);
+    ASSERT_EQ(scope.QueryFunction("unused"), nullptr);
+}
+
+TEST_F(DeadFunctionEliminatorTest, CallGraph)
+{
+    Scope scope {};
+    Lexer lexer { std::make_shared<std::istringstream>(R"(
+int a() {
+    return b() + std::abs(c());
+}
+
+int b() {
+    return 1;
+}
+
+int c() {
+    return a();
+}
+)") };
+    Parser {}.ParseCompileUnit(scope, lexer);
+
+    auto callGraph = CallGraph { scope };
+    ASSERT_EQ(callGraph.GetCallees("a"), (std::unordered_set<std::string> { "b", "c" }));
+    ASSERT_TRUE(callGraph.GetCallees("b").empty());
+    ASSERT_EQ(callGraph.GetCallees("c"), (std::unordered_set<std::string> { "a" }));
+    ASSERT_TRUE(callGraph.GetReachableFunctions().empty());
+}
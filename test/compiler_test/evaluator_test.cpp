@@ -0,0 +1,97 @@
+#include "test/test.h"
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+import scc.ast;
+import scc.compiler;
+import scc.ir;
+
+using namespace scc::ast;
+using namespace scc::compiler;
+
+class EvaluatorTest : public testing::Test {
+protected:
+    ProgramOutput Evaluate(std::string content, uint64_t maxSteps = Evaluator::s_defaultMaxSteps)
+    {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(std::move(content)) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        auto program = IrLowering {}.LowerCompileUnit(scope);
+        return Evaluator { maxSteps }.EvaluateProgram(*program);
+    }
+};
+
+TEST_F(EvaluatorTest, LoopsAndCalls)
+{
+    auto output = Evaluate(R"(
+int N = 10;
+
+std::print("The first {} fibonacci sequence: ", N);
+for (int i = 0; i < N; i += 1) {
+    if (i != 0) {
+        std::print(", ");
+    }
+    std::print("{}", fib(i));
+}
+std::println();
+
+int fib(int n) {
+    if (n < 2) {
+        return n;
+    }
+    return fib(n - 1) + fib(n - 2);
+}
+)");
+    ASSERT_EQ(output.text, "The first 10 fibonacci sequence: 0, 1, 1, 2, 3, 5, 8, 13, 21, 34\n");
+    ASSERT_EQ(output.exitCode, 0);
+}
+
+TEST_F(EvaluatorTest, FormatSpecs)
+{
+    auto output = Evaluate(R"(
+std::println("{1}-{0:>4}|{{}}|{1:x}", 7, 42);
+)");
+    ASSERT_EQ(output.text, "42-   7|{}|2a\n");
+}
+
+TEST_F(EvaluatorTest, ExitCode)
+{
+    auto output = Evaluate(R"(
+int main() {
+    std::println("failed");
+    return 3;
+}
+)");
+    ASSERT_EQ(output.text, "failed\n");
+    ASSERT_EQ(output.exitCode, 3);
+}
+
+TEST_F(EvaluatorTest, RejectUnprovablePrograms)
+{
+    ASSERT_THROW(Evaluate("int x = 0; std::println(\"{}\", 1 / x);"), std::runtime_error);
+    ASSERT_THROW(Evaluate("int x = 2147483647; x += 1;"), std::runtime_error);
+    ASSERT_THROW(Evaluate("srand(1);"), std::runtime_error);
+    ASSERT_THROW(Evaluate("std::println(\"{} {}\", 1);"), std::runtime_error);
+    ASSERT_THROW(Evaluate("for (;;) {}", 1000), std::runtime_error);
+}
+
+TEST_F(EvaluatorTest, TranslateOutput)
+{
+    auto output = std::make_shared<std::ostringstream>();
+    OutputTranslator { output }.TranslateOutput({ "a \"quoted\" \\ line\n\tindented\n", 0 });
+    ASSERT_EQ(output->str(), R"(// scc autogenerated file.
+
+import scc.std.println;
+
+int main()
+{
+    scc::std::write({
+        "a \"quoted\" \\ line\n"
+        "\tindented\n", 28 });
+    return 0;
+}
+)");
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "test/test.h"
+
+#include <sstream>
+
+import scc.ast;
+import scc.compiler;
+
+using namespace scc::ast;
+using namespace scc::compiler;
+
+class ForkJoinParallelizerTest : public testing::Test {
+protected:
+    Scope Parallelize(std::string content)
+    {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(std::move(content)) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        ForkJoinParallelizer {}.ParallelizeCompileUnit(scope);
+        return std::move(scope);
+    }
+
+    static bool IsParallelized(const Scope& scope, const std::string& name)
+    {
+        return static_cast<const FunctionDefinitionStatement*>(scope.QueryFunction(name))->HasAttribute("fork_join");
+    }
+};
+
+TEST_F(ForkJoinParallelizerTest, RecursiveFunctionsWithoutSideEffects)
+{
+    auto scope = Parallelize(R"(
+int fib(int n) {
+    if (n < 2) {
+        return n;
+    }
+    return fib(n - 1) + fib(n - 2);
+}
+
+int square(int x) {
+    return x * x;
+}
+
+int count(int n) {
+    if (n == 0) {
+        return 0;
+    }
+    std::println("{}", n);
+    return count(n - 1) + count(n - 1);
+}
+)");
+    ASSERT_TRUE(IsParallelized(scope, "fib"));
+    ASSERT_FALSE(IsParallelized(scope, "square"));
+    ASSERT_FALSE(IsParallelized(scope, "count"));
+}
+
+TEST_F(ForkJoinParallelizerTest, SkipMemoizedCompileUnit)
+{
+    auto scope = Parallelize(R"(
+int fib(int n) {
+    if (n < 2) {
+        return n;
+    }
+    return fib(n - 1) + fib(n - 2);
+}
+
+@memo
+int tribonacci(int n) {
+    if (n < 3) {
+        return n;
+    }
+    return tribonacci(n - 1) + tribonacci(n - 2) + tribonacci(n - 3);
+}
+)");
+    ASSERT_FALSE(IsParallelized(scope, "fib"));
+    ASSERT_FALSE(IsParallelized(scope, "tribonacci"));
+}
+
+TEST_F(ForkJoinParallelizerTest, Translate)
+{
+    auto scope = Parallelize(R"(
+int fib(int n) {
+    if (n < 2) {
+        return n;
+    }
+    return fib(n - 1) + fib(n - 2);
+}
+
+std::println("{}", fib(30));
+)");
+    auto output = std::make_shared<std::ostringstream>();
+    Translator { output }.VisitAstScope(scope);
+    ASSERT_EQ(output->str(), R"(// scc autogenerated file.
+
+import scc.std.fork_join;
+import scc.std.print_parts;
+
+// function declarations
+[[gnu::const]] int fib(int n);
+int main();
+
+// function definitions
+int fib(int n)
+{
+    if (n < 2)
+    {
+        return n;
+    }
+    return scc::std::fork_join([&] { return fib(n - 1); }, [&] { return fib(n - 2); }, [](auto scc_left, auto scc_right) { return scc_left + scc_right; });
+}
+
+int main()
+{
+    scc::std::print_parts(fib(30), "\n");
+    return 0;
+}
+)");
+}
\ No newline at end of file
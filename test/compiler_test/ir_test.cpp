@@ -0,0 +1,223 @@
+#include "test/test.h"
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+import scc.ast;
+import scc.compiler;
+import scc.ir;
+
+using namespace scc::ast;
+using namespace scc::compiler;
+using namespace scc::ir;
+
+class IrTest : public testing::Test {
+protected:
+    std::unique_ptr<Program> Lower(std::string content)
+    {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(std::move(content)) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        return IrLowering {}.LowerCompileUnit(scope);
+    }
+
+    static Function& GetFunction(Program& program, const std::string& name)
+    {
+        for (const auto& function : program.functions) {
+            if (function->name == name) {
+                return *function;
+            }
+        }
+        throw std::runtime_error { "function not found" };
+    }
+
+    static int CountInstructions(const Function& function, Opcode opcode, bool excludeEntryBlock = false)
+    {
+        auto count = 0;
+        for (const auto& block : function.blocks) {
+            if (excludeEntryBlock && block.get() == function.GetEntryBlock()) {
+                continue;
+            }
+            for (const auto& instruction : block->instructions) {
+                count += instruction->opcode == opcode;
+            }
+        }
+        return count;
+    }
+};
+
+TEST_F(IrTest, LowerForLoop)
+{
+    auto program = Lower(R"(
+int sum(int n) {
+    int s = 0;
+    for (int i = 0; i < n; i += 1) {
+        s += i;
+    }
+    return s;
+}
+)");
+    auto& function = GetFunction(*program, "sum");
+    ASSERT_EQ(function.blocks.size(), 5);
+    ASSERT_EQ(CountInstructions(function, Opcode::Phi), 2);
+    ASSERT_EQ(function.blocks[1]->predecessors.size(), 2);
+}
+
+TEST_F(IrTest, LowerSwitch)
+{
+    auto program = Lower(R"(
+int f(int x) {
+    int r = 0;
+    switch (x) {
+        case 1, 2 { r = 10; }
+        case 3 { r = 20; }
+        default { r = 30; }
+    }
+    return r;
+}
+)");
+    auto& function = GetFunction(*program, "f");
+    ASSERT_EQ(CountInstructions(function, Opcode::Equal), 3);
+    ASSERT_EQ(CountInstructions(function, Opcode::CondBranch), 3);
+}
+
+TEST_F(IrTest, CommonSubexpressionElimination)
+{
+    auto program = Lower(R"(
+int f(int a, int b) {
+    return a * b + b * a;
+}
+)");
+    auto& function = GetFunction(*program, "f");
+    ASSERT_EQ(CountInstructions(function, Opcode::Mul), 2);
+
+    CommonSubexpressionElimination {}.Run(function);
+    DeadCodeElimination {}.Run(function);
+    ASSERT_EQ(CountInstructions(function, Opcode::Mul), 1);
+}
+
+TEST_F(IrTest, LoopInvariantCodeMotion)
+{
+    auto program = Lower(R"(
+int f(int n, int k) {
+    int s = 0;
+    for (int i = 0; i < n; i += 1) {
+        s += k * k;
+    }
+    return s;
+}
+)");
+    auto& function = GetFunction(*program, "f");
+    ASSERT_EQ(CountInstructions(function, Opcode::Mul, /*excludeEntryBlock=*/true), 1);
+
+    LoopInvariantCodeMotion {}.Run(function);
+    ASSERT_EQ(CountInstructions(function, Opcode::Mul, /*excludeEntryBlock=*/true), 0);
+    ASSERT_EQ(CountInstructions(function, Opcode::Mul), 1);
+}
+
+TEST_F(IrTest, StrengthReduction)
+{
+    auto program = Lower(R"(
+int f(int n) {
+    int s = 0;
+    for (int i = 0; i < n; i += 1) {
+        s += i * 4;
+    }
+    return s;
+}
+)");
+    auto& function = GetFunction(*program, "f");
+    ASSERT_EQ(CountInstructions(function, Opcode::Mul, /*excludeEntryBlock=*/true), 1);
+
+    StrengthReduction {}.Run(function);
+    ASSERT_EQ(CountInstructions(function, Opcode::Mul, /*excludeEntryBlock=*/true), 0);
+    ASSERT_EQ(CountInstructions(function, Opcode::Phi), 3);
+}
+
+TEST_F(IrTest, DeadCodeElimination)
+{
+    auto program = Lower(R"(
+int f(int a) {
+    int unused = a * 3;
+    return a + 1;
+}
+)");
+    auto& function = GetFunction(*program, "f");
+    ASSERT_EQ(CountInstructions(function, Opcode::Mul), 1);
+
+    DeadCodeElimination {}.Run(function);
+    ASSERT_EQ(CountInstructions(function, Opcode::Mul), 0);
+    ASSERT_EQ(CountInstructions(function, Opcode::Add), 1);
+}
+
+TEST_F(IrTest, UnsupportedConstruct)
+{
+    ASSERT_THROW(Lower(R"(
+int g = 1;
+
+int f() {
+    return g;
+}
+)"),
+        Exception);
+}
+
+TEST_F(IrTest, TranslateProgram)
+{
+    auto program = Lower(R"(
+std::println("{}", 42);
+)");
+    auto out = std::make_shared<std::ostringstream>();
+    IrTranslator { out }.TranslateProgram(*program);
+    ASSERT_EQ(out->str(), R"(// scc autogenerated file.
+
+import scc.std.print_parts;
+
+int main()
+{
+    _bb0:
+        scc::std::print_parts(42, "\n");
+        return 0;
+}
+)");
+}
+
+TEST_F(IrTest, TranslateNestedField)
+{
+    auto program = Lower(R"(
+std::println("{:{}}", 42, 6);
+)");
+    auto out = std::make_shared<std::ostringstream>();
+    IrTranslator { out }.TranslateProgram(*program);
+    ASSERT_EQ(out->str(), R"(// scc autogenerated file.
+
+import scc.std.println;
+
+int main()
+{
+    _bb0:
+        scc::std::println("{:{}}", 42, 6);
+        return 0;
+}
+)");
+}
+
+TEST_F(IrTest, TranslateMinimumConstant)
+{
+    auto program = Lower(R"(
+int f(int x) {
+    switch (x) {
+        case -2147483648 { return 1; }
+        case -5 { return 2; }
+    }
+    return 0;
+}
+)");
+    auto out = std::make_shared<std::ostringstream>();
+    IrTranslator { out }.TranslateProgram(*program);
+    ASSERT_NE(out->str().find("(-2147483647 - 1)"), std::string::npos);
+    ASSERT_NE(out->str().find("(-5)"), std::string::npos);
+    ASSERT_EQ(out->str().find("-2147483648"), std::string::npos);
+}
\ No newline at end of file
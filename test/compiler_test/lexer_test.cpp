@@ -493,6 +493,29 @@ TEST_F(LexerTest, ParsePunctuationChar)
     ASSERT_EQ(token.sourceRange.endColumn, 12);
 }
 
+TEST_F(LexerTest, ParseStructMember)
+{
+    auto lexer = CreateLexer("struct p.x");
+    auto token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_STRUCT);
+    ASSERT_EQ(token.sourceRange.startColumn, 1);
+    ASSERT_EQ(token.sourceRange.endColumn, 6);
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_IDENTIFIER);
+    ASSERT_EQ(token.string(), "p");
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, '.');
+    ASSERT_EQ(token.sourceRange.startColumn, 9);
+    ASSERT_EQ(token.sourceRange.endColumn, 9);
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_IDENTIFIER);
+    ASSERT_EQ(token.string(), "x");
+    ASSERT_EQ(lexer.GetToken().type, TOKEN_EOF);
+}
+
 TEST_F(LexerTest, ParseRelationOperator)
 {
     auto lexer = CreateLexer("<><=>=");
@@ -690,10 +713,10 @@ TEST_F(LexerTest, ParseAssignmentOperator)
 
 TEST_F(LexerTest, UnexpectedInput)
 {
-    ASSERT_THROW_COMPILER_EXCEPTION(CreateLexer("@").GetToken(), (Exception { 1, 1, "unexpected input" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(CreateLexer("$").GetToken(), (Exception { 1, 1, "unexpected input" }));
 
     auto lexer = CreateLexer(R"( abc
-  @)");
+  $)");
     auto token = lexer.GetToken();
     ASSERT_EQ(token.type, TOKEN_IDENTIFIER);
     ASSERT_EQ(token.sourceRange.startLine, 1);
@@ -783,6 +806,33 @@ TEST_F(LexerTest, ParseInteger)
     // TODO: need more tests.
 }
 
+TEST_F(LexerTest, ParseFloat)
+{
+    auto lexer = CreateLexer("1.5");
+    auto token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_FLOAT);
+    ASSERT_EQ(token.string(), "1.5");
+
+    lexer = CreateLexer("2e3");
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_FLOAT);
+    ASSERT_EQ(token.string(), "2e3");
+
+    lexer = CreateLexer("1.25E-2f");
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_FLOAT);
+    ASSERT_EQ(token.string(), "1.25E-2f");
+    ASSERT_EQ(token.sourceRange.endColumn, 8);
+
+    lexer = CreateLexer("12");
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_INTEGER);
+    ASSERT_EQ(token.integer(), 12);
+
+    lexer = CreateLexer("1e");
+    ASSERT_THROW_COMPILER_EXCEPTION(lexer.GetToken(), (Exception { 1, 3, "exponent has no digits" }));
+}
+
 TEST_F(LexerTest, ParseOctalEscapeSequence)
 {
     auto lexer = CreateLexer(R"("\1")");
@@ -970,4 +1020,115 @@ TEST_F(LexerTest, ParseHexEscapeSequence)
     ASSERT_EQ(token.sourceRange.endLine, 1);
     ASSERT_EQ(token.sourceRange.endColumn, 8);
     ASSERT_EQ(token.string(), "\xb2R3");
+}
+
+TEST_F(LexerTest, ParseConstKeywords)
+{
+    auto lexer = CreateLexer("const constexpr consteval constant");
+    auto token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_CONST);
+    ASSERT_EQ(token.sourceRange.startColumn, 1);
+    ASSERT_EQ(token.sourceRange.endColumn, 5);
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_CONSTEXPR);
+    ASSERT_EQ(token.sourceRange.startColumn, 7);
+    ASSERT_EQ(token.sourceRange.endColumn, 15);
+
+    ASSERT_EQ(lexer.GetToken().type, TOKEN_CONSTEVAL);
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_IDENTIFIER);
+    ASSERT_EQ(token.string(), "constant");
+    ASSERT_EQ(lexer.GetToken().type, TOKEN_EOF);
+}
+
+TEST_F(LexerTest, ParseParallelKeyword)
+{
+    auto lexer = CreateLexer("parallel for parallels");
+    auto token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_PARALLEL);
+    ASSERT_EQ(token.sourceRange.startColumn, 1);
+    ASSERT_EQ(token.sourceRange.endColumn, 8);
+
+    ASSERT_EQ(lexer.GetToken().type, TOKEN_FOR);
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_IDENTIFIER);
+    ASSERT_EQ(token.string(), "parallels");
+    ASSERT_EQ(lexer.GetToken().type, TOKEN_EOF);
+}
+
+TEST_F(LexerTest, ParseSpawnAndAwaitKeywords)
+{
+    auto lexer = CreateLexer("spawn await awaits");
+    auto token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_SPAWN);
+    ASSERT_EQ(token.sourceRange.startColumn, 1);
+    ASSERT_EQ(token.sourceRange.endColumn, 5);
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_AWAIT);
+    ASSERT_EQ(token.sourceRange.startColumn, 7);
+    ASSERT_EQ(token.sourceRange.endColumn, 11);
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_IDENTIFIER);
+    ASSERT_EQ(token.string(), "awaits");
+    ASSERT_EQ(lexer.GetToken().type, TOKEN_EOF);
+}
+
+TEST_F(LexerTest, ParseSwitchKeywords)
+{
+    auto lexer = CreateLexer("switch case default cases");
+    auto token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_SWITCH);
+    ASSERT_EQ(token.sourceRange.startColumn, 1);
+    ASSERT_EQ(token.sourceRange.endColumn, 6);
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_CASE);
+    ASSERT_EQ(token.sourceRange.startColumn, 8);
+    ASSERT_EQ(token.sourceRange.endColumn, 11);
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_DEFAULT);
+    ASSERT_EQ(token.sourceRange.startColumn, 13);
+    ASSERT_EQ(token.sourceRange.endColumn, 19);
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_IDENTIFIER);
+    ASSERT_EQ(token.string(), "cases");
+    ASSERT_EQ(lexer.GetToken().type, TOKEN_EOF);
+}
+
+TEST_F(LexerTest, ParseEmbedKeywordAndBytes)
+{
+    auto lexer = CreateLexer("embed x\"0a 0B\n ff\" x");
+    auto token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_EMBED);
+    ASSERT_EQ(token.sourceRange.startColumn, 1);
+    ASSERT_EQ(token.sourceRange.endColumn, 5);
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_BYTES);
+    ASSERT_EQ(token.sourceRange.startLine, 1);
+    ASSERT_EQ(token.sourceRange.startColumn, 7);
+    ASSERT_EQ(token.sourceRange.endLine, 2);
+    ASSERT_EQ(token.sourceRange.endColumn, 4);
+    ASSERT_EQ(token.string(), "\x0a\x0b\xff");
+
+    token = lexer.GetToken();
+    ASSERT_EQ(token.type, TOKEN_IDENTIFIER);
+    ASSERT_EQ(token.string(), "x");
+    ASSERT_EQ(lexer.GetToken().type, TOKEN_EOF);
+
+    lexer = CreateLexer("x\"0g\"");
+    ASSERT_THROW_COMPILER_EXCEPTION(lexer.GetToken(), (Exception { 1, 4, "invalid hex digit 'g' in byte string" }));
+
+    lexer = CreateLexer("x\"abc\"");
+    ASSERT_THROW_COMPILER_EXCEPTION(lexer.GetToken(), (Exception { 1, 6, "byte string has an odd number of hex digits" }));
+
+    lexer = CreateLexer("x\"ab");
+    ASSERT_THROW_COMPILER_EXCEPTION(lexer.GetToken(), (Exception { 1, 5, "missing terminating '\"' character" }));
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "test/test.h"
+#include <cstdint>
+#include <limits>
 #include <memory>
 
 import scc.ast;
@@ -467,6 +469,20 @@ TEST_F(ParserTest, ParseArithmeticExpression4)
     ASSERT_EQ(rightLeafExpression->fullName, "c");
 }
 
+TEST_F(ParserTest, ParseUnaryMinusExpression)
+{
+    auto parse = [this](std::string content) {
+        return std::unique_ptr<BinaryExpression> { dynamic_cast<BinaryExpression*>(ParseExpression(std::move(content)).release()) };
+    };
+
+    auto binaryExpression = parse("a - -2");
+    ASSERT_EQ(binaryExpression->op, BinaryOp::Sub);
+
+    auto rightUnaryExpression = dynamic_cast<UnaryExpression*>(binaryExpression->rightOprand.get());
+    ASSERT_EQ(rightUnaryExpression->op, UnaryOp::Minus);
+    ASSERT_EQ(dynamic_cast<IntegerLiteralExpression*>(rightUnaryExpression->oprand.get())->value, 2);
+}
+
 TEST_F(ParserTest, ParseForLoopStatement)
 {
     auto scope = ParseStatement("for (;;) {}");
@@ -592,3 +608,293 @@ void main() {
     Lexer lexer { std::make_shared<std::istringstream>(std::move(content)) };
     ASSERT_THROW_COMPILER_EXCEPTION(Parser {}.ParseCompileUnit(scope, lexer), (Exception { 1, 1, 11, "unexpected global statement when 'main' function is defined (4:1)" }));
 }
+
+TEST_F(ParserTest, ParseStructDeclaration)
+{
+    auto scope = Parse(R"(struct Point {
+    f64 x;
+    f64 y;
+}
+
+struct Particle {
+    Point position;
+    i32[4] tags;
+}
+
+@soa Particle[] particles;
+particles[0].position.x = 1;)");
+
+    auto point = scope.QueryTypeInfo("Point");
+    ASSERT_NE(point, nullptr);
+    ASSERT_EQ(point->kind, TypeKind::Struct);
+    ASSERT_EQ(point->fields.size(), 2);
+    ASSERT_EQ(point->fields[0].name, "x");
+    ASSERT_EQ(point->fields[1].name, "y");
+    ASSERT_EQ(point->fields[1].typeInfo, scope.QueryTypeInfo("f64"));
+
+    auto particle = scope.QueryTypeInfo("Particle");
+    ASSERT_NE(particle, nullptr);
+    ASSERT_EQ(particle->fields[0].typeInfo, point);
+    ASSERT_EQ(particle->fields[1].typeInfo->fullName, "i32[4]");
+    ASSERT_EQ(scope.GetStructTypes(), (std::vector<TypeInfo*> { point, particle }));
+
+    ASSERT_EQ(scope.variableDeclarations.size(), 1);
+    const auto& particles = scope.variableDeclarations[0]->typeInfo;
+    ASSERT_EQ(particles.fullName, "@soa Particle[]");
+    ASSERT_EQ(particles.kind, TypeKind::Vector);
+    ASSERT_TRUE(particles.isSoa);
+    ASSERT_EQ(particles.elementType, particle);
+
+    auto assignment = dynamic_cast<BinaryExpression*>(dynamic_cast<ExpressionStatement*>(scope.statements[1].get())->expression.get());
+    auto memberExpression = dynamic_cast<MemberExpression*>(assignment->leftOprand.get());
+    ASSERT_NE(memberExpression, nullptr);
+    ASSERT_EQ(memberExpression->memberName, "x");
+    memberExpression = dynamic_cast<MemberExpression*>(memberExpression->objectExpression.get());
+    ASSERT_NE(memberExpression, nullptr);
+    ASSERT_EQ(memberExpression->memberName, "position");
+    ASSERT_NE(dynamic_cast<IndexExpression*>(memberExpression->objectExpression.get()), nullptr);
+
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("struct Empty {}"), (Exception { 1, 8, 12, "struct 'Empty' must have at least one field" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("struct P { int x; int x; }"), (Exception { 1, 19, 23, "duplicate member 'x'" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("struct P { int x; } struct P { int y; }"), (Exception { 1, 28, 28, "redefinition of type 'P'" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("void f() { struct P { int x; } }"), (Exception { 1, 12, 17, "structs can only be declared in the global scope" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("@soa int[] a;"), (Exception { 1, 2, 4, "'@soa' can only be applied to arrays and vectors of structs" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("struct P { int x; } @memo P[] a;"), (Exception { 1, 27, 29, "attribute 'memo' can only be applied to function definitions" }));
+}
+
+TEST_F(ParserTest, ParseFunctionAttributes)
+{
+    auto scope = Parse(R"(@memo
+int fib(int n) {
+    return n;
+}
+
+int id(int n) {
+    return n;
+})");
+
+    auto fib = dynamic_cast<FunctionDefinitionStatement*>(scope.QueryFunction("fib"));
+    ASSERT_NE(fib, nullptr);
+    ASSERT_EQ(fib->attributes, std::vector<std::string> { "memo" });
+    ASSERT_TRUE(fib->HasAttribute("memo"));
+
+    auto id = dynamic_cast<FunctionDefinitionStatement*>(scope.QueryFunction("id"));
+    ASSERT_NE(id, nullptr);
+    ASSERT_TRUE(id->attributes.empty());
+
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("@inline int f() { return 0; }"), (Exception { 1, 2, 7, "unknown attribute 'inline'" }));
+}
+
+TEST_F(ParserTest, ParseGenericFunctionDeclaration)
+{
+    auto scope = Parse(R"(<T> T max(T a, T b) {
+    if (a < b) { return b; }
+    return a;
+}
+
+<T, U> void fill(T[:] values, @soa U[] points) {})");
+
+    ASSERT_EQ(scope.QueryFunction("max"), nullptr);
+    auto max = scope.QueryGenericFunction("max");
+    ASSERT_NE(max, nullptr);
+    ASSERT_EQ(max->name, "max");
+    ASSERT_EQ(max->typeParameters, std::vector<std::string> { "T" });
+    ASSERT_EQ(max->parameterTypes, (std::vector<std::string> { "T", "T" }));
+    ASSERT_EQ(max->source, " T max(T a, T b) {\n    if (a < b) { return b; }\n    return a;\n}");
+    ASSERT_EQ(max->sourceLine, 1);
+    ASSERT_EQ(max->sourceColumn, 4);
+
+    auto fill = scope.QueryGenericFunction("fill");
+    ASSERT_NE(fill, nullptr);
+    ASSERT_EQ(fill->typeParameters, (std::vector<std::string> { "T", "U" }));
+    ASSERT_EQ(fill->parameterTypes, (std::vector<std::string> { "T[:]", "@soa U[]" }));
+    ASSERT_EQ(fill->sourceLine, 6);
+    ASSERT_EQ(fill->sourceColumn, 7);
+
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("void f() { <T> T g(T a) { return a; } }"), (Exception { 1, 12, 12, "generic functions can only be declared in the global scope" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("<int> int f() { return 0; }"), (Exception { 1, 2, 4, "type parameter 'int' shadows a type" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("int f() { return 0; } <T> T f(T a) { return a; }"), (Exception { 1, 29, 29, "redefinition of 'f'" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("<T> T f(T a) { return a; } int f() { return 0; }"), (Exception { 1, 32, 32, "redefinition of 'f'" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("<T> T f(T a) { return a;"), (Exception { 1, 25, 25, "expected '}'" }));
+}
+
+TEST_F(ParserTest, ParseConstQualifiers)
+{
+    auto scope = Parse(R"(const int a = 1, b = 2;
+constexpr f64 c = 1.5;
+int d = 3;
+constexpr int square(int n) { return n * n; }
+consteval int cube(int n) { return n * n * n; }
+int id(int n) { return n; })");
+
+    ASSERT_EQ(scope.variableDeclarations.size(), 4);
+    ASSERT_EQ(scope.variableDeclarations[0]->constness, Constness::Const);
+    ASSERT_EQ(scope.variableDeclarations[1]->constness, Constness::Const);
+    ASSERT_EQ(scope.variableDeclarations[2]->constness, Constness::Constexpr);
+    ASSERT_EQ(scope.variableDeclarations[3]->constness, Constness::None);
+
+    ASSERT_EQ(static_cast<FunctionDefinitionStatement*>(scope.QueryFunction("square"))->constness, Constness::Constexpr);
+    ASSERT_EQ(static_cast<FunctionDefinitionStatement*>(scope.QueryFunction("cube"))->constness, Constness::Consteval);
+    ASSERT_EQ(static_cast<FunctionDefinitionStatement*>(scope.QueryFunction("id"))->constness, Constness::None);
+
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("const int f() { return 0; }"), (Exception { 1, 1, 5, "'const' can only be applied to variable declarations" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("consteval int x = 1;"), (Exception { 1, 1, 9, "'consteval' can only be applied to function definitions" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("constexpr int x;"), (Exception { 1, 11, 15, "constexpr variable 'x' must be initialized" }));
+}
+
+TEST_F(ParserTest, ParseParallelForLoopStatement)
+{
+    auto scope = Parse(R"(int total = 0;
+int best = 0;
+parallel for (int i = 0; i < 10; i += 1) sum(total) max(best) {
+    total += i;
+})");
+    ASSERT_EQ(scope.statements.size(), 3);
+
+    auto forStatement = dynamic_cast<ForLoopStatement*>(scope.statements[2].get());
+    ASSERT_NE(forStatement, nullptr);
+    ASSERT_TRUE(forStatement->isParallel);
+    ASSERT_EQ(forStatement->sourceRange.startColumn, 1);
+    ASSERT_EQ(forStatement->reductions.size(), 2);
+    ASSERT_EQ(forStatement->reductions[0].op, ReductionOp::Sum);
+    ASSERT_EQ(forStatement->reductions[0].variableName, "total");
+    ASSERT_EQ(forStatement->reductions[1].op, ReductionOp::Max);
+    ASSERT_EQ(forStatement->reductions[1].variableName, "best");
+    ASSERT_EQ(forStatement->bodyScope.statements.size(), 1);
+
+    scope = ParseStatement("parallel for (int i = 0; i < 10; i += 1) min(a, b) {}");
+    forStatement = dynamic_cast<ForLoopStatement*>(scope.statements[0].get());
+    ASSERT_EQ(forStatement->reductions.size(), 2);
+    ASSERT_EQ(forStatement->reductions[1].op, ReductionOp::Min);
+    ASSERT_EQ(forStatement->reductions[1].variableName, "b");
+
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("parallel for (int i = 0; i <= 10; i += 1) {}"), (Exception { 1, 1, 44, "parallel for loops must have the form 'parallel for (T i = begin; i < end; i += 1)', where 'T' is an integer type" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("parallel for (f64 x = 0; x < 1; x += 1) {}"), (Exception { 1, 1, 42, "parallel for loops must have the form 'parallel for (T i = begin; i < end; i += 1)', where 'T' is an integer type" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("parallel int i = 0;"), (Exception { 1, 10, 12, "expected 'for' after 'parallel'" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("parallel for (int i = 0; i < 10; i += 1) avg(x) {}"), (Exception { 1, 42, 44, "unknown reduction 'avg', expected 'sum', 'min' or 'max'" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("for (int i = 0; i < 10; i += 1) sum(x) {}"), (Exception { 1, 33, 35, "expected '{'" }));
+}
+
+TEST_F(ParserTest, ParseSpawnAndAwaitExpressions)
+{
+    auto scope = Parse(R"(int f(int n) { return n; }
+task<int> t = spawn f(1);
+int r = await t + 1;)");
+    ASSERT_EQ(scope.variableDeclarations.size(), 2);
+
+    const auto& task = *scope.variableDeclarations[0];
+    ASSERT_EQ(task.typeInfo.fullName, "task<int>");
+    ASSERT_EQ(task.typeInfo.kind, TypeKind::Task);
+    ASSERT_EQ(task.typeInfo.elementType->fullName, "int");
+    auto spawnExpression = dynamic_cast<SpawnExpression*>(task.initExpression.get());
+    ASSERT_NE(spawnExpression, nullptr);
+    ASSERT_EQ(spawnExpression->sourceRange.startColumn, 15);
+    ASSERT_EQ(spawnExpression->sourceRange.endColumn, 24);
+    ASSERT_NE(dynamic_cast<FunctionCallExpression*>(spawnExpression->callExpression.get()), nullptr);
+
+    auto binaryExpression = dynamic_cast<BinaryExpression*>(scope.variableDeclarations[1]->initExpression.get());
+    ASSERT_NE(binaryExpression, nullptr);
+    auto awaitExpression = dynamic_cast<AwaitExpression*>(binaryExpression->leftOprand.get());
+    ASSERT_NE(awaitExpression, nullptr);
+    ASSERT_EQ(static_cast<IdentifierExpression&>(*awaitExpression->oprand).fullName, "t");
+
+    scope = Parse("task<task<f64[:]> > t;");
+    ASSERT_EQ(scope.variableDeclarations[0]->typeInfo.fullName, "task<task<f64[:]>>");
+    ASSERT_EQ(scope.variableDeclarations[0]->typeInfo.elementType->kind, TypeKind::Task);
+
+    // Not followed by a type, `task` is an identifier like any other.
+    scope = Parse("int task = 1; int less = task < 2;");
+    ASSERT_NE(dynamic_cast<BinaryExpression*>(scope.variableDeclarations[1]->initExpression.get()), nullptr);
+
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("int f() { return 0; } int x = spawn f;"), (Exception { 1, 37, 37, "'spawn' requires a function call" }));
+}
+
+TEST_F(ParserTest, ParseParameterModes)
+{
+    auto scope = Parse(R"(void f(in int[] a, ref int b, move int[] c, int d) {}
+<T> T g(in T a) { return a; }
+int h(int in, int ref) { return in + ref; })");
+
+    const auto& parameters = static_cast<FunctionDefinitionStatement*>(scope.QueryFunction("f"))->headerScope.variableDeclarations;
+    ASSERT_EQ(parameters.size(), 4);
+    ASSERT_EQ(parameters[0]->parameterMode, ParameterMode::In);
+    ASSERT_EQ(parameters[0]->constness, Constness::Const);
+    ASSERT_EQ(parameters[0]->typeInfo.fullName, "int[]");
+    ASSERT_EQ(parameters[1]->parameterMode, ParameterMode::Ref);
+    ASSERT_EQ(parameters[1]->constness, Constness::None);
+    ASSERT_EQ(parameters[2]->parameterMode, ParameterMode::Move);
+    ASSERT_EQ(parameters[3]->parameterMode, ParameterMode::Value);
+
+    ASSERT_EQ(scope.QueryGenericFunction("g")->parameterTypes, std::vector<std::string> { "T" });
+
+    // Outside of a parameter type, the modes are identifiers like any other.
+    const auto& names = static_cast<FunctionDefinitionStatement*>(scope.QueryFunction("h"))->headerScope.variableDeclarations;
+    ASSERT_EQ(names[0]->name, "in");
+    ASSERT_EQ(names[1]->name, "ref");
+
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("void f(ref ref x) {}"), (Exception { 1, 12, 14, "Undefined type 'ref'" }));
+}
+
+TEST_F(ParserTest, ParseSwitchStatement)
+{
+    auto scope = Parse(R"(int x = 2;
+switch (x) {
+    case 1, -2 { x = 0; }
+    default { }
+    case 9223372036854775807 { x = 1; x = 2; }
+})");
+    ASSERT_EQ(scope.statements.size(), 2);
+    auto switchStatement = dynamic_cast<SwitchStatement*>(scope.statements[1].get());
+    ASSERT_NE(switchStatement, nullptr);
+    ASSERT_EQ(static_cast<IdentifierExpression&>(*switchStatement->conditionalExpression).fullName, "x");
+    ASSERT_EQ(switchStatement->cases.size(), 3);
+
+    const auto& first = switchStatement->cases[0];
+    ASSERT_EQ(first.values.size(), 2);
+    ASSERT_EQ(first.values[0].value, 1);
+    ASSERT_EQ(first.values[1].value, -2);
+    ASSERT_EQ(first.values[1].sourceRange.startColumn, 13);
+    ASSERT_EQ(first.values[1].sourceRange.endColumn, 14);
+    ASSERT_EQ(first.scope.statements.size(), 1);
+
+    ASSERT_TRUE(switchStatement->cases[1].values.empty());
+    ASSERT_EQ(switchStatement->cases[2].values[0].value, 9223372036854775807);
+    ASSERT_EQ(switchStatement->cases[2].scope.statements.size(), 2);
+
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("switch (1) { default {} default {} }"), (Exception { 1, 25, 31, "multiple default cases in one switch statement" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("switch (1) { x {} }"), (Exception { 1, 14, 14, "expected 'case' or 'default'" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("switch (1) { case 9223372036854775808 {} }"), (Exception { 1, 19, 37, "case value is too large" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("switch (1) { case -9223372036854775809 {} }"), (Exception { 1, 19, 38, "case value is too large" }));
+
+    auto minimum = Parse("switch (1) { case -9223372036854775808 {} }");
+    ASSERT_EQ(static_cast<SwitchStatement&>(*minimum.statements[0]).cases[0].values[0].value, std::numeric_limits<int64_t>::min());
+}
+
+TEST_F(ParserTest, ParseEmbedExpressions)
+{
+    auto directory = std::filesystem::temp_directory_path();
+    std::ofstream { directory / "scc_parser_test.bin", std::ios::binary } << "hello";
+
+    Scope scope {};
+    Lexer lexer { std::make_shared<std::istringstream>(R"(u8[5] a = embed("scc_parser_test.bin");
+u8[3] b = x"01 02 ff";)") };
+    Parser { directory }.ParseCompileUnit(scope, lexer);
+    ASSERT_EQ(scope.variableDeclarations.size(), 2);
+
+    auto embedExpression = dynamic_cast<EmbedExpression*>(scope.variableDeclarations[0]->initExpression.get());
+    ASSERT_NE(embedExpression, nullptr);
+    ASSERT_TRUE(embedExpression->IsFile());
+    ASSERT_EQ(embedExpression->file, std::filesystem::absolute(directory / "scc_parser_test.bin").lexically_normal().string());
+    ASSERT_EQ(embedExpression->size, 5);
+    ASSERT_EQ(embedExpression->sourceRange.startColumn, 11);
+    ASSERT_EQ(embedExpression->sourceRange.endColumn, 38);
+
+    auto bytesExpression = dynamic_cast<EmbedExpression*>(scope.variableDeclarations[1]->initExpression.get());
+    ASSERT_NE(bytesExpression, nullptr);
+    ASSERT_FALSE(bytesExpression->IsFile());
+    ASSERT_EQ(bytesExpression->bytes, "\x01\x02\xff");
+    ASSERT_EQ(bytesExpression->size, 3);
+
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("u8[1] a = embed(\"scc_missing.bin\");"), (Exception { 1, 17, 33, "cannot read the embedded file 'scc_missing.bin'" }));
+    ASSERT_THROW_COMPILER_EXCEPTION(Parse("u8[1] a = x\"\";"), (Exception { 1, 11, 13, "byte string is empty" }));
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "test/test.h"
+
+#include <sstream>
+
+import scc.ast;
+import scc.compiler;
+
+using namespace scc::ast;
+using namespace scc::compiler;
+
+class PurityAnalysisTest : public testing::Test {
+protected:
+    Scope Parse(std::string content)
+    {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(std::move(content)) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        return std::move(scope);
+    }
+
+    static const FunctionDefinitionStatement& GetFunction(const Scope& scope, const std::string& name)
+    {
+        return *static_cast<const FunctionDefinitionStatement*>(scope.QueryFunction(name));
+    }
+};
+
+TEST_F(PurityAnalysisTest, Purity)
+{
+    auto scope = Parse(R"(
+int square(int x) {
+    return x * x;
+}
+
+int sumOfSquares(int x, int y) {
+    return square(x) + square(y);
+}
+
+int log(int x) {
+    std::println("{}", x);
+    return x;
+}
+
+int logSquare(int x) {
+    return log(square(x));
+}
+
+int isEven(int n) {
+    if (n == 0) {
+        return 1;
+    }
+    return isOdd(n - 1);
+}
+
+int isOdd(int n) {
+    if (n == 0) {
+        return 0;
+    }
+    return isEven(n - 1);
+}
+)");
+
+    auto purityAnalysis = PurityAnalysis { scope };
+    ASSERT_EQ(purityAnalysis.GetPurity("square"), Purity::Const);
+    ASSERT_EQ(purityAnalysis.GetPurity("sumOfSquares"), Purity::Const);
+    ASSERT_EQ(purityAnalysis.GetPurity("log"), Purity::Impure);
+    ASSERT_EQ(purityAnalysis.GetPurity("logSquare"), Purity::Impure);
+    ASSERT_EQ(purityAnalysis.GetPurity("isEven"), Purity::Const);
+    ASSERT_EQ(purityAnalysis.GetPurity("isOdd"), Purity::Const);
+    ASSERT_EQ(purityAnalysis.GetPurity("undefined"), Purity::Impure);
+}
+
+TEST_F(PurityAnalysisTest, WritesThroughSlices)
+{
+    auto scope = Parse(R"(
+i64 sum(i64[:] values) {
+    i64 total = 0;
+    for (int i = 0; i < std::len(values); i += 1) {
+        total += values[i];
+    }
+    return total;
+}
+
+void fill(i64[:] values, i64 value) {
+    for (int i = 0; i < std::len(values); i += 1) {
+        values[i] = value;
+    }
+}
+
+i64 fillCopy(i64[4] values) {
+    values[0] = 1;
+    return values[0];
+}
+)");
+
+    auto purityAnalysis = PurityAnalysis { scope };
+    ASSERT_EQ(purityAnalysis.GetPurity("sum"), Purity::Pure);
+    ASSERT_EQ(purityAnalysis.GetPurity("fill"), Purity::Impure);
+    ASSERT_EQ(purityAnalysis.GetPurity("fillCopy"), Purity::Pure);
+}
+
+TEST_F(PurityAnalysisTest, SimdFunctions)
+{
+    auto scope = Parse(R"(
+f32 sum(f32[:] values) {
+    f32x8 total = 0;
+    for (i64 i = 0; i < std::len(values); i += 8) {
+        total += f32x8(values, i);
+    }
+    return std::reduce_add(total);
+}
+
+void scale(f32[:] values, f32 factor) {
+    for (i64 i = 0; i < std::len(values); i += 8) {
+        std::store(values, i, f32x8(values, i) * factor);
+    }
+}
+)");
+
+    auto purityAnalysis = PurityAnalysis { scope };
+    ASSERT_EQ(purityAnalysis.GetPurity("sum"), Purity::Pure);
+    ASSERT_EQ(purityAnalysis.GetPurity("scale"), Purity::Impure);
+}
+
+TEST_F(PurityAnalysisTest, AutomaticMemoization)
+{
+    auto scope = Parse(R"(
+int fib(int n) {
+    if (n < 2) {
+        return n;
+    }
+    return fib(n - 1) + fib(n - 2);
+}
+
+int square(int x) {
+    return x * x;
+}
+
+int countdown(int n) {
+    if (n == 0) {
+        return 0;
+    }
+    std::println("{}", n);
+    return countdown(n - 1);
+}
+)");
+
+    Memoizer { /*automatic=*/true }.MemoizeCompileUnit(scope);
+    ASSERT_TRUE(GetFunction(scope, "fib").HasAttribute("memo"));
+    ASSERT_FALSE(GetFunction(scope, "square").HasAttribute("memo"));
+    ASSERT_FALSE(GetFunction(scope, "countdown").HasAttribute("memo"));
+}
+
+TEST_F(PurityAnalysisTest, IntegralArguments)
+{
+    auto scope = Parse(R"(
+i64 add(i64 a, u32 b, i8 c, bool d) {
+    return a + b + c + d;
+}
+
+f64 half(f64 x) {
+    return x / 2;
+}
+
+i64 first(i64[:] values) {
+    return values[0];
+}
+)");
+
+    auto purityAnalysis = PurityAnalysis { scope };
+    ASSERT_EQ(purityAnalysis.GetPurity("add"), Purity::Const);
+    ASSERT_EQ(purityAnalysis.GetPurity("half"), Purity::Pure);
+    ASSERT_EQ(purityAnalysis.GetPurity("first"), Purity::Pure);
+}
+
+TEST_F(PurityAnalysisTest, CannotMemoizeImpureFunction)
+{
+    auto scope = Parse(R"(@memo
+int log(int x) {
+    std::println("{}", x);
+    return x;
+})");
+
+    ASSERT_THROW(Memoizer {}.MemoizeCompileUnit(scope), Exception);
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "test/test.h"
+
+#include <sstream>
+#include <vector>
+
+import scc.ast;
+import scc.compiler;
+
+using namespace scc::ast;
+using namespace scc::compiler;
+
+class SwitchConverterTest : public testing::Test {
+protected:
+    Scope Convert(std::string content)
+    {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(std::move(content)) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        TypeChecker {}.CheckCompileUnit(scope);
+        SwitchConverter {}.ConvertCompileUnit(scope);
+        return std::move(scope);
+    }
+
+    // Returns the values of each case, where the `default` case has none.
+    static std::vector<std::vector<int64_t>> GetCaseValues(const SwitchStatement& switchStatement)
+    {
+        auto cases = std::vector<std::vector<int64_t>> {};
+        for (const auto& switchCase : switchStatement.cases) {
+            auto& values = cases.emplace_back();
+            for (const auto& caseValue : switchCase.values) {
+                values.push_back(caseValue.value);
+            }
+        }
+        return cases;
+    }
+};
+
+TEST_F(SwitchConverterTest, ElseIfChainBecomesSwitch)
+{
+    auto scope = Convert(R"(
+int x = 3;
+if (x == 1) {
+    std::println("one");
+} else if (2 == x) {
+    std::println("two");
+} else if ((x) == -3) {
+    std::println("minus three");
+} else {
+    std::println("other");
+}
+)");
+    auto switchStatement = dynamic_cast<SwitchStatement*>(scope.statements[1].get());
+    ASSERT_NE(switchStatement, nullptr);
+    ASSERT_EQ(static_cast<IdentifierExpression&>(*switchStatement->conditionalExpression).fullName, "x");
+    ASSERT_EQ(GetCaseValues(*switchStatement), (std::vector<std::vector<int64_t>> { { 1 }, { 2 }, { -3 }, {} }));
+    ASSERT_EQ(switchStatement->cases[3].scope.statements.size(), 1);
+
+    auto output = std::make_shared<std::ostringstream>();
+    Translator { output }.VisitAstScope(scope);
+    ASSERT_EQ(output->str(), R"(// scc autogenerated file.
+
+import scc.std.print_parts;
+
+int main()
+{
+    int x { 3 };
+    switch (x)
+    {
+    case 1:
+        {
+            scc::std::print_parts("one\n");
+        }
+        break;
+    case 2:
+        {
+            scc::std::print_parts("two\n");
+        }
+        break;
+    case -3:
+        {
+            scc::std::print_parts("minus three\n");
+        }
+        break;
+    default:
+        {
+            scc::std::print_parts("other\n");
+        }
+        break;
+    }
+    return 0;
+}
+)");
+}
+
+TEST_F(SwitchConverterTest, ChainEndsAtOtherConditions)
+{
+    // The repeated value and the comparison of another variable stay in the `default` case.
+    auto scope = Convert(R"(
+int x = 3;
+int y = 4;
+void f(int x) {
+    if (x == 1) {
+    } else if (x == 2) {
+    } else if (x == 3) {
+    } else if (x == 1) {
+    }
+}
+if (x == 1) {
+} else if (x == 2) {
+} else if (x == 3) {
+} else if (y == 4) {
+}
+)");
+    const auto& body = static_cast<const FunctionDefinitionStatement*>(scope.QueryFunction("f"))->bodyScope;
+    auto switchStatement = dynamic_cast<SwitchStatement*>(body.statements[0].get());
+    ASSERT_NE(switchStatement, nullptr);
+    ASSERT_EQ(GetCaseValues(*switchStatement), (std::vector<std::vector<int64_t>> { { 1 }, { 2 }, { 3 }, {} }));
+    ASSERT_NE(dynamic_cast<ConditionalStatement*>(switchStatement->cases[3].scope.statements[0].get()), nullptr);
+
+    switchStatement = dynamic_cast<SwitchStatement*>(scope.statements[2].get());
+    ASSERT_NE(switchStatement, nullptr);
+    ASSERT_EQ(GetCaseValues(*switchStatement), (std::vector<std::vector<int64_t>> { { 1 }, { 2 }, { 3 }, {} }));
+}
+
+TEST_F(SwitchConverterTest, KeepsShortOrMixedChains)
+{
+    auto scope = Convert(R"(
+int x = 3;
+u8 small = 1;
+f64 real = 1;
+if (x == 1) {
+} else if (x == 2) {
+}
+if (x == 1) {
+} else if (x < 2) {
+} else if (x == 3) {
+}
+if (small == 1) {
+} else if (small == 2) {
+} else if (small == 256) {
+}
+if (real == 1) {
+} else if (real == 2) {
+} else if (real == 3) {
+}
+)");
+    for (size_t i = 3; i < scope.statements.size(); ++i) {
+        ASSERT_NE(dynamic_cast<ConditionalStatement*>(scope.statements[i].get()), nullptr);
+    }
+}
\ No newline at end of file
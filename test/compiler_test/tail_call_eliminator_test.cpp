@@ -0,0 +1,161 @@
+#include "test/test.h"
+
+#include <sstream>
+
+import scc.ast;
+import scc.compiler;
+
+using namespace scc::ast;
+using namespace scc::compiler;
+
+class TailCallEliminatorTest : public testing::Test {
+protected:
+    Scope Eliminate(std::string content)
+    {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(std::move(content)) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        TailCallEliminator {}.EliminateCompileUnit(scope);
+        return std::move(scope);
+    }
+
+    static const ReturnStatement* GetLastReturnStatement(const Scope& scope, const std::string& name)
+    {
+        const auto& bodyScope = static_cast<const FunctionDefinitionStatement*>(scope.QueryFunction(name))->bodyScope;
+        return dynamic_cast<const ReturnStatement*>(bodyScope.statements.back().get());
+    }
+};
+
+TEST_F(TailCallEliminatorTest, SelfTailCallBecomesLoop)
+{
+    auto scope = Eliminate(R"(
+int gcd(int a, int b) {
+    if (b == 0) {
+        return a;
+    }
+    return gcd(b, a % b);
+}
+
+std::println("{}", gcd(48, 18));
+)");
+    auto output = std::make_shared<std::ostringstream>();
+    Translator { output }.VisitAstScope(scope);
+    ASSERT_EQ(output->str(), R"(// scc autogenerated file.
+
+import scc.std.print_parts;
+
+// function declarations
+[[gnu::const]] int gcd(int a, int b);
+int main();
+
+// function definitions
+int gcd(int a, int b)
+{
+    {
+
+        for (;;)
+        {
+            if (b == 0)
+            {
+                return a;
+            }
+            int scc_a { b };
+            int scc_b { a % b };
+            a = scc_a;
+            b = scc_b;
+            continue;
+        }
+    }
+}
+
+int main()
+{
+    scc::std::print_parts(gcd(48, 18), "\n");
+    return 0;
+}
+)");
+}
+
+TEST_F(TailCallEliminatorTest, AssignWithoutTemporaries)
+{
+    auto scope = Eliminate(R"(
+int sum(int acc, int n) {
+    if (n == 0) {
+        return acc;
+    }
+    return sum(acc + n, n - 1);
+}
+)");
+    const auto& bodyScope = static_cast<const FunctionDefinitionStatement*>(scope.QueryFunction("sum"))->bodyScope;
+    ASSERT_EQ(bodyScope.statements.size(), 1);
+    const auto& loopScope = dynamic_cast<const ForLoopStatement&>(*bodyScope.statements[0]).bodyScope;
+    ASSERT_EQ(loopScope.statements.size(), 4);
+    ASSERT_TRUE(dynamic_cast<const ExpressionStatement*>(loopScope.statements[1].get()));
+    ASSERT_TRUE(dynamic_cast<const ExpressionStatement*>(loopScope.statements[2].get()));
+    ASSERT_TRUE(dynamic_cast<const ContinueStatement*>(loopScope.statements[3].get()));
+}
+
+TEST_F(TailCallEliminatorTest, MutualTailCallsMustTail)
+{
+    auto scope = Eliminate(R"(
+int isEven(int n) {
+    if (n == 0) {
+        return 1;
+    }
+    return isOdd(n - 1);
+}
+
+int isOdd(int n) {
+    if (n == 0) {
+        return 0;
+    }
+    return isEven(n - 1);
+}
+
+int count(int n) {
+    if (n == 0) {
+        return 0;
+    }
+    return 1 + count(n - 1);
+}
+)");
+    ASSERT_TRUE(GetLastReturnStatement(scope, "isEven")->mustTail);
+    ASSERT_TRUE(GetLastReturnStatement(scope, "isOdd")->mustTail);
+    ASSERT_FALSE(GetLastReturnStatement(scope, "count")->mustTail);
+}
+
+TEST_F(TailCallEliminatorTest, NoMustTailWithDestructors)
+{
+    auto scope = Eliminate(R"(
+int isEven(int n) {
+    int[] visited = [n];
+    if (n == 0) {
+        return 1;
+    }
+    return isOdd(n - 1);
+}
+
+int isOdd(int n) {
+    if (n == 0) {
+        return 0;
+    }
+    return isEven(n - 1);
+}
+)");
+    ASSERT_FALSE(GetLastReturnStatement(scope, "isEven")->mustTail);
+    ASSERT_TRUE(GetLastReturnStatement(scope, "isOdd")->mustTail);
+}
+
+TEST_F(TailCallEliminatorTest, LoopEndsWithoutReturn)
+{
+    auto scope = Eliminate(R"(
+int f(int n) {
+    if (n > 0) {
+        return f(n - 1);
+    }
+}
+)");
+    const auto& bodyScope = static_cast<const FunctionDefinitionStatement*>(scope.QueryFunction("f"))->bodyScope;
+    const auto& loopScope = dynamic_cast<const ForLoopStatement&>(*bodyScope.statements[0]).bodyScope;
+    ASSERT_TRUE(dynamic_cast<const BreakStatement*>(loopScope.statements.back().get()));
+}
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "test/test.h"
 
 #include <filesystem>
+#include <format>
 #include <sstream>
+#include <string>
+#include <vector>
 
 import scc.ast;
 import scc.compiler;
@@ -9,6 +12,18 @@ import scc.compiler;
 using namespace scc::ast;
 using namespace scc::compiler;
 
+// Keeps the text written to the stream so far at each flush.
+struct FlushRecorder final : std::stringbuf {
+    std::vector<std::string> flushes {};
+
+protected:
+    int sync() override
+    {
+        flushes.push_back(str());
+        return 0;
+    }
+};
+
 class TranslatorTest : public testing::Test {
 protected:
     static std::filesystem::path s_testFolder;
@@ -18,6 +33,8 @@ protected:
         Scope scope {};
         Lexer lexer { std::make_shared<std::istringstream>(ReadFileAsString(path)) };
         Parser {}.ParseCompileUnit(scope, lexer);
+        TypeChecker {}.CheckCompileUnit(scope);
+        BoundsCheckEliminator {}.EliminateCompileUnit(scope);
 
         auto output = std::make_shared<std::ostringstream>();
         Translator { output }.VisitAstScope(scope);
@@ -62,4 +79,174 @@ TEST_F(TranslatorTest, ForStatement)
 TEST_F(TranslatorTest, FunctionDefinition)
 {
     RunTest("function_definition");
+}
+
+TEST_F(TranslatorTest, Memo)
+{
+    RunTest("memo");
+}
+
+TEST_F(TranslatorTest, FormatString)
+{
+    RunTest("format_string");
+}
+
+TEST_F(TranslatorTest, SizedTypes)
+{
+    RunTest("sized_types");
+}
+
+TEST_F(TranslatorTest, Arrays)
+{
+    RunTest("arrays");
+}
+
+TEST_F(TranslatorTest, Structs)
+{
+    RunTest("structs");
+}
+
+TEST_F(TranslatorTest, Generics)
+{
+    RunTest("generics");
+}
+
+TEST_F(TranslatorTest, Constants)
+{
+    RunTest("constants");
+}
+
+TEST_F(TranslatorTest, ParallelFor)
+{
+    RunTest("parallel_for");
+}
+
+TEST_F(TranslatorTest, ParallelMemo)
+{
+    RunTest("parallel_memo");
+}
+
+TEST_F(TranslatorTest, Spawn)
+{
+    RunTest("spawn");
+}
+
+TEST_F(TranslatorTest, SpawnMemo)
+{
+    RunTest("spawn_memo");
+}
+
+TEST_F(TranslatorTest, ParameterModes)
+{
+    RunTest("parameter_modes");
+}
+
+TEST_F(TranslatorTest, Switch)
+{
+    RunTest("switch");
+}
+
+TEST_F(TranslatorTest, SwitchMinimum)
+{
+    RunTest("switch_min");
+}
+
+TEST_F(TranslatorTest, Embed)
+{
+    RunTest("embed");
+}
+
+TEST_F(TranslatorTest, Simd)
+{
+    RunTest("simd");
+}
+
+TEST_F(TranslatorTest, StringLiterals)
+{
+    RunTest("string_literals");
+}
+
+TEST_F(TranslatorTest, FunctionOrder)
+{
+    RunTest("function_order");
+}
+
+TEST_F(TranslatorTest, Reproducible)
+{
+    auto path = s_testFolder / "function_order.scc";
+    ASSERT_EQ(Translate(path), Translate(path));
+}
+
+// The imports and declarations are written first, then each function as it's translated.
+TEST_F(TranslatorTest, WritesAsTranslated)
+{
+    auto buffer = FlushRecorder {};
+    {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(ReadFileAsString(s_testFolder / "function_order.scc")) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        TypeChecker {}.CheckCompileUnit(scope);
+        Translator { std::make_shared<std::ostream>(&buffer), 1 }.VisitAstScope(scope);
+    }
+
+    auto expected = ReadFileAsString(s_testFolder / "function_order.expected");
+    ASSERT_EQ(buffer.flushes.size(), 5);
+    ASSERT_EQ(buffer.flushes.front(), expected.substr(0, expected.find("// function definitions")));
+    ASSERT_EQ(buffer.flushes.back(), expected);
+}
+
+TEST_F(TranslatorTest, ParallelFunctions)
+{
+    auto source = std::string { "int f0(int n) {\n    return n;\n}\n" };
+    for (auto i = 1; i < 200; ++i) {
+        source += std::format("int f{}(int n) {{\n    if (n == 0) {{\n        return {};\n    }}\n    return f{}(n - 1) + 1;\n}}\n", i, i, i - 1);
+    }
+    source += "std::println(\"{}\", f199(3));";
+
+    auto translate = [&](unsigned threadCount) {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(source) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        TypeChecker {}.CheckCompileUnit(scope);
+
+        auto output = std::make_shared<std::ostringstream>();
+        Translator { output, threadCount }.VisitAstScope(scope);
+        return output->str();
+    };
+    ASSERT_EQ(translate(8), translate(1));
+}
+
+TEST_F(TranslatorTest, SplitUnits)
+{
+    auto header = std::make_shared<std::ostringstream>();
+    auto units = std::vector<std::shared_ptr<std::ostringstream>> { std::make_shared<std::ostringstream>(), std::make_shared<std::ostringstream>() };
+    {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(ReadFileAsString(s_testFolder / "split_units.scc")) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        TypeChecker {}.CheckCompileUnit(scope);
+        BoundsCheckEliminator {}.EliminateCompileUnit(scope);
+        Translator { header }.TranslateCompileUnit(scope, "split_units.scc.h", { units.begin(), units.end() });
+    }
+
+    ASSERT_EQ(header->str(), ReadFileAsString(s_testFolder / "split_units.h.expected"));
+    for (size_t i = 0; i < units.size(); ++i) {
+        ASSERT_EQ(units[i]->str(), ReadFileAsString(s_testFolder / std::format("split_units.{}.expected", i)));
+    }
+}
+
+TEST_F(TranslatorTest, InvalidFormatString)
+{
+    Scope scope {};
+    Lexer lexer { std::make_shared<std::istringstream>("std::println(\"{} {}\", 1);") };
+    Parser {}.ParseCompileUnit(scope, lexer);
+    ASSERT_THROW(Translator { std::make_shared<std::ostringstream>() }.VisitAstScope(scope), Exception);
+}
+
+TEST_F(TranslatorTest, InvalidNestedField)
+{
+    Scope scope {};
+    Lexer lexer { std::make_shared<std::istringstream>("std::println(\"{:{}}\", 1);") };
+    Parser {}.ParseCompileUnit(scope, lexer);
+    ASSERT_THROW(Translator { std::make_shared<std::ostringstream>() }.VisitAstScope(scope), Exception);
 }
\ No newline at end of file
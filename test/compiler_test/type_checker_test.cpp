@@ -0,0 +1,420 @@
+#include "test/test.h"
+
+#include <sstream>
+
+import scc.ast;
+import scc.compiler;
+
+using namespace scc::ast;
+using namespace scc::compiler;
+
+class TypeCheckerTest : public testing::Test {
+protected:
+    Scope Check(std::string content)
+    {
+        Scope scope {};
+        Lexer lexer { std::make_shared<std::istringstream>(std::move(content)) };
+        Parser {}.ParseCompileUnit(scope, lexer);
+        TypeChecker {}.CheckCompileUnit(scope);
+        return std::move(scope);
+    }
+
+    // Returns the type of the initializer of the global variable definition at `index`.
+    static const std::string& GetInitType(const Scope& scope, size_t index)
+    {
+        const auto& statement = static_cast<const VariableDefinitionStatement&>(*scope.statements[index]);
+        return statement.variableDeclaration.initExpression->typeInfo->fullName;
+    }
+};
+
+TEST_F(TypeCheckerTest, LiteralTypes)
+{
+    auto scope = Check(R"(
+int a = 2147483647;
+i64 b = 2147483648;
+u64 c = 18446744073709551615;
+f64 d = 1.5;
+f32 e = 1.5f;
+string f = "text";
+)");
+    ASSERT_EQ(GetInitType(scope, 0), "int");
+    ASSERT_EQ(GetInitType(scope, 1), "i64");
+    ASSERT_EQ(GetInitType(scope, 2), "u64");
+    ASSERT_EQ(GetInitType(scope, 3), "f64");
+    ASSERT_EQ(GetInitType(scope, 4), "f32");
+    ASSERT_EQ(GetInitType(scope, 5), "string");
+}
+
+TEST_F(TypeCheckerTest, UsualArithmeticConversions)
+{
+    auto scope = Check(R"(
+u8 a = 1;
+i8 b = 2;
+u32 c = 3;
+i32 d = 4;
+i64 e = 5;
+u64 f = 6;
+f32 g = 7;
+f64 h = 8;
+int r0 = a + b;
+u32 r1 = c + d;
+i64 r2 = e * c;
+u64 r3 = f - e;
+f32 r4 = g / e;
+f64 r5 = g + h;
+bool r6 = a < h;
+int r7 = -a;
+)");
+    ASSERT_EQ(GetInitType(scope, 8), "int");
+    ASSERT_EQ(GetInitType(scope, 9), "u32");
+    ASSERT_EQ(GetInitType(scope, 10), "i64");
+    ASSERT_EQ(GetInitType(scope, 11), "u64");
+    ASSERT_EQ(GetInitType(scope, 12), "f32");
+    ASSERT_EQ(GetInitType(scope, 13), "f64");
+    ASSERT_EQ(GetInitType(scope, 14), "bool");
+    ASSERT_EQ(GetInitType(scope, 15), "int");
+}
+
+TEST_F(TypeCheckerTest, FunctionCallType)
+{
+    auto scope = Check(R"(
+f64 half(i64 n) {
+    return n / 2.0;
+}
+
+f64 x = half(3);
+)");
+    ASSERT_EQ(GetInitType(scope, 0), "f64");
+}
+
+TEST_F(TypeCheckerTest, InvalidOperands)
+{
+    ASSERT_THROW(Check(R"(int a = "text" + 1;)"), Exception);
+    ASSERT_THROW(Check(R"(f64 a = 1.5 % 2;)"), Exception);
+    ASSERT_THROW(Check(R"(f64 a = 1.5; a <<= 1;)"), Exception);
+    ASSERT_THROW(Check(R"(string s = 1;)"), Exception);
+}
+
+TEST_F(TypeCheckerTest, InvalidCalls)
+{
+    ASSERT_THROW(Check(R"(
+int f(int a) {
+    return a;
+}
+
+int x = f(1, 2);
+)"),
+        Exception);
+    ASSERT_THROW(Check(R"(
+int f(int a) {
+    return a;
+}
+
+int x = f("text");
+)"),
+        Exception);
+}
+
+TEST_F(TypeCheckerTest, Sequences)
+{
+    auto scope = Check(R"(
+f64[4] a = [1, 2, 3, 4.5];
+i32[] v = [1, 2];
+f64[:] s = a[1:3];
+f64 x = a[2];
+i64 n = std::len(v);
+f64[:] t = a;
+i32[2][] m;
+i32 y = m[0][1];
+)");
+    ASSERT_EQ(GetInitType(scope, 0), "f64[4]");
+    ASSERT_EQ(GetInitType(scope, 1), "i32[]");
+    ASSERT_EQ(GetInitType(scope, 2), "f64[:]");
+    ASSERT_EQ(GetInitType(scope, 3), "f64");
+    ASSERT_EQ(GetInitType(scope, 4), "i64");
+    ASSERT_EQ(GetInitType(scope, 5), "f64[4]");
+    ASSERT_EQ(GetInitType(scope, 7), "i32");
+}
+
+TEST_F(TypeCheckerTest, InvalidSequences)
+{
+    ASSERT_THROW(Check(R"(int a = 1; int b = a[0];)"), Exception);
+    ASSERT_THROW(Check(R"(int[2] a; int b = a[1.5];)"), Exception);
+    ASSERT_THROW(Check(R"(int[2] a = [1, 2, 3];)"), Exception);
+    ASSERT_THROW(Check(R"(int[2] a; std::push(a, 1);)"), Exception);
+    ASSERT_THROW(Check(R"(int[2] a; f64[:] s = a;)"), Exception);
+    ASSERT_THROW(Check(R"(
+int[2] make() {
+    return [1, 2];
+}
+
+int[:] s = make()[0:1];
+)"),
+        Exception);
+    ASSERT_THROW(Check(R"(int[] v = ["a", "b"];)"), Exception);
+}
+
+TEST_F(TypeCheckerTest, Structs)
+{
+    auto scope = Check(R"(
+struct Point {
+    f64 x;
+    i32[2] tags;
+}
+
+Point p;
+@soa Point[] points;
+f64 a = p.x;
+i32 b = p.tags[1];
+f64 c = points[0].x;
+i64 d = std::len(points);
+i32[:] e = p.tags;
+)");
+    ASSERT_EQ(GetInitType(scope, 2), "f64");
+    ASSERT_EQ(GetInitType(scope, 3), "i32");
+    ASSERT_EQ(GetInitType(scope, 4), "f64");
+    ASSERT_EQ(GetInitType(scope, 5), "i64");
+    ASSERT_EQ(GetInitType(scope, 6), "i32[2]");
+}
+
+TEST_F(TypeCheckerTest, InvalidStructs)
+{
+    ASSERT_THROW(Check(R"(struct P { int x; } P p; int a = p.y;)"), Exception);
+    ASSERT_THROW(Check(R"(int a = 1; int b = a.x;)"), Exception);
+    ASSERT_THROW(Check(R"(struct P { int x; } P p; int a = p + 1;)"), Exception);
+    ASSERT_THROW(Check(R"(struct P { int x; } @soa P[4] a; P p = a[0];)"), Exception);
+    ASSERT_THROW(Check(R"(struct P { int x; } @soa P[4] a; P[:] s = a;)"), Exception);
+    ASSERT_THROW(Check(R"(struct P { int x; } @soa P[] a; int b = std::len(a[1:]);)"), Exception);
+}
+
+TEST_F(TypeCheckerTest, UndeclaredIdentifier)
+{
+    ASSERT_THROW(Check(R"(int a = b + 1;)"), Exception);
+}
+
+TEST_F(TypeCheckerTest, GenericFunctions)
+{
+    auto scope = Check(R"(
+<T> T max(T a, T b) {
+    if (a < b) { return b; }
+    return a;
+}
+
+<T> T sum(T[:] values) {
+    T total = 0;
+    for (int i = 0; i < std::len(values); i += 1) { total += values[i]; }
+    return total;
+}
+
+f64 a = max(1.5, 2.5);
+int b = max(1, 2);
+int c = max(3, 4);
+f64[4] values = [1, 2, 3, 4];
+f64 d = sum(values);
+)");
+    ASSERT_EQ(GetInitType(scope, 0), "f64");
+    ASSERT_EQ(GetInitType(scope, 1), "int");
+    ASSERT_EQ(GetInitType(scope, 4), "f64");
+
+    // Calls with the same type arguments share the instance.
+    ASSERT_EQ(scope.GetFunctions().size(), 3);
+    ASSERT_NE(scope.QueryFunction("max<f64>"), nullptr);
+    ASSERT_NE(scope.QueryFunction("max<int>"), nullptr);
+    ASSERT_NE(scope.QueryFunction("sum<f64>"), nullptr);
+
+    const auto& call = static_cast<const FunctionCallExpression&>(*static_cast<const VariableDefinitionStatement&>(*scope.statements[2]).variableDeclaration.initExpression);
+    ASSERT_EQ(static_cast<const IdentifierExpression&>(*call.funcExpression).fullName, "max<int>");
+}
+
+TEST_F(TypeCheckerTest, InvalidGenericFunctions)
+{
+    ASSERT_THROW(Check(R"(<T> T max(T a, T b) { return a; } f64 a = max(1, 2.5);)"), Exception);
+    ASSERT_THROW(Check(R"(<T> T id(T a) { return a; } int a = id(1, 2);)"), Exception);
+    ASSERT_THROW(Check(R"(<T> T zero() { return 0; } int a = zero();)"), Exception);
+    ASSERT_THROW(Check(R"(<T> T twice(T a) { return a * 2; } string s = twice("x");)"), Exception);
+    ASSERT_THROW(Check(R"(struct P { int x; } <T> int first(T[:] values) { return 0; } @soa P[] a; int b = first(a);)"), Exception);
+    ASSERT_THROW(Check(R"(<T> int deep(T a) { T[] b; return deep(b); } int a = deep(1);)"), Exception);
+}
+
+TEST_F(TypeCheckerTest, Constants)
+{
+    auto scope = Check(R"(
+constexpr int square(int n) { return n * n; }
+consteval int cube(int n) { return n * n * n; }
+constexpr int[4] table = [square(1), square(2), cube(3), 4];
+constexpr int last = table[3] + std::len(table);
+int lookup(int i) { return table[i]; }
+const int[2] pair = [1, 2];
+int a = pair[0] + lookup(1);
+)");
+    ASSERT_EQ(GetInitType(scope, 0), "int[4]");
+    ASSERT_EQ(GetInitType(scope, 1), "i64");
+    ASSERT_EQ(GetInitType(scope, 3), "int");
+
+    ASSERT_NO_THROW(Check(R"(consteval int f() { return 1; } consteval int g() { return f(); } constexpr int a = g();)"));
+    ASSERT_NO_THROW(Check(R"(constexpr int sum(int[:] values) { int s = 0; for (int i = 0; i < std::len(values); i += 1) { s += values[i]; } return s; })"));
+}
+
+TEST_F(TypeCheckerTest, InvalidConstants)
+{
+    ASSERT_THROW(Check(R"(const int a = 1; a = 2;)"), Exception);
+    ASSERT_THROW(Check(R"(const int[2] a = [1, 2]; a[0] += 3;)"), Exception);
+    ASSERT_THROW(Check(R"(const int[] v = [1]; std::push(v, 2);)"), Exception);
+    ASSERT_THROW(Check(R"(const int[2] a = [1, 2]; int[:] s = a[0:];)"), Exception);
+    ASSERT_THROW(Check(R"(int sum(int[:] s) { return 0; } const int[2] a = [1, 2]; int b = sum(a);)"), Exception);
+    ASSERT_THROW(Check(R"(int n = 1; constexpr int a = n;)"), Exception);
+    ASSERT_THROW(Check(R"(int f(int n) { return n; } constexpr int a = f(1);)"), Exception);
+    ASSERT_THROW(Check(R"(constexpr int[] v = [1];)"), Exception);
+    ASSERT_THROW(Check(R"(constexpr int f(int n) { std::println("{}", n); return n; })"), Exception);
+    ASSERT_THROW(Check(R"(constexpr int f(int n) { int[] v; return n; })"), Exception);
+    ASSERT_THROW(Check(R"(constexpr int k = 1; constexpr int f() { return k; })"), Exception);
+    ASSERT_THROW(Check(R"(consteval int f() { return 1; } int a = f();)"), Exception);
+}
+
+TEST_F(TypeCheckerTest, ParallelForLoops)
+{
+    auto scope = Check(R"(
+i64 total = 0;
+f64 lowest = 1000;
+f64[8] squares;
+parallel for (int i = 0; i < 8; i += 1) sum(total) min(lowest) {
+    f64 x = i * 0.5;
+    squares[i] = x * x;
+    total += i;
+    if (x < lowest) {
+        lowest = x;
+    }
+}
+)");
+    const auto& forStatement = static_cast<const ForLoopStatement&>(*scope.statements[3]);
+    ASSERT_EQ(forStatement.reductions[0].variableDeclaration, scope.variableDeclarations[0].get());
+    ASSERT_EQ(forStatement.reductions[1].variableDeclaration, scope.variableDeclarations[1].get());
+
+    ASSERT_NO_THROW(Check(R"(void f(f64[:] values) { parallel for (int i = 0; i < std::len(values); i += 1) { values[i] *= 2; } })"));
+    ASSERT_NO_THROW(Check(R"(int total = 0; parallel for (int i = 0; i < 4; i += 1) sum(total) { parallel for (int j = 0; j < 4; j += 1) sum(total) { total += j; } })"));
+}
+
+TEST_F(TypeCheckerTest, InvalidParallelForLoops)
+{
+    ASSERT_THROW(Check(R"(int count = 0; parallel for (int i = 0; i < 4; i += 1) { count += 1; })"), Exception);
+    ASSERT_THROW(Check(R"(int[4] a; parallel for (int i = 0; i < 4; i += 1) { a[0] = i; })"), Exception);
+    ASSERT_THROW(Check(R"(int[] v; parallel for (int i = 0; i < 4; i += 1) { std::push(v, i); })"), Exception);
+    ASSERT_THROW(Check(R"(parallel for (int i = 0; i < 4; i += 1) { i += 1; })"), Exception);
+    ASSERT_THROW(Check(R"(int f() { parallel for (int i = 0; i < 4; i += 1) { return i; } return 0; })"), Exception);
+    ASSERT_THROW(Check(R"(parallel for (int i = 0; i < 4; i += 1) sum(total) {})"), Exception);
+    ASSERT_THROW(Check(R"(string s = ""; parallel for (int i = 0; i < 4; i += 1) max(s) {})"), Exception);
+    ASSERT_THROW(Check(R"(int t = 0; parallel for (int i = 0; i < 4; i += 1) sum(t) max(t) {})"), Exception);
+    ASSERT_THROW(Check(R"(int t = 0; parallel for (int i = 0; i < 4; i += 1) { parallel for (int j = 0; j < 4; j += 1) sum(t) {} })"), Exception);
+}
+
+TEST_F(TypeCheckerTest, SpawnAndAwait)
+{
+    auto scope = Check(R"(
+int fib(int n) { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); }
+task<int> t = spawn fib(20);
+int r = await t;
+task<void> done = spawn std::println("{}", r);
+await done;
+)");
+    ASSERT_EQ(scope.variableDeclarations[0]->initExpression->typeInfo, &scope.variableDeclarations[0]->typeInfo);
+    ASSERT_EQ(scope.variableDeclarations[1]->initExpression->typeInfo->fullName, "int");
+    ASSERT_EQ(scope.variableDeclarations[2]->initExpression->typeInfo->fullName, "task<void>");
+
+    ASSERT_THROW(Check(R"(int r = await 1;)"), Exception);
+    ASSERT_THROW(Check(R"(int f() { return 1; } task<f64> t = spawn f();)"), Exception);
+    ASSERT_THROW(Check(R"(int f() { return 1; } task<int> t = spawn f(); string s = await t;)"), Exception);
+    ASSERT_THROW(Check(R"(int f() { return 1; } constexpr int g() { return await spawn f(); })"), Exception);
+    ASSERT_THROW(Check(R"(int f() { return 1; } constexpr task<int> t = spawn f();)"), Exception);
+}
+
+TEST_F(TypeCheckerTest, ParameterModes)
+{
+    auto scope = Check(R"(
+void swap(ref int a, ref int b) { int t = a; a = b; b = t; }
+int sum(in int[] v) { int s = 0; for (int i = 0; i < std::len(v); i += 1) { s += v[i]; } return s; }
+int[] take(move int[] v) { return v; }
+int[2] a = [1, 2];
+swap(a[0], a[1]);
+int[] v = [1, 2, 3];
+int s = sum(v);
+int[] w = take(v);
+)");
+    const auto& call = static_cast<const FunctionCallExpression&>(*static_cast<const ExpressionStatement&>(*scope.statements[1]).expression);
+    ASSERT_EQ(call.function, static_cast<const FunctionDefinitionStatement*>(scope.QueryFunction("swap")));
+
+    ASSERT_THROW(Check(R"(void inc(ref int n) { n += 1; } inc(1);)"), Exception);
+    ASSERT_THROW(Check(R"(void inc(ref int n) { n += 1; } long n = 1; inc(n);)"), Exception);
+    ASSERT_THROW(Check(R"(void inc(ref int n) { n += 1; } const int n = 1; inc(n);)"), Exception);
+    ASSERT_THROW(Check(R"(void inc(ref int n) { n += 1; } void f(in int n) { inc(n); })"), Exception);
+    ASSERT_THROW(Check(R"(void f(in int[] v) { v[0] = 1; })"), Exception);
+    ASSERT_THROW(Check(R"(void inc(ref int n) { n += 1; } int n = 0; parallel for (int i = 0; i < 4; i += 1) { inc(n); })"), Exception);
+    ASSERT_THROW(Check(R"(constexpr int f(ref int n) { return n; })"), Exception);
+}
+
+TEST_F(TypeCheckerTest, SwitchStatement)
+{
+    auto scope = Check(R"(
+u8 x = 2;
+switch (x) {
+    case 0, 255 { int y = 1; }
+    default { int y = 2; }
+}
+)");
+    auto& switchStatement = static_cast<SwitchStatement&>(*scope.statements[1]);
+    ASSERT_EQ(switchStatement.conditionalExpression->typeInfo->fullName, "u8");
+
+    ASSERT_THROW(Check(R"(f64 x = 1; switch (x) { case 1 {} })"), Exception);
+    ASSERT_THROW(Check(R"(u8 x = 1; switch (x) { case 256 {} })"), Exception);
+    ASSERT_THROW(Check(R"(u64 x = 1; switch (x) { case -1 {} })"), Exception);
+    ASSERT_THROW(Check(R"(int x = 1; switch (x) { case 1 {} case 2, 1 {} })"), Exception);
+    ASSERT_THROW(Check(R"(int x = 1; switch (x) { case 1 { y = 1; } })"), Exception);
+}
+
+TEST_F(TypeCheckerTest, EmbedExpression)
+{
+    auto scope = Check(R"(
+const u8[3] table = x"01 02 ff";
+u8 last = table[2];
+i64 length = std::len(x"00 00");
+)");
+    ASSERT_EQ(scope.variableDeclarations[0]->initExpression->typeInfo->fullName, "u8[3]");
+    ASSERT_EQ(scope.variableDeclarations[2]->initExpression->typeInfo->fullName, "i64");
+
+    ASSERT_THROW(Check(R"(u8[2] table = x"01 02 03";)"), Exception);
+    ASSERT_THROW(Check(R"(i32[3] table = x"01 02 03";)"), Exception);
+    ASSERT_THROW(Check(R"(consteval i64 f() { return std::len(x"01"); })"), Exception);
+}
+
+TEST_F(TypeCheckerTest, SimdTypes)
+{
+    auto scope = Check(R"(
+f32[16] values;
+f32x8 a = f32x8(values, 0);
+f32x8 b = a * 2.0f + 1;
+mask32x8 m = b > a;
+f32x8 c = std::select(m, b, 0);
+f32 sum = std::reduce_add(c);
+i64 n = std::count(m);
+std::store(values, 8, -c);
+i32x4 k = 7;
+k %= 3;
+)");
+    ASSERT_EQ(GetInitType(scope, 1), "f32x8");
+    ASSERT_EQ(GetInitType(scope, 2), "f32x8");
+    ASSERT_EQ(GetInitType(scope, 3), "mask32x8");
+    ASSERT_EQ(GetInitType(scope, 4), "f32x8");
+    ASSERT_EQ(GetInitType(scope, 5), "f32");
+    ASSERT_EQ(GetInitType(scope, 6), "i64");
+
+    ASSERT_THROW(Check(R"(f32x8 a = 1; f64x4 b = a;)"), Exception);
+    ASSERT_THROW(Check(R"(f32x8 a = 1; f32x4 b = a + f32x4(1);)"), Exception);
+    ASSERT_THROW(Check(R"(f32x8 a = 1; f32x8 b = a % 2;)"), Exception);
+    ASSERT_THROW(Check(R"(f32 x = 1; x += f32x8(1);)"), Exception);
+    ASSERT_THROW(Check(R"(f64[8] values; f32x8 a = f32x8(values, 0);)"), Exception);
+    ASSERT_THROW(Check(R"(i32[8] values; i32x8 a = i32x8(values, 0.5);)"), Exception);
+    ASSERT_THROW(Check(R"(const i32[8] values = [1, 2, 3, 4, 5, 6, 7, 8]; std::store(values, 0, i32x8(1));)"), Exception);
+    ASSERT_THROW(Check(R"(i64x4 a = 1; i64x4 b = std::select(a > 0, f32x4(1), 0);)"), Exception);
+    ASSERT_THROW(Check(R"(i32x4 a = 1; bool b = std::any(a);)"), Exception);
+    ASSERT_THROW(Check(R"(constexpr i32x4 a = 1;)"), Exception);
+    ASSERT_THROW(Check(R"(constexpr int f(i32x4 a) { return 1; })"), Exception);
+}
\ No newline at end of file